@@ -0,0 +1,145 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "owl/utils/stop_watch.hpp"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+namespace bench
+{
+  namespace
+  {
+    void write_json_string(std::ostream& out, const std::string& text)
+    {
+      out << '"';
+      for(char c : text)
+      {
+        if(c == '"' || c == '\\')
+          out << '\\';
+        out << c;
+      }
+      out << '"';
+    }
+  }
+
+  double result::throughput() const
+  {
+    return min_time > 0 ? items / min_time : 0;
+  }
+
+  std::size_t peak_memory()
+  {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+      return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+      return 0;
+#if defined(__APPLE__)
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+  }
+
+  suite::suite(std::size_t repetitions, std::string filter, bool quick)
+    : repetitions_(std::max<std::size_t>(repetitions, 1))
+    , filter_(std::move(filter))
+    , quick_(quick)
+  {
+  }
+
+  bool suite::quick() const
+  {
+    return quick_;
+  }
+
+  bool suite::enabled(const std::string& name, const std::string& input) const
+  {
+    return filter_.empty() || name.find(filter_) != std::string::npos || input.find(filter_) != std::string::npos;
+  }
+
+  void suite::run(const std::string& name, const std::string& input, std::size_t items, const std::string& unit,
+    const std::function<void()>& setup, const std::function<void()>& fn)
+  {
+    if(!enabled(name, input))
+      return;
+
+    std::vector<double> times;
+    owl::utils::stop_watch watch;
+    for(std::size_t i = 0; i < repetitions_; ++i)
+    {
+      if(setup)
+        setup();
+      watch.restart();
+      fn();
+      watch.stop();
+      times.push_back(watch.elapsed_time());
+    }
+    std::sort(times.begin(), times.end());
+
+    result r{name, input, items, unit, repetitions_, times.front(), times[times.size() / 2], peak_memory()};
+    std::cout << std::left << std::setw(28) << name << std::setw(24) << input
+      << std::right << std::setw(12) << std::setprecision(4) << r.min_time * 1000 << " ms"
+      << std::setw(14) << std::setprecision(4) << r.throughput() << ' ' << unit << "/s"
+      << std::setw(10) << r.peak_memory / (1 << 20) << " MiB" << std::endl;
+    results_.push_back(r);
+  }
+
+  void suite::run(const std::string& name, const std::string& input, std::size_t items, const std::string& unit,
+    const std::function<void()>& fn)
+  {
+    run(name, input, items, unit, nullptr, fn);
+  }
+
+  const std::vector<result>& suite::results() const
+  {
+    return results_;
+  }
+
+  void suite::write_json(std::ostream& out) const
+  {
+    out << "{\n  \"version\": ";
+    write_json_string(out, OWL_VERSION);
+    out << ",\n  \"threads\": " << std::thread::hardware_concurrency();
+    out << ",\n  \"repetitions\": " << repetitions_;
+    out << ",\n  \"results\": [";
+    out << std::setprecision(9);
+    for(std::size_t i = 0; i < results_.size(); ++i)
+    {
+      const auto& r = results_[i];
+      out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+      write_json_string(out, r.name);
+      out << ", \"input\": ";
+      write_json_string(out, r.input);
+      out << ", \"items\": " << r.items << ", \"unit\": ";
+      write_json_string(out, r.unit);
+      out << ", \"min_seconds\": " << r.min_time << ", \"median_seconds\": " << r.median_time
+        << ", \"per_second\": " << r.throughput() << ", \"peak_memory_bytes\": " << r.peak_memory << "}";
+    }
+    out << "\n  ]\n}\n";
+  }
+}
@@ -0,0 +1,85 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+  //timings of one operation on one input
+  struct result
+  {
+    std::string name;
+    std::string input;
+    //number of items processed per run and their unit, e.g. faces
+    std::size_t items;
+    std::string unit;
+    std::size_t repetitions;
+    double min_time;
+    double median_time;
+    //peak resident memory of the process in bytes after the runs
+    std::size_t peak_memory;
+
+    double throughput() const;
+  };
+
+  //keeps the optimizer from removing the computation of value, the compiler has to assume that value and
+  //all memory reachable from it are read here
+  template <typename T>
+  inline void do_not_optimize(const T& value)
+  {
+#ifdef _MSC_VER
+    *static_cast<const volatile char*>(static_cast<const void*>(&value));
+#else
+    asm volatile("" : : "r"(&value) : "memory");
+#endif
+  }
+
+  //returns the peak resident memory of the process in bytes or 0 if it is unknown
+  std::size_t peak_memory();
+
+  //runs the benchmarks whose name or input contains the filter and collects their results
+  class suite
+  {
+  public:
+    suite(std::size_t repetitions = 5, std::string filter = "", bool quick = false);
+
+    //if set only the smallest input of each benchmark should be used
+    bool quick() const;
+
+    bool enabled(const std::string& name, const std::string& input) const;
+
+    //times fn for each repetition, setup is called before each run and is not timed
+    void run(const std::string& name, const std::string& input, std::size_t items, const std::string& unit,
+      const std::function<void()>& setup, const std::function<void()>& fn);
+
+    void run(const std::string& name, const std::string& input, std::size_t items, const std::string& unit,
+      const std::function<void()>& fn);
+
+    const std::vector<result>& results() const;
+
+    void write_json(std::ostream& out) const;
+
+  private:
+    std::size_t repetitions_;
+    std::string filter_;
+    bool quick_;
+    std::vector<result> results_;
+  };
+
+  void run_mesh_benchmarks(suite& s);
+
+  void run_io_benchmarks(suite& s);
+
+  void run_matrix_benchmarks(suite& s);
+}
@@ -0,0 +1,114 @@
+#include "benchmark.hpp"
+#include "mesh_inputs.hpp"
+
+#include <cstdio>
+
+#include "owl/math/mesh_compression.hpp"
+#include "owl/math/mesh_io.hpp"
+#include "owl/math/mesh_triangulation.hpp"
+
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+namespace bench
+{
+  namespace
+  {
+    //owl has no obj writer, the positions, halfedge texcoords and face corners are written as v, vt and f lines
+    void write_obj(const owl::math::mesh<float>& m, const std::string& path)
+    {
+      owl::io::buffered_writer out(path);
+      for(auto v : m.vertices())
+      {
+        out.write("v");
+        for(auto c : m.position(v))
+        {
+          out.put(' ');
+          out.write_ascii(c);
+        }
+        out.put('\n');
+      }
+      std::size_t num_texcoords = 0;
+      for(auto f : m.faces())
+      {
+        for(auto he : m.inner_halfedges(f))
+        {
+          out.write("vt ");
+          out.write_ascii(m.texcoord(he)[0]);
+          out.put(' ');
+          out.write_ascii(m.texcoord(he)[1]);
+          out.put('\n');
+        }
+        out.put('f');
+        for(auto he : m.inner_halfedges(f))
+        {
+          out.put(' ');
+          out.write_ascii(m.target(he).index() + 1);
+          out.put('/');
+          out.write_ascii(++num_texcoords);
+        }
+        out.put('\n');
+      }
+    }
+  }
+
+  void run_io_benchmarks(suite& s)
+  {
+    owl::math::mesh_write_options ascii;
+    ascii.binary = false;
+    owl::math::mesh_write_options binary;
+
+    for(const auto& in : mesh_inputs(s.quick()))
+    {
+      auto m = in.create();
+      std::size_t n = m.num_faces();
+      for(auto [format, path, options] : {std::make_tuple("ply_binary", "owl_bench.ply", binary),
+        std::make_tuple("ply_ascii", "owl_bench_ascii.ply", ascii), std::make_tuple("off", "owl_bench.off", ascii),
+        std::make_tuple("stl_binary", "owl_bench.stl", binary), std::make_tuple("stl_ascii", "owl_bench_ascii.stl", ascii),
+        std::make_tuple("owlm", "owl_bench.owlm", binary)})
+      {
+        s.run(std::string("write_") + format, in.name, n, "faces", [&, path = path, options = options]
+          {
+            owl::math::write(m, path, options);
+          });
+        s.run(std::string("read_") + format, in.name, n, "faces", [&, path = path]
+          {
+            owl::math::mesh<float> result;
+            owl::math::read(result, path);
+            do_not_optimize(result);
+          });
+        std::remove(path);
+      }
+
+      write_obj(m, "owl_bench.obj");
+      s.run("read_obj", in.name, n, "faces", [&]
+        {
+          owl::math::mesh<float> result;
+          owl::math::read(result, "owl_bench.obj");
+          do_not_optimize(result);
+        });
+      std::remove("owl_bench.obj");
+
+      //the codec needs triangles, decoding is timed in faces of the decoded mesh
+      owl::math::triangulate_monoton(m);
+      std::vector<std::uint8_t> bytes;
+      s.run("compress", in.name, m.num_faces(), "faces", [&]
+        {
+          owl::math::compress(m, bytes);
+        });
+      owl::math::compress(m, bytes);
+      s.run("decompress", in.name, m.num_faces(), "faces", [&]
+        {
+          owl::math::mesh<float> result;
+          owl::math::decompress(result, bytes.data(), bytes.size());
+          do_not_optimize(result);
+        });
+    }
+  }
+}
@@ -0,0 +1,80 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright (c) 2018 Sören König. All rights reserved.
+//
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "benchmark.hpp"
+
+#include "owl/utils/profiler.hpp"
+
+namespace
+{
+  void print_usage()
+  {
+    std::cout << "usage: owl_bench [--json <file>] [--trace <file>] [--filter <text>] [--repetitions <n>] [--quick]\n"
+      << "  --json         writes the results as json to file\n"
+      << "  --trace        writes the profiled zones as chrome trace to file, needs OWL_ENABLE_PROFILER\n"
+      << "  --filter       runs only benchmarks whose name or input contains text\n"
+      << "  --repetitions  number of timed runs of each benchmark, default 5\n"
+      << "  --quick        uses only the smallest input of each benchmark" << std::endl;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  std::string json_path;
+  std::string trace_path;
+  std::string filter;
+  std::size_t repetitions = 5;
+  bool quick = false;
+  for(int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if(arg == "--json" && i + 1 < argc)
+      json_path = argv[++i];
+    else if(arg == "--trace" && i + 1 < argc)
+      trace_path = argv[++i];
+    else if(arg == "--filter" && i + 1 < argc)
+      filter = argv[++i];
+    else if(arg == "--repetitions" && i + 1 < argc)
+      repetitions = std::strtoul(argv[++i], nullptr, 10);
+    else if(arg == "--quick")
+      quick = true;
+    else
+    {
+      print_usage();
+      return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  bench::suite s(repetitions, filter, quick);
+  bench::run_mesh_benchmarks(s);
+  bench::run_io_benchmarks(s);
+  bench::run_matrix_benchmarks(s);
+
+  if(!json_path.empty())
+  {
+    std::ofstream out(json_path);
+    s.write_json(out);
+    if(!out)
+    {
+      std::cerr << "could not write " << json_path << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  if(!trace_path.empty() && !owl::utils::profiler::instance().write_chrome_trace(trace_path))
+  {
+    std::cerr << "could not write " << trace_path << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+#include "benchmark.hpp"
+
+#include <random>
+
+#include "owl/math/matrix.hpp"
+
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+namespace bench
+{
+  void run_matrix_benchmarks(suite& s)
+  {
+    using namespace owl::math;
+    std::size_t n = s.quick() ? 1 << 16 : 1 << 20;
+    std::string input = std::to_string(n);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-1, 1);
+    std::vector<vector3f> vectors(n);
+    std::vector<vector4f> points(n);
+    std::vector<matrix44f> matrices(n);
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      vectors[i] = vector3f(dist(rng), dist(rng), dist(rng));
+      points[i] = vector4f(dist(rng), dist(rng), dist(rng), 1);
+      for(auto& x : matrices[i])
+        x = dist(rng);
+      matrices[i](3, 3) += 4;
+    }
+    std::vector<vector3f> vectors_out(n);
+    std::vector<vector4f> points_out(n);
+    std::vector<matrix44f> matrices_out(n);
+
+    s.run("matrix_dot", input, n, "vectors", [&]
+      {
+        float sum = 0;
+        for(std::size_t i = 0; i + 1 < n; ++i)
+          sum += dot(vectors[i], vectors[i + 1]);
+        do_not_optimize(sum);
+      });
+
+    s.run("matrix_cross", input, n, "vectors", [&]
+      {
+        for(std::size_t i = 0; i + 1 < n; ++i)
+          vectors_out[i] = cross(vectors[i], vectors[i + 1]);
+        do_not_optimize(vectors_out);
+      });
+
+    s.run("matrix_normalize", input, n, "vectors", [&]
+      {
+        for(std::size_t i = 0; i < n; ++i)
+          vectors_out[i] = normalize(vectors[i]);
+        do_not_optimize(vectors_out);
+      });
+
+    s.run("matrix_transform", input, n, "vectors", [&]
+      {
+        const auto& m = matrices.front();
+        for(std::size_t i = 0; i < n; ++i)
+          points_out[i] = m * points[i];
+        do_not_optimize(points_out);
+      });
+
+    s.run("matrix_multiply", input, n, "matrices", [&]
+      {
+        for(std::size_t i = 0; i + 1 < n; ++i)
+          matrices_out[i] = matrices[i] * matrices[i + 1];
+        do_not_optimize(matrices_out);
+      });
+
+    s.run("matrix_invert", input, n, "matrices", [&]
+      {
+        for(std::size_t i = 0; i < n; ++i)
+          matrices_out[i] = invert(matrices[i]);
+        do_not_optimize(matrices_out);
+      });
+  }
+}
@@ -0,0 +1,210 @@
+#include "benchmark.hpp"
+#include "mesh_inputs.hpp"
+
+#include <cmath>
+#include <random>
+
+#include "owl/math/bvh.hpp"
+#include "owl/math/constants.hpp"
+#include "owl/math/mesh_decimation.hpp"
+#include "owl/math/mesh_reordering.hpp"
+#include "owl/math/mesh_triangulation.hpp"
+#include "owl/math/mesh_welding.hpp"
+
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+namespace bench
+{
+  namespace
+  {
+    //random element order as left behind by a file without any locality
+    void shuffle(owl::math::mesh<float>& m)
+    {
+      std::mt19937 rng(42);
+      std::vector<owl::math::vertex_handle> vertices(m.vertices().begin(), m.vertices().end());
+      std::vector<owl::math::edge_handle> edges(m.edges().begin(), m.edges().end());
+      std::vector<owl::math::face_handle> faces(m.faces().begin(), m.faces().end());
+      std::shuffle(vertices.begin(), vertices.end(), rng);
+      std::shuffle(edges.begin(), edges.end(), rng);
+      std::shuffle(faces.begin(), faces.end(), rng);
+      m.permute(vertices, edges, faces);
+    }
+
+    //rays from a camera in front of the mesh through a res x res image plane covering its bounds
+    std::vector<owl::math::ray3f> camera_rays(const owl::math::mesh<float>& m, std::size_t res)
+    {
+      auto bounds = m.bounds();
+      auto center = bounds.center();
+      auto extents = bounds.extents();
+      float size = std::max(extents[0], extents[1]);
+      owl::math::vector<float,3> eye(center[0], center[1], bounds.lower_bound[2] - 2 * size);
+      std::vector<owl::math::ray3f> rays;
+      rays.reserve(res * res);
+      for(std::size_t y = 0; y < res; ++y)
+        for(std::size_t x = 0; x < res; ++x)
+        {
+          owl::math::vector<float,3> target(center[0] + ((x + 0.5f) / res - 0.5f) * size,
+            center[1] + ((y + 0.5f) / res - 0.5f) * size, center[2]);
+          rays.emplace_back(eye, target - eye);
+        }
+      return rays;
+    }
+
+    //one step of uniform laplacian smoothing, gathers the neighbors of each vertex through the circulator
+    void smooth(owl::math::mesh<float>& m, std::vector<owl::math::vector<float,3>>& smoothed)
+    {
+      smoothed.resize(m.num_vertices());
+      for(auto v : m.vertices())
+      {
+        auto sum = owl::math::vector<float,3>::zero();
+        float n = 0;
+        for(auto w : m.vertices(v))
+        {
+          sum += m.position(w);
+          n += 1;
+        }
+        smoothed[v.index()] = n > 0 ? sum / n : m.position(v);
+      }
+      for(auto v : m.vertices())
+        m.position(v) = smoothed[v.index()];
+    }
+  }
+
+  void run_mesh_benchmarks(suite& s)
+  {
+    using mesh = owl::math::mesh<float>;
+    for(const auto& in : mesh_inputs(s.quick()))
+    {
+      mesh m = in.create();
+      std::size_t n = m.num_faces();
+      s.run("create", in.name, n, "faces", [&]{ do_not_optimize(in.create()); });
+
+      std::vector<owl::math::vector<float,3>> positions;
+      for(auto v : m.vertices())
+        positions.push_back(m.position(v));
+      std::vector<std::size_t> face_offsets(1, 0);
+      std::vector<std::size_t> face_indices;
+      for(auto f : m.faces())
+      {
+        for(auto v : m.vertices(f))
+          face_indices.push_back(v.index());
+        face_offsets.push_back(face_indices.size());
+      }
+
+      s.run("add_face", in.name, n, "faces", [&]
+        {
+          mesh result;
+          auto verts = result.add_vertices(positions);
+          std::vector<owl::math::vertex_handle> face;
+          for(std::size_t f = 0; f + 1 < face_offsets.size(); ++f)
+          {
+            face.clear();
+            for(std::size_t i = face_offsets[f]; i < face_offsets[f + 1]; ++i)
+              face.push_back(verts[face_indices[i]]);
+            result.add_face(face);
+          }
+          do_not_optimize(result);
+        });
+
+      s.run("build", in.name, n, "faces", [&]
+        {
+          mesh result;
+          result.build(positions, face_offsets, face_indices);
+          do_not_optimize(result);
+        });
+
+      //the same faces as soup with separate corners
+      std::vector<owl::math::vector<float,3>> soup;
+      for(auto i : face_indices)
+        soup.push_back(positions[i]);
+      std::vector<std::size_t> remap;
+      s.run("weld_vertices", in.name, soup.size(), "vertices", [&]{ owl::math::weld_vertices(soup, 1e-6f, remap); });
+
+      s.run("update_normals", in.name, n, "faces", [&]{ m.update_normals(); });
+
+      mesh copy;
+      if(!m.is_triangle_mesh())
+        s.run("triangulate_monoton", in.name, n, "faces", [&]{ copy = m; }, [&]{ owl::math::triangulate_monoton(copy); });
+
+      mesh triangles = m;
+      owl::math::triangulate_monoton(triangles);
+      s.run("subdivide_triangle_split", in.name, triangles.num_faces(), "faces", [&]{ copy = triangles; },
+        [&]{ copy.subdivide_triangle_split(); });
+      s.run("subdivide_loop", in.name, triangles.num_faces(), "faces", [&]{ copy = triangles; },
+        [&]{ copy.subdivide_loop(); });
+      s.run("subdivide_catmull_clark", in.name, n, "faces", [&]{ copy = m; }, [&]{ copy.subdivide_catmull_clark(); });
+      s.run("num_shells", in.name, n, "faces", [&]{ do_not_optimize(owl::math::num_shells(m)); });
+      s.run("split_shells", in.name, n, "faces", [&]{ do_not_optimize(owl::math::split_shells(m)); });
+      s.run("decimate", in.name, triangles.num_faces(), "faces", [&]{ copy = triangles; },
+        [&]{ owl::math::decimate(copy, triangles.num_faces() / 40); });
+
+      //normals and smoothing before and after restoring locality of a shuffled mesh
+      mesh shuffled = m;
+      shuffle(shuffled);
+      std::vector<owl::math::vector<float,3>> smoothed;
+      for(auto [name, ordering] : {std::make_pair("morton", owl::math::vertex_ordering::morton),
+        std::make_pair("hilbert", owl::math::vertex_ordering::hilbert),
+        std::make_pair("rcm", owl::math::vertex_ordering::reverse_cuthill_mckee)})
+      {
+        s.run(std::string("reorder_") + name, in.name, n, "faces", [&]{ copy = shuffled; },
+          [&, ordering = ordering]{ owl::math::reorder(copy, ordering); });
+      }
+      mesh reordered = shuffled;
+      owl::math::reorder(reordered);
+      for(auto [name, variant] : {std::make_pair("shuffled", &shuffled), std::make_pair("hilbert", &reordered)})
+      {
+        s.run(std::string("update_normals_") + name, in.name, n, "faces", [&, variant = variant]
+          {
+            variant->update_normals();
+          });
+        s.run(std::string("smooth_") + name, in.name, variant->num_vertices(), "vertices", [&, variant = variant]
+          {
+            smooth(*variant, smoothed);
+          });
+      }
+
+      //camera rays through an image plane in front of the mesh
+      std::vector<owl::math::ray3f> rays = camera_rays(m, s.quick() ? 128 : 512);
+      for(auto [name, builder] : {std::make_pair("bvh_sah", owl::math::bvh_builder::sah),
+        std::make_pair("bvh_lbvh", owl::math::bvh_builder::lbvh),
+        std::make_pair("bvh_lbvh_sah", owl::math::bvh_builder::lbvh_sah)})
+      {
+        s.run(name, in.name, n, "faces", [&, builder = builder]{ do_not_optimize(owl::math::bvh<float>(m, 8, builder)); });
+        owl::math::bvh<float> tree(m, 8, builder);
+        s.run(std::string(name) + "_rays", in.name, rays.size(), "rays", [&]
+          {
+            std::size_t num_hits = 0;
+            for(const auto& r : rays)
+              num_hits += tree.intersect(r).is_valid();
+            do_not_optimize(num_hits);
+          });
+        s.run(std::string(name) + "_packets", in.name, rays.size(), "rays", [&]{ do_not_optimize(tree.intersect(rays)); });
+      }
+    }
+
+    //triangulating a single large polygon walks its long face loop backwards, which is linear per step
+    //without stored prev pointers
+    std::size_t n = s.quick() ? 1000 : 4000;
+    mesh polygon;
+    std::vector<owl::math::vertex_handle> corners;
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      float angle = i * owl::math::constants::two_pi<float> / n;
+      corners.push_back(polygon.add_vertex(owl::math::vector<float,3>(std::cos(angle), 0,
+        std::sin(angle) * (1 + 0.3f * (i % 2)))));
+    }
+    polygon.add_face(corners);
+    mesh copy;
+    for(bool stored : {false, true})
+      s.run(stored ? "triangulate_polygon_prev" : "triangulate_polygon", std::to_string(n) + "-gon", n, "corners",
+        [&, stored = stored]{ copy = polygon; copy.store_prev(stored); },
+        [&]{ owl::math::triangulate_monoton(copy); });
+  }
+}
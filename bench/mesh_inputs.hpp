@@ -0,0 +1,54 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "owl/math/mesh.hpp"
+#include "owl/math/mesh_primitives.hpp"
+
+namespace bench
+{
+  //generated mesh which is used as input of the benchmarks
+  struct mesh_input
+  {
+    std::string name;
+    std::function<owl::math::mesh<float>()> create;
+  };
+
+  //spheres, tori and geodesic spheres at three resolutions, in quick mode only the smallest of each
+  inline std::vector<mesh_input> mesh_inputs(bool quick)
+  {
+    std::vector<mesh_input> result;
+    for(std::size_t res : {32, 128, 512})
+    {
+      result.push_back({"sphere_" + std::to_string(res), [res]{ return owl::math::create_sphere<float>(1, res, res); }});
+      if(quick)
+        break;
+    }
+    for(std::size_t res : {32, 128, 512})
+    {
+      result.push_back({"torus_" + std::to_string(res),
+        [res]{ return owl::math::create_torus<float>(0.25f, 1, res / 2, res); }});
+      if(quick)
+        break;
+    }
+    for(std::size_t levels : {3, 5, 7})
+    {
+      result.push_back({"geodesic_sphere_" + std::to_string(levels),
+        [levels]{ return owl::math::create_geodesic_sphere<float>(1, levels); }});
+      if(quick)
+        break;
+    }
+    return result;
+  }
+}
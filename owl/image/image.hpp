@@ -284,7 +284,7 @@ namespace owl
       std::size_t h = n_y + (n_y - 1) * spacing;
       rgb8u_image img(w,h);
 
-      owl::utils::fill(img.colors(img.pixels()), color::rgb8u(255,255,255));
+      owl::utils::fill(owl::utils::execution::par, img.colors(img.pixels()), color::rgb8u(255,255,255));
 
       for(std::size_t x = 0; x < w; x += spacing+1)
         utils::fill(img.colors(img.pixels(img.column(x))), color::rgb8u(0,0,0));
@@ -314,7 +314,7 @@ namespace owl
       std::size_t h = n_y + (n_y - 1) * spacing;
       rgb8u_image img(w, h);
 
-      owl::utils::fill(img.colors(img.pixels()), color::rgb8u(155,155,155));
+      owl::utils::fill(owl::utils::execution::par, img.colors(img.pixels()), color::rgb8u(155,155,155));
 
       for(std::size_t x = w/2 -2; x < w/2+3; ++x)
         owl::utils::fill(img.colors(img.pixels(img.column(x))), y_color);
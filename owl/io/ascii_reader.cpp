@@ -0,0 +1,107 @@
+#include "owl/io/ascii_reader.hpp"
+
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+namespace owl
+{
+  namespace io
+  {
+    namespace
+    {
+      //chunks smaller than this are not worth a thread
+      constexpr std::size_t min_chunk_size = 1 << 18;
+    }
+
+    ascii_reader::ascii_reader()
+      : is_open_(false)
+      , offset_(0)
+      , num_records_(0)
+    {
+    }
+
+    ascii_reader::ascii_reader(const std::string& filename, std::size_t offset)
+      : ascii_reader()
+    {
+      open(filename, offset);
+    }
+
+    bool ascii_reader::open(const std::string& filename, std::size_t offset)
+    {
+      is_open_ = false;
+      chunks_.clear();
+      num_records_ = 0;
+      if(!file_.open(filename) || offset > file_.size())
+        return false;
+      offset_ = offset;
+      is_open_ = true;
+      split();
+      return true;
+    }
+
+    bool ascii_reader::is_open() const
+    {
+      return is_open_;
+    }
+
+    std::size_t ascii_reader::num_records() const
+    {
+      return num_records_;
+    }
+
+    const std::vector<ascii_reader::chunk>& ascii_reader::chunks() const
+    {
+      return chunks_;
+    }
+
+    bool ascii_reader::is_record(const char* first, const char* last)
+    {
+      while(first != last && (*first == ' ' || *first == '\t' || *first == '\r'))
+        ++first;
+      return first != last && *first != '#';
+    }
+
+    void ascii_reader::split()
+    {
+      const char* first = reinterpret_cast<const char*>(file_.data()) + offset_;
+      const char* last = reinterpret_cast<const char*>(file_.end());
+      std::size_t size = static_cast<std::size_t>(last - first);
+      std::size_t n = std::max<std::size_t>(1, std::min(4 * utils::num_threads(), size / min_chunk_size));
+
+      const char* chunk_first = first;
+      for(std::size_t i = 1; i <= n && chunk_first != last; ++i)
+      {
+        const char* chunk_last = i == n ? last : std::max(chunk_first, first + size * i / n);
+        chunk_last = std::find(chunk_last, last, '\n');
+        if(chunk_last != last)
+          ++chunk_last;
+        chunks_.push_back(chunk{chunk_first, chunk_last, 0, 0});
+        chunk_first = chunk_last;
+      }
+
+      utils::parallel_for(std::size_t(0), chunks_.size(), [this](std::size_t c)
+        {
+          auto& ch = chunks_[c];
+          for(const char* line = ch.first; line != ch.last;)
+          {
+            const char* line_end = std::find(line, ch.last, '\n');
+            if(is_record(line, line_end))
+              ++ch.num_records;
+            line = line_end == ch.last ? line_end : line_end + 1;
+          }
+        });
+
+      for(auto& ch : chunks_)
+      {
+        ch.first_record = num_records_;
+        num_records_ += ch.num_records;
+      }
+    }
+  }
+}
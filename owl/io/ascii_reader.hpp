@@ -0,0 +1,211 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <charconv>
+#include <string>
+#include <vector>
+
+#include "owl/utils/mapped_file.hpp"
+#include "owl/utils/parallel.hpp"
+#include "owl/utils/progress.hpp"
+#include "owl/export.hpp"
+
+namespace owl
+{
+  namespace io
+  {
+    //skips blanks and parses the next number of [first, last) without locale, first is advanced behind it
+    template <typename T>
+    bool parse_ascii(const char*& first, const char* last, T& value)
+    {
+      while(first != last && (*first == ' ' || *first == '\t' || *first == '\r'))
+        ++first;
+      if(first != last && *first == '+')
+        ++first;
+      auto result = std::from_chars(first, last, value);
+      if(result.ec != std::errc())
+        return false;
+      first = result.ptr;
+      return true;
+    }
+
+    //skips n numbers of [first, last)
+    inline bool skip_ascii(const char*& first, const char* last, std::size_t n)
+    {
+      double value;
+      for(std::size_t i = 0; i < n; ++i)
+        if(!parse_ascii(first, last, value))
+          return false;
+      return true;
+    }
+
+    //maps a text file into memory and splits it at line boundaries into chunks which are parsed in parallel,
+    //each line which is neither empty nor a # comment is a record
+    class OWL_API ascii_reader
+    {
+    public:
+      struct chunk
+      {
+        const char* first;
+        const char* last;
+        std::size_t first_record;
+        std::size_t num_records;
+      };
+
+      ascii_reader();
+
+      //loads the content of the file behind the given byte offset
+      ascii_reader(const std::string& filename, std::size_t offset = 0);
+
+      bool open(const std::string& filename, std::size_t offset = 0);
+
+      bool is_open() const;
+
+      std::size_t num_records() const;
+
+      const std::vector<chunk>& chunks() const;
+
+      //calls fn(i, first, last) for the records i in [first_record, first_record + count) in parallel,
+      //where i is relative to first_record, returns false if any call of fn returned false
+      //or if the current progress was cancelled
+      template <typename Fn>
+      bool parse_records(std::size_t first_record, std::size_t count, Fn&& fn) const
+      {
+        if(first_record + count > num_records_)
+          return false;
+        utils::progress parsing(count);
+        std::atomic<bool> ok(true);
+        utils::parallel_for(std::size_t(0), chunks_.size(), [&](std::size_t c)
+          {
+            if(!for_each_record(chunks_[c], first_record, count, parsing, fn))
+              ok = false;
+          });
+        return ok;
+      }
+
+      //parses the variable length index lists of the records in [first_record, first_record + count) in parallel,
+      //parse(first, last, indices) appends the indices of one record, the lists are concatenated in file order
+      template <typename Parse>
+      bool parse_lists(std::size_t first_record, std::size_t count, std::vector<std::size_t>& offsets,
+        std::vector<std::size_t>& indices, Parse&& parse) const
+      {
+        if(first_record + count > num_records_)
+          return false;
+        std::vector<std::vector<std::size_t>> chunk_sizes(chunks_.size()), chunk_indices(chunks_.size());
+        utils::progress parsing(count);
+        std::atomic<bool> ok(true);
+        utils::parallel_for(std::size_t(0), chunks_.size(), [&](std::size_t c)
+          {
+            auto& sizes = chunk_sizes[c];
+            auto& list = chunk_indices[c];
+            bool success = for_each_record(chunks_[c], first_record, count, parsing,
+              [&](std::size_t, const char* first, const char* last)
+              {
+                std::size_t n = list.size();
+                if(!parse(first, last, list))
+                  return false;
+                sizes.push_back(list.size() - n);
+                return true;
+              });
+            if(!success)
+              ok = false;
+          });
+        if(!ok)
+          return false;
+
+        std::vector<std::size_t> first_list(chunks_.size() + 1, 0), first_index(chunks_.size() + 1, 0);
+        for(std::size_t c = 0; c < chunks_.size(); ++c)
+        {
+          first_list[c + 1] = first_list[c] + chunk_sizes[c].size();
+          first_index[c + 1] = first_index[c] + chunk_indices[c].size();
+        }
+        offsets.resize(count + 1);
+        offsets[0] = 0;
+        indices.resize(first_index.back());
+        utils::parallel_for(std::size_t(0), chunks_.size(), [&](std::size_t c)
+          {
+            std::size_t offset = first_index[c];
+            for(std::size_t i = 0; i < chunk_sizes[c].size(); ++i)
+              offsets[first_list[c] + i + 1] = offset += chunk_sizes[c][i];
+            std::copy(chunk_indices[c].begin(), chunk_indices[c].end(), indices.begin() + first_index[c]);
+          });
+        return true;
+      }
+
+      //calls fn(c, first, last) for all records of each chunk c in file order, the chunks are processed in
+      //parallel so that fn can keep running state per chunk. returns false if any call of fn returned false
+      //or if the current progress was cancelled
+      template <typename Fn>
+      bool parse_chunks(Fn&& fn) const
+      {
+        utils::progress parsing(num_records_);
+        std::atomic<bool> ok(true);
+        utils::parallel_for(std::size_t(0), chunks_.size(), [&](std::size_t c)
+          {
+            bool success = for_each_record(chunks_[c], 0, num_records_, parsing,
+              [&](std::size_t, const char* first, const char* last)
+              {
+                return fn(c, first, last);
+              });
+            if(!success)
+              ok = false;
+          });
+        return ok;
+      }
+
+    private:
+      //number of records parsed between two progress updates
+      static constexpr std::size_t progress_step_size = 1 << 14;
+
+      template <typename Fn>
+      static bool for_each_record(const chunk& c, std::size_t first_record, std::size_t count,
+        utils::progress& parsing, Fn&& fn)
+      {
+        if(c.first_record + c.num_records <= first_record || c.first_record >= first_record + count)
+          return true;
+        std::size_t record = c.first_record;
+        std::size_t steps = 0;
+        for(const char* line = c.first; line != c.last && record < first_record + count;)
+        {
+          const char* line_end = std::find(line, c.last, '\n');
+          if(is_record(line, line_end))
+          {
+            if(record >= first_record)
+            {
+              if(!fn(record - first_record, line, line_end))
+                return false;
+              if(++steps == progress_step_size)
+              {
+                steps = 0;
+                if(!parsing.step(progress_step_size))
+                  return false;
+              }
+            }
+            ++record;
+          }
+          line = line_end == c.last ? line_end : line_end + 1;
+        }
+        return parsing.step(steps);
+      }
+
+      static bool is_record(const char* first, const char* last);
+
+      void split();
+
+      utils::mapped_file file_;
+      bool is_open_;
+      std::size_t offset_;
+      std::size_t num_records_;
+      std::vector<chunk> chunks_;
+    };
+  }
+}
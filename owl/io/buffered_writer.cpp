@@ -0,0 +1,85 @@
+#include "owl/io/buffered_writer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+namespace owl
+{
+  namespace io
+  {
+    buffered_writer::buffered_writer(const std::string& filename, std::size_t capacity)
+      : file_(filename, std::ios::out | std::ios::binary)
+      , buffer_(std::max<std::size_t>(capacity, 64))
+      , size_(0)
+    {
+    }
+
+    buffered_writer::~buffered_writer()
+    {
+      close();
+    }
+
+    bool buffered_writer::is_open() const
+    {
+      return file_.is_open();
+    }
+
+    bool buffered_writer::good() const
+    {
+      return file_.good();
+    }
+
+    void buffered_writer::write(const void* data, std::size_t n)
+    {
+      if(size_ + n > buffer_.size())
+      {
+        flush();
+        if(n >= buffer_.size())
+        {
+          file_.write(static_cast<const char*>(data), static_cast<std::streamsize>(n));
+          return;
+        }
+      }
+      std::memcpy(buffer_.data() + size_, data, n);
+      size_ += n;
+    }
+
+    void buffered_writer::write(const std::string& text)
+    {
+      write(text.data(), text.size());
+    }
+
+    void buffered_writer::put(char c)
+    {
+      if(size_ == buffer_.size())
+        flush();
+      buffer_[size_++] = c;
+    }
+
+    bool buffered_writer::flush()
+    {
+      if(size_ > 0)
+        file_.write(buffer_.data(), static_cast<std::streamsize>(size_));
+      size_ = 0;
+      return file_.good();
+    }
+
+    bool buffered_writer::close()
+    {
+      if(!file_.is_open())
+        return false;
+      bool ok = flush();
+      file_.close();
+      return ok && !file_.fail();
+    }
+  }
+}
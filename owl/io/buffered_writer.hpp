@@ -0,0 +1,80 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <charconv>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "owl/export.hpp"
+#include "owl/utils/non_copyable.hpp"
+
+namespace owl
+{
+  namespace io
+  {
+    /**
+     * Collects small writes in a large buffer which is written to the file in one block.
+     * Writes larger than the buffer bypass it.
+     */
+    class OWL_API buffered_writer : utils::non_copyable
+    {
+    public:
+      explicit buffered_writer(const std::string& filename, std::size_t capacity = 1 << 20);
+
+      /**
+       * Flushes and closes the file.
+       */
+      ~buffered_writer();
+
+      bool is_open() const;
+
+      /**
+       * Returns false if any write failed.
+       */
+      bool good() const;
+
+      void write(const void* data, std::size_t n);
+
+      void write(const std::string& text);
+
+      void put(char c);
+
+      template <typename T>
+      void write_value(const T& value)
+      {
+        write(&value, sizeof(T));
+      }
+
+      /**
+       * Writes the shortest decimal representation of value which reads back to the same value.
+       */
+      template <typename T>
+      void write_ascii(const T& value)
+      {
+        constexpr std::size_t max_length = 32;
+        if(buffer_.size() - size_ < max_length)
+          flush();
+        auto result = std::to_chars(buffer_.data() + size_, buffer_.data() + buffer_.size(), value);
+        size_ = result.ptr - buffer_.data();
+      }
+
+      bool flush();
+
+      bool close();
+
+    private:
+      std::ofstream file_;
+      std::vector<char> buffer_;
+      std::size_t size_;
+    };
+  }
+}
@@ -1,4 +1,6 @@
 #include "owl/io/off.hpp"
+#include "owl/io/ascii_reader.hpp"
+#include "owl/utils/progress.hpp"
 #include <iostream>
 
 namespace owl
@@ -16,7 +18,8 @@ namespace owl
 
     void off_reader::open(const std::string& filename)
     {
-      file_.open(filename, std::ios_base::in);
+      filename_ = filename;
+      file_.open(filename, std::ios_base::in | std::ios_base::binary);
       read_header();
     }
 
@@ -134,5 +137,47 @@ namespace owl
   
       return true;
     }
+  
+    bool off_reader::read(std::vector<float>& positions, std::vector<std::size_t>& face_offsets,
+      std::vector<std::size_t>& face_indices)
+    {
+      if(!is_open() || !file_)
+        return false;
+
+      ascii_reader text(filename_, static_cast<std::size_t>(file_.tellg()));
+      if(!text.is_open())
+        return false;
+
+      utils::progress reading(n_vertices_ + n_faces_);
+      positions.resize(3 * n_vertices_);
+      reading.make_current(n_vertices_);
+      bool ok = text.parse_records(0, n_vertices_,
+        [&positions](std::size_t i, const char* first, const char* last)
+        {
+          return parse_ascii(first, last, positions[3 * i])
+            && parse_ascii(first, last, positions[3 * i + 1])
+            && parse_ascii(first, last, positions[3 * i + 2]);
+        });
+      reading.resign_current();
+      if(!ok)
+        return false;
+
+      reading.make_current(n_faces_);
+      return text.parse_lists(n_vertices_, n_faces_, face_offsets, face_indices,
+        [](const char* first, const char* last, std::vector<std::size_t>& indices)
+        {
+          std::size_t n;
+          if(!parse_ascii(first, last, n))
+            return false;
+          for(std::size_t k = 0; k < n; ++k)
+          {
+            std::size_t v;
+            if(!parse_ascii(first, last, v))
+              return false;
+            indices.push_back(v);
+          }
+          return true;
+        });
+    }
   }
 }
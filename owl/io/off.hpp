@@ -35,6 +35,11 @@ namespace owl
       bool listen_2_vertex(std::function<void(const float &, const float&, const float&)> fn);
     
       bool read();
+
+      //reads all vertices and faces at once parsing chunks of the text in parallel, positions receives
+      //three coordinates per vertex and face f consists of face_indices[face_offsets[f], face_offsets[f + 1])
+      bool read(std::vector<float>& positions, std::vector<std::size_t>& face_offsets,
+        std::vector<std::size_t>& face_indices);
     
       std::size_t num_vertices() const;
     
@@ -56,6 +61,8 @@ namespace owl
       std::size_t n_edges_ = 0;
     
       std::ifstream file_;
+
+      std::string filename_;
     
       std::function<void(const float&, const float&, const float&)> on_vertex_;
     
@@ -63,7 +70,7 @@ namespace owl
     
     };
   
-    bool create_off_cube(const std::string& filename)
+    inline bool create_off_cube(const std::string& filename)
     {
       std::ofstream off(filename);
       if(off.is_open())
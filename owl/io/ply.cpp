@@ -63,12 +63,14 @@ namespace owl
     ply_reader::ply_reader()
       : header_complete(false)
       , format_complete(false)
+      , data_offset(0)
     {
     }
   
     ply_reader::ply_reader(const std::string& filename)
       : header_complete(false)
       , format_complete(false)
+      , data_offset(0)
     {
       open(filename);
     }
@@ -84,6 +86,7 @@ namespace owl
         file.close();
         return;
       }
+      data_offset = static_cast<std::size_t>(file.tellg());
     }
   
     bool ply_reader::is_open() const
@@ -170,6 +173,38 @@ namespace owl
         return e->count;
     }
   
+    std::vector<std::string> ply_reader::get_element_names() const
+    {
+      std::vector<std::string> names;
+      names.reserve(elements.size());
+      for(auto& e: elements)
+        names.push_back(e.name);
+      return names;
+    }
+  
+    std::vector<ply_reader::property_layout> ply_reader::get_element_layout(const std::string& element_name) const
+    {
+      std::vector<property_layout> layout;
+      const element* e = get_element(element_name);
+      if(e == nullptr)
+        return layout;
+    
+      layout.reserve(e->properties.size());
+      for(auto& p: e->properties)
+        layout.push_back(p->layout());
+      return layout;
+    }
+  
+    bool ply_reader::is_binary() const
+    {
+      return file_encoding != encoding_type::ascii;
+    }
+  
+    std::size_t ply_reader::get_data_offset() const
+    {
+      return data_offset;
+    }
+  
     std::istream& ply_reader::read_header(std::istream& in)
     {
       format_complete = header_complete = false;
@@ -224,6 +259,13 @@ namespace owl
       return (u.c[sizeof (long) - 1] == 1) ? true : false;
     }
   
+    bool ply_reader::needs_byte_swap() const
+    {
+      bool is_big_endian_machine = host_is_big_endian();
+      return (is_big_endian_machine && file_encoding == encoding_type::binary_little_endian)
+        || (!is_big_endian_machine && file_encoding == encoding_type::binary_big_endian);
+    }
+  
     std::istream& ply_reader::read_data(std::istream& in)
     {
       if(in)
@@ -248,11 +290,7 @@ namespace owl
         }
         else
         {
-          bool is_big_endian_machine = host_is_big_endian();
-        
-          bool swap_endianess =
-            (is_big_endian_machine && file_encoding == encoding_type::binary_little_endian)
-            || (!is_big_endian_machine && file_encoding == encoding_type::binary_big_endian);
+          bool swap_endianess = needs_byte_swap();
         
           for(auto& e: elements)
           {
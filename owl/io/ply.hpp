@@ -12,6 +12,10 @@
 #include <memory>
 #include <iostream>
 #include <fstream>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace owl
@@ -49,20 +53,57 @@ namespace owl
         const std::string& property_name, std::function<void(const std::vector<T>& v)> fn);
   
       bool read();
-  
+
       void close();
-    
+
       std::size_t get_element_count(const std::string& name) const;
-    
+
+      enum class scalar_type
+      {
+        int8,
+        uint8,
+        int16,
+        uint16,
+        int32,
+        uint32,
+        float32,
+        float64
+      };
+
+      //describes the binary layout of a single property as declared in the header
+      struct property_layout
+      {
+        std::string name;
+        scalar_type value_type;
+        //only meaningful if is_list is true
+        scalar_type size_type;
+        bool is_list;
+      };
+
+      //names of all elements in the order of their appearance in the file
+      std::vector<std::string> get_element_names() const;
+
+      std::vector<property_layout> get_element_layout(const std::string& element_name) const;
+
+      bool is_binary() const;
+
+      //true if the byte order of the file differs from the byte order of the host
+      bool needs_byte_swap() const;
+
+      //byte offset of the first data byte behind the header
+      std::size_t get_data_offset() const;
+
     private:
       struct ply_property
       {
         std::string name;
-    
+
         virtual std::istream& read_ascii(std::istream& in) = 0;
-    
+
         virtual std::istream& read_binary(std::istream& in, bool swap_endianess) = 0;
-    
+
+        virtual property_layout layout() const = 0;
+
         ply_property(const std::string& name);
       };
   
@@ -74,21 +115,25 @@ namespace owl
         scalar_property(const std::string& name);
     
         std::istream& read_ascii(std::istream& in);
-    
+
         std::istream&  read_binary(std::istream& in, bool swap_endianess);
+
+        property_layout layout() const;
       };
-    
-    
+
+
       template <typename C, typename T>
       struct list_property: ply_property
       {
         std::function<void(const std::vector<T>&)> on_read;
-    
+
         list_property(const std::string& name);
-    
+
         std::istream& read_ascii(std::istream& in);
-    
+
         std::istream& read_binary(std::istream& in, bool swap_endianess);
+
+        property_layout layout() const;
       };
     
       struct element
@@ -165,10 +210,12 @@ namespace owl
       std::function<void(const std::string&, std::size_t)> on_element_begin;
   
       std::function<void(const std::string&)> on_element_end;
-  
+
       std::ifstream file;
+
+      std::size_t data_offset;
     };
-  
+
     namespace detail
     {
       template <typename T>
@@ -177,10 +224,51 @@ namespace owl
         in >> v;
         return in;
       }
-    
+
       template <>
       inline std::istream& read_ascii<std::uint8_t>(std::istream& in, std::uint8_t& v);
-    } 
+
+      template <typename T>
+      constexpr ply_reader::scalar_type ply_scalar_type();
+
+      template <>
+      constexpr ply_reader::scalar_type ply_scalar_type<std::int8_t>() { return ply_reader::scalar_type::int8; }
+      template <>
+      constexpr ply_reader::scalar_type ply_scalar_type<std::uint8_t>() { return ply_reader::scalar_type::uint8; }
+      template <>
+      constexpr ply_reader::scalar_type ply_scalar_type<std::int16_t>() { return ply_reader::scalar_type::int16; }
+      template <>
+      constexpr ply_reader::scalar_type ply_scalar_type<std::uint16_t>() { return ply_reader::scalar_type::uint16; }
+      template <>
+      constexpr ply_reader::scalar_type ply_scalar_type<std::int32_t>() { return ply_reader::scalar_type::int32; }
+      template <>
+      constexpr ply_reader::scalar_type ply_scalar_type<std::uint32_t>() { return ply_reader::scalar_type::uint32; }
+      template <>
+      constexpr ply_reader::scalar_type ply_scalar_type<float>() { return ply_reader::scalar_type::float32; }
+      template <>
+      constexpr ply_reader::scalar_type ply_scalar_type<double>() { return ply_reader::scalar_type::float64; }
+    }
+
+    //size in bytes of a single value of given type
+    inline std::size_t size_of(ply_reader::scalar_type type)
+    {
+      switch(type)
+      {
+        case ply_reader::scalar_type::int8:
+        case ply_reader::scalar_type::uint8:
+          return 1;
+        case ply_reader::scalar_type::int16:
+        case ply_reader::scalar_type::uint16:
+          return 2;
+        case ply_reader::scalar_type::int32:
+        case ply_reader::scalar_type::uint32:
+        case ply_reader::scalar_type::float32:
+          return 4;
+        case ply_reader::scalar_type::float64:
+          return 8;
+      }
+      return 0;
+    }
   
     template <typename T>
     ply_reader::scalar_property<T>::scalar_property(const std::string& name)
@@ -216,14 +304,26 @@ namespace owl
       }
       if(in && on_read)
         on_read(value);
-  
+
       return in;
     }
-  
+
+    template <typename T>
+    ply_reader::property_layout ply_reader::scalar_property<T>::layout() const
+    {
+      return {name, detail::ply_scalar_type<T>(), detail::ply_scalar_type<T>(), false};
+    }
+
     template <typename C, typename T>
     ply_reader::list_property<C,T>::list_property(const std::string& name)
       : ply_property(name)
     {}
+
+    template <typename C, typename T>
+    ply_reader::property_layout ply_reader::list_property<C,T>::layout() const
+    {
+      return {name, detail::ply_scalar_type<T>(), detail::ply_scalar_type<C>(), true};
+    }
   
     template <typename C, typename T>
     std::istream& ply_reader::list_property<C,T>::read_ascii(std::istream& in)
@@ -260,7 +360,6 @@ namespace owl
       values.resize((typename std::vector<T>::size_type)n);
   
       in.read((char*)values.data(),sizeof(T)*n);
-      swap_endianess = true;
       if(in && swap_endianess)
       {
         for(T& v: values)
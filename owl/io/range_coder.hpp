@@ -0,0 +1,198 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace owl
+{
+  namespace io
+  {
+    //adaptive frequencies of the symbols [0, size()) coded by range_encoder and range_decoder. each coded symbol
+    //increases its frequency, all frequencies are halved when their total would exceed the coder's precision
+    class adaptive_model
+    {
+    public:
+      explicit adaptive_model(std::size_t num_symbols)
+        : freqs_(std::max<std::size_t>(num_symbols, 1), 1)
+        , total_(static_cast<std::uint32_t>(freqs_.size()))
+      {
+      }
+
+      std::size_t size() const
+      {
+        return freqs_.size();
+      }
+
+    private:
+      friend class range_encoder;
+      friend class range_decoder;
+
+      static constexpr std::uint32_t increment = 24;
+      static constexpr std::uint32_t max_total = 1 << 16;
+
+      void update(std::size_t symbol)
+      {
+        freqs_[symbol] += increment;
+        total_ += increment;
+        if(total_ <= max_total)
+          return;
+        total_ = 0;
+        for(auto& f : freqs_)
+          total_ += f = (f + 1) / 2;
+      }
+
+      std::vector<std::uint32_t> freqs_;
+      std::uint32_t total_;
+    };
+
+    //carryless range coder appending bytes to a vector, call finish before using the bytes
+    class range_encoder
+    {
+    public:
+      explicit range_encoder(std::vector<std::uint8_t>& bytes)
+        : bytes_(bytes)
+      {
+      }
+
+      void encode(std::size_t symbol, adaptive_model& model)
+      {
+        std::uint32_t cum = 0;
+        for(std::size_t i = 0; i < symbol; ++i)
+          cum += model.freqs_[i];
+        encode(cum, model.freqs_[symbol], model.total_);
+        model.update(symbol);
+      }
+
+      //codes the lowest n bits of value with equal probabilities
+      void encode_bits(std::uint64_t value, std::size_t n)
+      {
+        for(; n > 16; n -= 16, value >>= 16)
+          encode_bits(value & 0xffff, 16);
+        range_ >>= n;
+        low_ += static_cast<std::uint32_t>(value & ((std::uint64_t(1) << n) - 1)) * range_;
+        normalize();
+      }
+
+      void finish()
+      {
+        for(int i = 0; i < 4; ++i, low_ <<= 8)
+          bytes_.push_back(static_cast<std::uint8_t>(low_ >> 24));
+      }
+
+    private:
+      static constexpr std::uint32_t top = 1 << 24;
+      static constexpr std::uint32_t bottom = 1 << 16;
+
+      void encode(std::uint32_t cum, std::uint32_t freq, std::uint32_t total)
+      {
+        range_ /= total;
+        low_ += cum * range_;
+        range_ *= freq;
+        normalize();
+      }
+
+      void normalize()
+      {
+        //the range is shrunk instead of propagating a carry when it straddles a byte boundary while small
+        while((low_ ^ (low_ + range_)) < top || (range_ < bottom && ((range_ = -low_ & (bottom - 1)), true)))
+        {
+          bytes_.push_back(static_cast<std::uint8_t>(low_ >> 24));
+          low_ <<= 8;
+          range_ <<= 8;
+        }
+      }
+
+      std::vector<std::uint8_t>& bytes_;
+      std::uint32_t low_ = 0;
+      std::uint32_t range_ = ~std::uint32_t(0);
+    };
+
+    //decodes the bytes of a range_encoder given the same sequence of models and bit counts,
+    //reading past the end yields zero bytes
+    class range_decoder
+    {
+    public:
+      range_decoder(const std::uint8_t* first, const std::uint8_t* last)
+        : next_(first)
+        , last_(last)
+      {
+        for(int i = 0; i < 4; ++i)
+          code_ = code_ << 8 | next_byte();
+      }
+
+      std::size_t decode(adaptive_model& model)
+      {
+        range_ /= model.total_;
+        std::uint32_t value = std::min((code_ - low_) / range_, model.total_ - 1);
+        std::size_t symbol = 0;
+        std::uint32_t cum = 0;
+        while(cum + model.freqs_[symbol] <= value)
+          cum += model.freqs_[symbol++];
+        low_ += cum * range_;
+        range_ *= model.freqs_[symbol];
+        normalize();
+        model.update(symbol);
+        return symbol;
+      }
+
+      std::uint64_t decode_bits(std::size_t n)
+      {
+        std::uint64_t value = 0;
+        std::size_t shift = 0;
+        for(; n > 16; n -= 16, shift += 16)
+          value |= decode_bits(16) << shift;
+        range_ >>= n;
+        std::uint32_t bits = std::min((code_ - low_) / range_, (std::uint32_t(1) << n) - 1);
+        low_ += bits * range_;
+        normalize();
+        return value | std::uint64_t(bits) << shift;
+      }
+
+      //returns true if the decoder read past the end of the bytes
+      bool overrun() const
+      {
+        return overrun_ > 0;
+      }
+
+    private:
+      static constexpr std::uint32_t top = 1 << 24;
+      static constexpr std::uint32_t bottom = 1 << 16;
+
+      std::uint8_t next_byte()
+      {
+        if(next_ != last_)
+          return *next_++;
+        ++overrun_;
+        return 0;
+      }
+
+      void normalize()
+      {
+        while((low_ ^ (low_ + range_)) < top || (range_ < bottom && ((range_ = -low_ & (bottom - 1)), true)))
+        {
+          code_ = code_ << 8 | next_byte();
+          low_ <<= 8;
+          range_ <<= 8;
+        }
+      }
+
+      const std::uint8_t* next_;
+      const std::uint8_t* last_;
+      std::size_t overrun_ = 0;
+      std::uint32_t low_ = 0;
+      std::uint32_t range_ = ~std::uint32_t(0);
+      std::uint32_t code_ = 0;
+    };
+  }
+}
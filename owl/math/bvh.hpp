@@ -0,0 +1,869 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "owl/math/mesh.hpp"
+#include "owl/math/ray.hpp"
+#include "owl/math/utils.hpp"
+#include "owl/utils/parallel.hpp"
+#include "owl/utils/profiler.hpp"
+#include "owl/utils/radix_sort.hpp"
+
+namespace owl
+{
+  namespace math
+  {
+    //result of a ray query, u and v are the barycentric coordinates of the hit point
+    //in the triangle of the fan of face which was hit
+    template <typename Scalar>
+    struct ray_hit
+    {
+      face_handle face;
+      Scalar t = std::numeric_limits<Scalar>::max();
+      Scalar u = 0;
+      Scalar v = 0;
+
+      bool is_valid() const
+      {
+        return face.is_valid();
+      }
+    };
+
+    //construction algorithms of the bvh
+    enum class bvh_builder
+    {
+      //top down binned surface area heuristic, slowest build but best trees
+      sah,
+      //linear bvh from parallel sorted morton codes, fastest build
+      lbvh,
+      //linear bvh improved by parallel treelet restructuring with the surface area heuristic
+      lbvh_sah
+    };
+
+    //bounding volume hierarchy over the faces of a mesh, polygons are split into triangle fans,
+    //the tree is stored depth first in one array
+    template <typename Scalar>
+    class bvh
+    {
+    public:
+      using scalar = Scalar;
+      using vector3 = vector<Scalar, 3>;
+      using box3 = box<Scalar, false, false>;
+      using ray3 = ray<Scalar, 3>;
+      using hit = ray_hit<Scalar>;
+
+      //number of rays which are traversed together by the packet queries
+      static constexpr std::size_t packet_size = 8;
+
+      //the left child of an inner node is stored right behind it
+      struct node
+      {
+        box3 bounds;
+        //first triangle of a leaf or right child of an inner node
+        std::uint32_t offset;
+        //number of triangles of a leaf, zero for inner nodes
+        std::uint16_t count;
+        std::uint16_t axis;
+
+        bool is_leaf() const
+        {
+          return count > 0;
+        }
+      };
+
+      bvh() = default;
+
+      explicit bvh(const mesh<Scalar>& m, std::size_t max_leaf_size = 8, bvh_builder builder = bvh_builder::sah)
+      {
+        build(m, max_leaf_size, builder);
+      }
+
+      void build(const mesh<Scalar>& m, std::size_t max_leaf_size = 8, bvh_builder builder = bvh_builder::sah)
+      {
+        OWL_PROFILE_SCOPE("bvh::build");
+        clear();
+        max_leaf_size = std::clamp<std::size_t>(max_leaf_size, 1, std::numeric_limits<std::uint16_t>::max());
+
+        std::vector<primitive> prims;
+        std::vector<triangle> triangles;
+        std::vector<face_handle> faces;
+        collect_triangles(m, prims, triangles, faces);
+        if(prims.empty())
+          return;
+
+        nodes_.reserve(2 * prims.size());
+        if(builder == bvh_builder::sah)
+          build_node(prims, 0, prims.size(), 0, max_leaf_size);
+        else
+          build_lbvh(prims, builder == bvh_builder::lbvh_sah, max_leaf_size);
+
+        triangles_.resize(prims.size());
+        faces_.resize(prims.size());
+        utils::parallel_for_blocks(std::size_t(0), prims.size(), 1 << 14, [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t i = first; i < last; ++i)
+            {
+              triangles_[i] = triangles[prims[i].index];
+              faces_[i] = faces[prims[i].index];
+            }
+          });
+      }
+
+      //expected cost of a random ray query relative to the cost of one triangle test
+      Scalar sah_cost() const
+      {
+        if(empty())
+          return 0;
+        Scalar cost = 0;
+        for(const auto& nd : nodes_)
+          cost += nd.is_leaf() ? nd.count * half_area(nd.bounds) : half_area(nd.bounds);
+        return cost / half_area(bounds());
+      }
+
+      void clear()
+      {
+        depth_ = 0;
+        nodes_.clear();
+        triangles_.clear();
+        faces_.clear();
+      }
+
+      bool empty() const
+      {
+        return nodes_.empty();
+      }
+
+      //bounds of all faces, the tree must not be empty
+      const box3& bounds() const
+      {
+        return nodes_.front().bounds;
+      }
+
+      const std::vector<node>& nodes() const
+      {
+        return nodes_;
+      }
+
+      std::size_t num_triangles() const
+      {
+        return triangles_.size();
+      }
+
+      //returns the closest hit in (t_min, t_max), the hit is invalid if the ray misses all faces
+      hit intersect(const ray3& r, Scalar t_min = 0, Scalar t_max = std::numeric_limits<Scalar>::max()) const
+      {
+        hit h;
+        traverse<false>(&r, 1, &h, t_min, t_max);
+        return h;
+      }
+
+      //returns true if the ray hits any face in (t_min, t_max)
+      bool intersect_any(const ray3& r, Scalar t_min = 0, Scalar t_max = std::numeric_limits<Scalar>::max()) const
+      {
+        hit h;
+        traverse<true>(&r, 1, &h, t_min, t_max);
+        return h.is_valid();
+      }
+
+      //closest hits of up to packet_size rays which are traversed together,
+      //works best if the rays are coherent like neighboring camera rays
+      void intersect_packet(const ray3* rays, std::size_t n, hit* hits,
+        Scalar t_min = 0, Scalar t_max = std::numeric_limits<Scalar>::max()) const
+      {
+        assert(n <= packet_size);
+        traverse<false>(rays, n, hits, t_min, t_max);
+      }
+
+      //closest hits of all rays, packets of consecutive rays are processed in parallel
+      std::vector<hit> intersect(const std::vector<ray3>& rays,
+        Scalar t_min = 0, Scalar t_max = std::numeric_limits<Scalar>::max()) const
+      {
+        std::vector<hit> hits(rays.size());
+        for_each_packet(rays.size(), [&](std::size_t first, std::size_t n)
+          {
+            traverse<false>(rays.data() + first, n, hits.data() + first, t_min, t_max);
+          });
+        return hits;
+      }
+
+      //for each ray whether it hits any face, packets of consecutive rays are processed in parallel
+      std::vector<std::uint8_t> intersect_any(const std::vector<ray3>& rays,
+        Scalar t_min = 0, Scalar t_max = std::numeric_limits<Scalar>::max()) const
+      {
+        std::vector<std::uint8_t> hits(rays.size());
+        for_each_packet(rays.size(), [&](std::size_t first, std::size_t n)
+          {
+            hit packet_hits[packet_size];
+            traverse<true>(rays.data() + first, n, packet_hits, t_min, t_max);
+            for(std::size_t i = 0; i < n; ++i)
+              hits[first + i] = packet_hits[i].is_valid();
+          });
+        return hits;
+      }
+
+    private:
+      //first vertex and the two edges leaving it
+      using triangle = std::array<vector3, 3>;
+
+      struct primitive
+      {
+        box3 bounds;
+        vector3 centroid;
+        std::uint32_t index;
+      };
+
+      static constexpr std::size_t num_bins = 16;
+
+      //deeper subtrees are split at the median which bounds the depth by max_sah_depth + 32
+      static constexpr std::size_t max_sah_depth = 64;
+
+      //deeper trees traverse with a heap allocated stack
+      static constexpr std::size_t stack_size = 96;
+
+      //number of leaves of the treelets which are restructured by the lbvh_sah builder
+      static constexpr std::size_t treelet_size = 7;
+
+      static constexpr std::uint32_t invalid_index = std::numeric_limits<std::uint32_t>::max();
+
+      //node of the binary radix tree of the lbvh, with n triangles the nodes [0, n - 1) are the inner nodes
+      //with the root at 0 and the nodes [n - 1, 2n - 1) are the leaves
+      struct radix_node
+      {
+        box3 bounds;
+        Scalar cost;
+        std::uint32_t count;
+        std::uint32_t parent;
+        std::uint32_t left;
+        std::uint32_t right;
+      };
+
+      //leaves and inner nodes of a treelet and the optimal costs and splits of all subsets of its leaves
+      struct treelet
+      {
+        std::array<std::uint32_t, treelet_size> leaves;
+        std::array<std::uint32_t, treelet_size - 2> inner;
+        std::size_t num_leaves = 0;
+        std::size_t num_inner = 0;
+        std::array<Scalar, 1 << treelet_size> cost;
+        std::array<std::uint8_t, 1 << treelet_size> split;
+      };
+
+      static Scalar half_area(const box3& b)
+      {
+        auto e = b.extents();
+        return e[0] * e[1] + e[1] * e[2] + e[2] * e[0];
+      }
+
+      static void insert(box3& b, const box3& other)
+      {
+        b.insert(other.lower_bound);
+        b.insert(other.upper_bound);
+      }
+
+      //splits the faces into triangle fans in parallel, the triangles of a face are consecutive
+      static void collect_triangles(const mesh<Scalar>& m, std::vector<primitive>& prims,
+        std::vector<triangle>& triangles, std::vector<face_handle>& faces)
+      {
+        std::vector<std::size_t> first_triangle(m.num_faces() + 1, 0);
+        utils::parallel_for_blocks(std::size_t(0), m.num_faces(), 1 << 14, [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t f = first; f < last; ++f)
+            {
+              std::size_t n = m.status(face_handle(f)).is_removed() ? 0 : m.valence(face_handle(f));
+              first_triangle[f + 1] = n > 2 ? n - 2 : 0;
+            }
+          });
+        std::partial_sum(first_triangle.begin(), first_triangle.end(), first_triangle.begin());
+
+        prims.resize(first_triangle.back());
+        triangles.resize(first_triangle.back());
+        faces.resize(first_triangle.back());
+        utils::parallel_for_blocks(std::size_t(0), m.num_faces(), 1 << 14, [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t f = first; f < last; ++f)
+            {
+              std::size_t i = first_triangle[f];
+              if(i == first_triangle[f + 1])
+                continue;
+              auto he0 = m.inner(face_handle(f));
+              auto he = m.next(he0);
+              const auto& p0 = m.position(m.target(he0));
+              for(auto he_next = m.next(he); he_next != he0; he = he_next, he_next = m.next(he_next), ++i)
+              {
+                const auto& p1 = m.position(m.target(he));
+                const auto& p2 = m.position(m.target(he_next));
+                triangles[i] = {{p0, p1 - p0, p2 - p0}};
+                faces[i] = face_handle(f);
+                auto& prim = prims[i];
+                prim.bounds = box3(p0);
+                prim.bounds.insert(p1);
+                prim.bounds.insert(p2);
+                prim.centroid = prim.bounds.center();
+                prim.index = static_cast<std::uint32_t>(i);
+              }
+            }
+          });
+      }
+
+      std::uint32_t build_node(std::vector<primitive>& prims, std::size_t first, std::size_t last,
+        std::size_t depth, std::size_t max_leaf_size)
+      {
+        depth_ = std::max(depth_, depth);
+        auto index = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+        box3 bounds, centroid_bounds;
+        for(std::size_t i = first; i < last; ++i)
+        {
+          insert(bounds, prims[i].bounds);
+          centroid_bounds.insert(prims[i].centroid);
+        }
+        nodes_[index].bounds = bounds;
+
+        std::size_t n = last - first;
+        std::size_t mid = first;
+        std::size_t axis = 0;
+        if(n > 1 && depth < max_sah_depth)
+          mid = split_sah(prims, first, last, bounds, centroid_bounds, max_leaf_size, axis);
+        if(mid == first && n > max_leaf_size)
+        {
+          axis = centroid_bounds.extents()[1] > centroid_bounds.extents()[axis] ? 1 : axis;
+          axis = centroid_bounds.extents()[2] > centroid_bounds.extents()[axis] ? 2 : axis;
+          mid = first + n / 2;
+          std::nth_element(prims.begin() + first, prims.begin() + mid, prims.begin() + last,
+            [axis](const primitive& a, const primitive& b) { return a.centroid[axis] < b.centroid[axis]; });
+        }
+
+        if(mid == first)
+        {
+          nodes_[index].offset = static_cast<std::uint32_t>(first);
+          nodes_[index].count = static_cast<std::uint16_t>(n);
+          return index;
+        }
+
+        build_node(prims, first, mid, depth + 1, max_leaf_size);
+        auto right = build_node(prims, mid, last, depth + 1, max_leaf_size);
+        nodes_[index].offset = right;
+        nodes_[index].count = 0;
+        nodes_[index].axis = static_cast<std::uint16_t>(axis);
+        return index;
+      }
+
+      static int count_leading_zeros(std::uint32_t x)
+      {
+        if(x == 0)
+          return 32;
+        int n = 0;
+        if(x <= 0x0000ffff) { n += 16; x <<= 16; }
+        if(x <= 0x00ffffff) { n += 8; x <<= 8; }
+        if(x <= 0x0fffffff) { n += 4; x <<= 4; }
+        if(x <= 0x3fffffff) { n += 2; x <<= 2; }
+        if(x <= 0x7fffffff) { n += 1; }
+        return n;
+      }
+
+      //sorts the primitives along the morton curve through their centroids, builds the binary radix tree
+      //of the sorted morton codes in parallel following karras 2012 and emits it depth first
+      void build_lbvh(std::vector<primitive>& prims, bool refine, std::size_t max_leaf_size)
+      {
+        auto n = static_cast<std::uint32_t>(prims.size());
+        std::size_t n_blocks = utils::num_threads();
+        std::vector<box3> block_bounds(n_blocks);
+        utils::parallel_for(std::size_t(0), n_blocks, [&](std::size_t b)
+          {
+            for(std::size_t i = n * b / n_blocks; i < n * (b + 1) / n_blocks; ++i)
+              block_bounds[b].insert(prims[i].centroid);
+          });
+        box3 centroid_bounds;
+        for(const auto& b : block_bounds)
+          if(!b.empty())
+            insert(centroid_bounds, b);
+
+        vector3 scale;
+        for(std::size_t j = 0; j < 3; ++j)
+        {
+          Scalar extent = centroid_bounds.upper_bound[j] - centroid_bounds.lower_bound[j];
+          scale[j] = extent > 0 ? Scalar(1023) / extent : 0;
+        }
+        std::vector<std::uint32_t> codes(n);
+        std::vector<std::uint32_t> order(n);
+        utils::parallel_for_blocks(std::size_t(0), std::size_t(n), 1 << 14, [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t i = first; i < last; ++i)
+            {
+              std::uint32_t code = 0;
+              for(std::size_t j = 0; j < 3; ++j)
+              {
+                Scalar x = (prims[i].centroid[j] - centroid_bounds.lower_bound[j]) * scale[j];
+                code = code << 1 | expand_bits(static_cast<std::uint32_t>(std::clamp<Scalar>(x, 0, 1023)));
+              }
+              codes[i] = code;
+              order[i] = static_cast<std::uint32_t>(i);
+            }
+          });
+        utils::radix_sort(codes, order);
+
+        if(n == 1)
+        {
+          depth_ = 0;
+          nodes_.push_back(node{prims[0].bounds, 0, 1, 0});
+          return;
+        }
+
+        std::vector<radix_node> tree(2 * n - 1);
+        utils::parallel_for_blocks(std::uint32_t(0), n, 1 << 14, [&](std::uint32_t first, std::uint32_t last)
+          {
+            for(std::uint32_t i = first; i < last; ++i)
+            {
+              auto& leaf = tree[n - 1 + i];
+              leaf.bounds = prims[order[i]].bounds;
+              leaf.cost = half_area(leaf.bounds);
+              leaf.count = 1;
+            }
+          });
+        tree[0].parent = invalid_index;
+
+        //length of the common prefix of the codes i and j, equal codes are told apart by their index
+        auto delta = [&](std::int64_t i, std::int64_t j)
+          {
+            if(j < 0 || j >= n)
+              return -1;
+            if(codes[i] == codes[j])
+              return 32 + count_leading_zeros(static_cast<std::uint32_t>(i ^ j));
+            return count_leading_zeros(codes[i] ^ codes[j]);
+          };
+        utils::parallel_for_blocks(std::int64_t(0), std::int64_t(n - 1), 1 << 12, [&](std::int64_t first, std::int64_t last)
+          {
+            for(std::int64_t i = first; i < last; ++i)
+            {
+              std::int64_t d = delta(i, i + 1) > delta(i, i - 1) ? 1 : -1;
+              int delta_min = delta(i, i - d);
+              std::int64_t l_max = 2;
+              while(delta(i, i + l_max * d) > delta_min)
+                l_max *= 2;
+              std::int64_t l = 0;
+              for(std::int64_t t = l_max / 2; t >= 1; t /= 2)
+                if(delta(i, i + (l + t) * d) > delta_min)
+                  l += t;
+              std::int64_t j = i + l * d;
+
+              int delta_node = delta(i, j);
+              std::int64_t s = 0;
+              for(std::int64_t t = (l + 1) / 2; ; t = (t + 1) / 2)
+              {
+                if(delta(i, i + (s + t) * d) > delta_node)
+                  s += t;
+                if(t == 1)
+                  break;
+              }
+              std::int64_t gamma = i + s * d + std::min<std::int64_t>(d, 0);
+
+              auto& nd = tree[i];
+              nd.left = static_cast<std::uint32_t>(std::min(i, j) == gamma ? n - 1 + gamma : gamma);
+              nd.right = static_cast<std::uint32_t>(std::max(i, j) == gamma + 1 ? n - 1 + gamma + 1 : gamma + 1);
+              tree[nd.left].parent = static_cast<std::uint32_t>(i);
+              tree[nd.right].parent = static_cast<std::uint32_t>(i);
+            }
+          });
+
+        //the second thread arriving at an inner node computes its bounds, all nodes below are final then
+        std::vector<std::atomic<std::uint32_t>> visits(n - 1);
+        utils::parallel_for_blocks(std::uint32_t(0), n, 1 << 12, [&](std::uint32_t first, std::uint32_t last)
+          {
+            for(std::uint32_t i = first; i < last; ++i)
+            {
+              for(auto index = tree[n - 1 + i].parent; index != invalid_index; index = tree[index].parent)
+              {
+                if(visits[index].fetch_add(1, std::memory_order_acq_rel) == 0)
+                  break;
+                update_radix_node(tree, index);
+                if(refine)
+                  restructure(tree, index, n);
+              }
+            }
+          });
+
+        emit_radix_tree(tree, prims, order, n, max_leaf_size);
+      }
+
+      static void update_radix_node(std::vector<radix_node>& tree, std::uint32_t index)
+      {
+        auto& nd = tree[index];
+        const auto& left = tree[nd.left];
+        const auto& right = tree[nd.right];
+        nd.bounds = left.bounds;
+        insert(nd.bounds, right.bounds);
+        nd.count = left.count + right.count;
+        nd.cost = half_area(nd.bounds) + left.cost + right.cost;
+      }
+
+      //replaces the treelet below root formed by its treelet_size largest descendants with the topology
+      //of minimal surface area cost following karras and aila 2013
+      static void restructure(std::vector<radix_node>& tree, std::uint32_t root, std::uint32_t n)
+      {
+        treelet t;
+        t.leaves[t.num_leaves++] = tree[root].left;
+        t.leaves[t.num_leaves++] = tree[root].right;
+        while(t.num_leaves < treelet_size)
+        {
+          std::size_t largest = treelet_size;
+          Scalar largest_area = -1;
+          for(std::size_t k = 0; k < t.num_leaves; ++k)
+          {
+            Scalar area = half_area(tree[t.leaves[k]].bounds);
+            if(t.leaves[k] < n - 1 && area > largest_area)
+            {
+              largest = k;
+              largest_area = area;
+            }
+          }
+          if(largest == treelet_size)
+            break;
+          auto inner = t.leaves[largest];
+          t.inner[t.num_inner++] = inner;
+          t.leaves[largest] = tree[inner].left;
+          t.leaves[t.num_leaves++] = tree[inner].right;
+        }
+        if(t.num_leaves < 3)
+          return;
+
+        //proper subsets of a subset are smaller numbers, so all subsets are visited after their parts,
+        //each partition is visited once with the lowest leaf in the first part
+        std::size_t full = (std::size_t(1) << t.num_leaves) - 1;
+        std::array<box3, 1 << treelet_size> bounds;
+        for(std::size_t subset = 1; subset <= full; ++subset)
+        {
+          std::size_t lowest = subset & (~subset + 1);
+          if(subset == lowest)
+          {
+            bounds[subset] = tree[t.leaves[bit_index(subset)]].bounds;
+            t.cost[subset] = tree[t.leaves[bit_index(subset)]].cost;
+            continue;
+          }
+          bounds[subset] = bounds[subset ^ lowest];
+          insert(bounds[subset], bounds[lowest]);
+
+          Scalar best_cost = std::numeric_limits<Scalar>::max();
+          std::size_t rest = subset ^ lowest;
+          for(std::size_t part = (rest - 1) & rest; ; part = (part - 1) & rest)
+          {
+            Scalar cost = t.cost[part | lowest] + t.cost[rest ^ part];
+            if(cost < best_cost)
+            {
+              best_cost = cost;
+              t.split[subset] = static_cast<std::uint8_t>(part | lowest);
+            }
+            if(part == 0)
+              break;
+          }
+          t.cost[subset] = half_area(bounds[subset]) + best_cost;
+        }
+        if(!(t.cost[full] < tree[root].cost))
+          return;
+
+        std::size_t next_inner = 0;
+        rebuild_treelet(tree, t, full, root, next_inner);
+      }
+
+      static std::size_t bit_index(std::size_t single_bit)
+      {
+        std::size_t k = 0;
+        while(single_bit >>= 1)
+          ++k;
+        return k;
+      }
+
+      static void rebuild_treelet(std::vector<radix_node>& tree, const treelet& t, std::size_t subset,
+        std::uint32_t index, std::size_t& next_inner)
+      {
+        std::size_t parts[2] = {t.split[subset], subset ^ t.split[subset]};
+        std::uint32_t children[2];
+        for(std::size_t c = 0; c < 2; ++c)
+        {
+          if((parts[c] & (parts[c] - 1)) == 0)
+            children[c] = t.leaves[bit_index(parts[c])];
+          else
+          {
+            children[c] = t.inner[next_inner++];
+            rebuild_treelet(tree, t, parts[c], children[c], next_inner);
+          }
+          tree[children[c]].parent = index;
+        }
+        tree[index].left = children[0];
+        tree[index].right = children[1];
+        update_radix_node(tree, index);
+      }
+
+      //emits the radix tree depth first, subtrees are collapsed into leaves if that is cheaper
+      //and the primitives are reordered to the order of the leaves
+      void emit_radix_tree(const std::vector<radix_node>& tree, std::vector<primitive>& prims,
+        const std::vector<std::uint32_t>& order, std::uint32_t n, std::size_t max_leaf_size)
+      {
+        struct entry
+        {
+          std::uint32_t index;
+          std::uint32_t parent;
+          std::size_t depth;
+        };
+        std::vector<primitive> sorted_prims;
+        sorted_prims.reserve(n);
+        std::vector<entry> stack(1, entry{0, invalid_index, 0});
+        std::vector<std::uint32_t> subtree;
+        depth_ = 0;
+        while(!stack.empty())
+        {
+          auto e = stack.back();
+          stack.pop_back();
+          depth_ = std::max(depth_, e.depth);
+          auto flat_index = static_cast<std::uint32_t>(nodes_.size());
+          if(e.parent != invalid_index)
+            nodes_[e.parent].offset = flat_index;
+
+          const auto& nd = tree[e.index];
+          bool is_leaf = e.index >= n - 1;
+          if(is_leaf || (nd.count <= max_leaf_size && nd.count * half_area(nd.bounds) <= nd.cost))
+          {
+            nodes_.push_back(node{nd.bounds, static_cast<std::uint32_t>(sorted_prims.size()),
+              static_cast<std::uint16_t>(nd.count), 0});
+            subtree.assign(1, e.index);
+            while(!subtree.empty())
+            {
+              auto index = subtree.back();
+              subtree.pop_back();
+              if(index >= n - 1)
+                sorted_prims.push_back(prims[order[index - (n - 1)]]);
+              else
+              {
+                subtree.push_back(tree[index].right);
+                subtree.push_back(tree[index].left);
+              }
+            }
+            continue;
+          }
+
+          //the child on the lower side of the axis separating the children best is visited first
+          auto d = tree[nd.right].bounds.center() - tree[nd.left].bounds.center();
+          std::uint16_t axis = 0;
+          for(std::uint16_t j = 1; j < 3; ++j)
+            if(std::abs(d[j]) > std::abs(d[axis]))
+              axis = j;
+          auto first = nd.left;
+          auto second = nd.right;
+          if(d[axis] < 0)
+            std::swap(first, second);
+          nodes_.push_back(node{nd.bounds, 0, 0, axis});
+          stack.push_back(entry{second, flat_index, e.depth + 1});
+          stack.push_back(entry{first, invalid_index, e.depth + 1});
+        }
+        prims.swap(sorted_prims);
+      }
+
+      //partitions the primitives at the cheapest bin boundary and returns the partition point,
+      //returns first if a leaf is cheaper than any split
+      std::size_t split_sah(std::vector<primitive>& prims, std::size_t first, std::size_t last, const box3& bounds,
+        const box3& centroid_bounds, std::size_t max_leaf_size, std::size_t& best_axis) const
+      {
+        std::size_t n = last - first;
+        Scalar best_cost = std::numeric_limits<Scalar>::max();
+        std::size_t best_bin = 0;
+        for(std::size_t axis = 0; axis < 3; ++axis)
+        {
+          Scalar lo = centroid_bounds.lower_bound[axis];
+          Scalar extent = centroid_bounds.upper_bound[axis] - lo;
+          if(!(extent > 0))
+            continue;
+          Scalar scale = num_bins / extent;
+
+          std::array<box3, num_bins> bin_bounds;
+          std::array<std::size_t, num_bins> bin_counts = {};
+          for(std::size_t i = first; i < last; ++i)
+          {
+            auto b = std::min(num_bins - 1, static_cast<std::size_t>((prims[i].centroid[axis] - lo) * scale));
+            ++bin_counts[b];
+            insert(bin_bounds[b], prims[i].bounds);
+          }
+
+          std::array<Scalar, num_bins> right_costs;
+          box3 right_bounds;
+          std::size_t right_count = 0;
+          for(std::size_t b = num_bins - 1; b > 0; --b)
+          {
+            right_count += bin_counts[b];
+            if(bin_counts[b] > 0)
+              insert(right_bounds, bin_bounds[b]);
+            right_costs[b] = right_count > 0 ? right_count * half_area(right_bounds) : 0;
+          }
+
+          box3 left_bounds;
+          std::size_t left_count = 0;
+          for(std::size_t b = 1; b < num_bins; ++b)
+          {
+            left_count += bin_counts[b - 1];
+            if(bin_counts[b - 1] > 0)
+              insert(left_bounds, bin_bounds[b - 1]);
+            if(left_count == 0 || left_count == n)
+              continue;
+            Scalar cost = left_count * half_area(left_bounds) + right_costs[b];
+            if(cost < best_cost)
+            {
+              best_cost = cost;
+              best_axis = axis;
+              best_bin = b;
+            }
+          }
+        }
+
+        //costs relative to one triangle test, a traversal step is about as expensive
+        if(best_bin == 0 || (n <= max_leaf_size && n * half_area(bounds) <= half_area(bounds) + best_cost))
+          return first;
+
+        Scalar lo = centroid_bounds.lower_bound[best_axis];
+        Scalar scale = num_bins / (centroid_bounds.upper_bound[best_axis] - lo);
+        auto it = std::partition(prims.begin() + first, prims.begin() + last, [&](const primitive& p)
+          {
+            return std::min(num_bins - 1, static_cast<std::size_t>((p.centroid[best_axis] - lo) * scale)) < best_bin;
+          });
+        return static_cast<std::size_t>(it - prims.begin());
+      }
+
+      //same as the moeller trumbore test of ray.hpp on the precomputed edges
+      static bool intersect(const ray3& r, const triangle& tri, Scalar t_min, Scalar t_max, Scalar& t, Scalar& u, Scalar& v)
+      {
+        const auto& d = r.direction();
+        const auto& e1 = tri[1];
+        const auto& e2 = tri[2];
+        Scalar p[3] = {d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0]};
+        Scalar det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+        if(det == 0)
+          return false;
+        Scalar inv_det = Scalar(1) / det;
+        Scalar s[3] = {r.origin[0] - tri[0][0], r.origin[1] - tri[0][1], r.origin[2] - tri[0][2]};
+        u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inv_det;
+        if(u < 0 || u > 1)
+          return false;
+        Scalar q[3] = {s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0]};
+        v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inv_det;
+        if(v < 0 || u + v > 1)
+          return false;
+        t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inv_det;
+        return t > t_min && t < t_max;
+      }
+
+      //traverses the rays together, the children of a node are visited in the order of the first ray
+      template <bool AnyHit>
+      void traverse(const ray3* rays, std::size_t n, hit* hits, Scalar t_min, Scalar t_max) const
+      {
+        std::array<Scalar, packet_size> t_far;
+        std::array<bool, packet_size> active;
+        std::size_t num_done = 0;
+        for(std::size_t i = 0; i < n; ++i)
+        {
+          hits[i] = hit();
+          t_far[i] = t_max;
+        }
+        if(empty())
+          return;
+
+        std::array<std::uint32_t, stack_size> small_stack;
+        std::vector<std::uint32_t> large_stack;
+        std::uint32_t* stack = small_stack.data();
+        if(depth_ > stack_size)
+        {
+          large_stack.resize(depth_);
+          stack = large_stack.data();
+        }
+        std::size_t stack_top = 0;
+        std::uint32_t index = 0;
+        while(true)
+        {
+          const node& nd = nodes_[index];
+          bool any_active = false;
+          for(std::size_t i = 0; i < n; ++i)
+          {
+            Scalar t0 = t_min;
+            Scalar t1 = t_far[i];
+            active[i] = (!AnyHit || !hits[i].is_valid()) && math::intersect(rays[i], nd.bounds, t0, t1);
+            any_active |= active[i];
+          }
+
+          if(any_active)
+          {
+            if(!nd.is_leaf())
+            {
+              if(rays[0].direction()[nd.axis] < 0)
+              {
+                stack[stack_top++] = index + 1;
+                index = nd.offset;
+              }
+              else
+              {
+                stack[stack_top++] = nd.offset;
+                index = index + 1;
+              }
+              continue;
+            }
+
+            for(std::size_t j = nd.offset; j < nd.offset + nd.count; ++j)
+            {
+              const auto& tri = triangles_[j];
+              for(std::size_t i = 0; i < n; ++i)
+              {
+                Scalar t, u, v;
+                if(!active[i] || !intersect(rays[i], tri, t_min, t_far[i], t, u, v))
+                  continue;
+                t_far[i] = t;
+                hits[i].face = faces_[j];
+                hits[i].t = t;
+                hits[i].u = u;
+                hits[i].v = v;
+                if(AnyHit)
+                {
+                  active[i] = false;
+                  ++num_done;
+                }
+              }
+              if(AnyHit && num_done == n)
+                return;
+            }
+          }
+
+          if(stack_top == 0)
+            return;
+          index = stack[--stack_top];
+        }
+      }
+
+      //calls fn(first, n) for packets of n <= packet_size consecutive rays in parallel
+      template <typename Fn>
+      static void for_each_packet(std::size_t num_rays, Fn&& fn)
+      {
+        std::size_t num_packets = (num_rays + packet_size - 1) / packet_size;
+        utils::parallel_for_blocks(std::size_t(0), num_packets, 64, [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t p = first; p < last; ++p)
+              fn(p * packet_size, std::min(packet_size, num_rays - p * packet_size));
+          });
+      }
+
+      std::vector<node> nodes_;
+      std::vector<triangle> triangles_;
+      std::vector<face_handle> faces_;
+      std::size_t depth_ = 0;
+    };
+  }
+}
@@ -9,7 +9,10 @@
 
 #pragma once
 
-#include <stack>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <numeric>
 
 #include "owl/utils/handle.hpp"
 #include "owl/utils/dynamic_properties.hpp"
@@ -25,24 +28,33 @@
 #include "owl/math/constants.hpp"
 #include "owl/color/color.hpp"
 #include "owl/math/line_segment.hpp"
-//#include "owl/utils/progress.hpp"
+#include "owl/utils/parallel.hpp"
+#include "owl/utils/profiler.hpp"
+#include "owl/utils/progress.hpp"
+#include "owl/utils/union_find.hpp"
 
 namespace owl
 {
   namespace math
   {
   
+#ifdef OWL_MESH_32BIT_INDICES
+    using mesh_index = std::uint32_t;
+#else
+    using mesh_index = std::size_t;
+#endif
+  
     struct vertex_tag{};
-    using vertex_handle = owl::utils::handle<vertex_tag>;
+    using vertex_handle = owl::utils::handle<vertex_tag, mesh_index>;
   
     struct halfedge_tag{};
-    using halfedge_handle = owl::utils::handle<halfedge_tag>;
+    using halfedge_handle = owl::utils::handle<halfedge_tag, mesh_index>;
   
     struct edge_tag{};
-    using edge_handle = owl::utils::handle<edge_tag>;
+    using edge_handle = owl::utils::handle<edge_tag, mesh_index>;
   
     struct face_tag{};
-    using face_handle = owl::utils::handle<face_tag>;
+    using face_handle = owl::utils::handle<face_tag, mesh_index>;
  
   
     template <typename T>
@@ -58,6 +70,7 @@ namespace owl
     using face_property_handle = owl::utils::indexed_property_handle<T,face_tag>;
   
 
+    //one byte of status bits per element
     class status_flags
     {
     public:
@@ -67,46 +80,68 @@ namespace owl
     
       bool is_removed() const
       {
-        return bits_.test(0);
+        return test(removed_bit);
       }
   
       void remove()
       {
-        bits_.set(0, true);
+        set(removed_bit, true);
       }
     
       void restore()
       {
-        bits_.set(0, false);
+        set(removed_bit, false);
       }
     
       bool is_selected() const
       {
-        return bits_.test(1);
+        return test(selected_bit);
       }
   
       void select()
       {
-        bits_.set(1, true);
+        set(selected_bit, true);
       }
   
       void deselect()
       {
-        bits_.set(1, false);
+        set(selected_bit, false);
       }
   
       void invert_selection()
       {
-        if(is_selected())
-          deselect();
-        else
-          select();
+        bits_ ^= selected_bit;
       }
     
     private:
-      std::bitset<8> bits_;
+      enum : std::uint8_t { removed_bit = 1, selected_bit = 2 };
+    
+      bool test(std::uint8_t bit) const
+      {
+        return (bits_ & bit) != 0;
+      }
+    
+      void set(std::uint8_t bit, bool value)
+      {
+        bits_ = value ? std::uint8_t(bits_ | bit) : std::uint8_t(bits_ & ~bit);
+      }
+    
+      std::uint8_t bits_;
     };
-  
+
+    //weighting of the sector normals around a vertex when computing its normal
+    enum class normal_weighting
+    {
+      area, //weighted by the area of the triangle spanned by the sector
+      angle //weighted by the interior angle of the sector
+    };
+
+    namespace detail
+    {
+      template <typename Scalar>
+      struct mesh_snapshot;
+    }
+
     template <typename Scalar>
     class mesh
     {
@@ -198,10 +233,10 @@ namespace owl
 
         auto deref = [this](halfedge_handle he)
         {
-          return target(he);
+          return origin(he);
         };
       
-        return make_handle_range(incoming(v), step, deref);
+        return utils::make_handle_circulator_range(incoming(v), step, deref);
       }
     
       auto incoming_halfedges(vertex_handle v) const
@@ -305,6 +340,17 @@ namespace owl
         return vertex_properties_[vertex_position_handle_][v.index()];
       }
 
+      //contiguous storage of all vertex positions indexed by vertex index
+      const vector3* position_data() const
+      {
+        return vertex_properties_[vertex_position_handle_].data();
+      }
+
+      vector3* position_data()
+      {
+        return vertex_properties_[vertex_position_handle_].data();
+      }
+
       const vector2& texcoord(halfedge_handle he) const
       {
         return halfedge_properties_[halfedge_texcoord_handle_][he.index()];
@@ -345,50 +391,44 @@ namespace owl
         return halfedge_properties_[halfedge_normal_handle_][he.index()];
       }
 
-      template<typename Handle>
-      status_flags& status(Handle h)
-      {
-        return operator[](h);
-      }
-    
       const vertex_handle& target(halfedge_handle he) const
       {
-        return operator[](he).target;
+        return halfedge_target_[he.index()];
       }
     
       vertex_handle& target(halfedge_handle he)
       {
-        return operator[](he).target;
+        return halfedge_target_[he.index()];
       }
     
       const vertex_handle& origin(halfedge_handle he) const
       {
-        return operator[](opposite(he)).target;
+        return target(opposite(he));
       }
     
       vertex_handle& origin(halfedge_handle he)
       {
-        return operator[](opposite(he)).target;
+        return target(opposite(he));
       }
     
       const vertex_handle& target(edge_handle e) const
       {
-        return operator[](halfedge(e)).target;
+        return target(halfedge(e));
       }
     
       vertex_handle& target(edge_handle e)
       {
-        return operator[](halfedge(e)).target;
+        return target(halfedge(e));
       }
     
       const vertex_handle& origin(edge_handle e) const
       {
-        return operator[](opposite(halfedge(e))).target;
+        return target(opposite(halfedge(e)));
       }
     
       vertex_handle& origin(edge_handle e)
       {
-        return operator[](opposite(halfedge(e))).target;
+        return target(opposite(halfedge(e)));
       }
     
       template<typename Handle>
@@ -478,12 +518,12 @@ namespace owl
     
       std::size_t num_vertices() const
       {
-        return vertices_.size();
+        return vertex_incoming_.size();
       }
     
       std::size_t num_edges() const
       {
-        return edges_.size();
+        return edge_status_.size();
       }
 
       std::size_t num_halfedges() const
@@ -493,12 +533,12 @@ namespace owl
     
       std::size_t num_faces() const
       {
-        return faces_.size();
+        return face_halfedge_.size();
       }
     
       std::size_t num_n_gons(std::size_t n) const
       {
-        return utils::count_if(faces(),
+        return utils::count_if(utils::execution::par, faces(),
           [this,n](face_handle f)
           {
             return is_n_gon(f, n);
@@ -566,32 +606,42 @@ namespace owl
   
       const status_flags& status(vertex_handle v) const
       {
-        return vertices_[v.index()].status;
+        return vertex_status_[v.index()];
       }
     
       status_flags& status(vertex_handle v)
       {
-        return vertices_[v.index()].status;
+        return vertex_status_[v.index()];
       }
     
       const status_flags& status(face_handle f) const
       {
-        return faces_[f.index()].status;
+        return face_status_[f.index()];
       }
     
       status_flags& status(face_handle f)
       {
-        return faces_[f.index()].status;
+        return face_status_[f.index()];
       }
     
       const status_flags& status(edge_handle e) const
       {
-        return edges_[e.index()].status;
+        return edge_status_[e.index()];
       }
     
       status_flags& status(edge_handle e)
       {
-        return edges_[e.index()].status;
+        return edge_status_[e.index()];
+      }
+    
+      const status_flags& status(halfedge_handle he) const
+      {
+        return halfedge_status_[he.index()];
+      }
+    
+      status_flags& status(halfedge_handle he)
+      {
+        return halfedge_status_[he.index()];
       }
     
       bool is_sharp(edge_handle e, const angle& max_angle = degrees<scalar>(44)) const
@@ -650,10 +700,10 @@ namespace owl
          if(incoming(vold) == he)
           incoming(vold) = he_new_opp;
       
-        next(he_opp_prev) = he_new;
-        next(he_new_opp) = next(he);
-        next(he) = he_new_opp;
-        next(he_new) = he_opp;
+        set_next(he_opp_prev, he_new);
+        set_next(he_new_opp, next(he));
+        set_next(he, he_new_opp);
+        set_next(he_new, he_opp);
       
         target(he) = v;
         face(he_new) = face(he_opp);
@@ -666,45 +716,64 @@ namespace owl
         return he_new;
       }
     
+      //splits all edges at their centroid and returns the range of the new edges,
+      //stops early if the current progress is cancelled
       auto split_edges()
       {
-        auto first = edge_handle{num_edges()};
+        auto first = edge_handle(num_edges());
+        utils::progress splitting(num_edges());
         for(auto e : edges())
         {
+          if(e.index() % progress_step_size == 0 && e.index() > 0 && !splitting.step(progress_step_size))
+            break;
           auto pos = centroid(e);
           split(e, pos);
         }
-        return make_counting_range(first, edge_handle{num_edges()});
+        return make_counting_range(first, edge_handle(num_edges()));
       }
     
       void reserve_vertices(std::size_t n)
       {
-        vertices_.reserve(n);
+        vertex_incoming_.reserve(n);
+        vertex_status_.reserve(n);
         vertex_properties_.reserve(n);
       }
     
       void reserve_edges(std::size_t n)
       {
-        edges_.reserve(n);
+        if(has_stored_prev())
+          halfedge_prev_.reserve(2 * n);
+        halfedge_next_.reserve(2 * n);
+        halfedge_target_.reserve(2 * n);
+        halfedge_face_.reserve(2 * n);
+        halfedge_status_.reserve(2 * n);
+        edge_status_.reserve(n);
         edge_properties_.reserve(n);
         halfedge_properties_.reserve(2 * n);
       }
     
       void reserve_faces(std::size_t n)
       {
-        faces_.reserve(n);
+        face_halfedge_.reserve(n);
+        face_status_.reserve(n);
         face_properties_.reserve(n);
       }
     
-      void subdivide_quad_split()
+      //returns false if the subdivision was cancelled, the mesh is then only partially subdivided
+      bool subdivide_quad_split()
       {
         assert(is_quad_mesh());
         reserve_vertices(num_vertices() + num_faces());
         reserve_edges(2 * num_edges() + 4 * num_faces());
         reserve_faces(4 * num_faces());
       
-        std::size_t num_vertices_old = vertices_.size();
+        utils::progress subdividing(num_edges() + num_faces());
+        std::size_t num_vertices_old = num_vertices();
+        subdividing.make_current(num_edges());
         split_edges();
+        subdividing.resign_current();
+        if(subdividing.is_cancelled())
+          return false;
       
         auto is_old_vertex = [&](vertex_handle v)
           {
@@ -713,6 +782,8 @@ namespace owl
       
         for(auto f : faces())
         {
+          if(f.index() % progress_step_size == 0 && f.index() > 0 && !subdividing.step(progress_step_size))
+            return false;
           auto he_prev = inner(f);
           if(is_old_vertex(target(he_prev)))
             he_prev = next(he_prev);
@@ -729,18 +800,26 @@ namespace owl
           }
           insert_edge(he_prev,he_next);
         }
+        return true;
       }
     
-      void subdivide_triangle_split()
+      //returns false if the subdivision was cancelled, the mesh is then only partially subdivided
+      bool subdivide_triangle_split()
       {
+        OWL_PROFILE_SCOPE("mesh::subdivide_triangle_split");
         assert(is_triangle_mesh());
       
         reserve_vertices(num_vertices() + num_edges());
         reserve_faces(4 * num_faces());
         reserve_edges(2 * num_edges() + 3 * num_faces());
   
-        std::size_t num_vertices_old = vertices_.size();
+        utils::progress subdividing(num_edges() + num_faces());
+        std::size_t num_vertices_old = num_vertices();
+        subdividing.make_current(num_edges());
         split_edges();
+        subdividing.resign_current();
+        if(subdividing.is_cancelled())
+          return false;
       
         auto is_old_vertex = [&](vertex_handle v)
           {
@@ -749,6 +828,8 @@ namespace owl
       
         for(auto f : faces())
         {
+          if(f.index() % progress_step_size == 0 && f.index() > 0 && !subdividing.step(progress_step_size))
+            return false;
           auto he_prev = inner(f);
           if(is_old_vertex(target(he_prev)))
             he_prev = next(he_prev);
@@ -762,11 +843,36 @@ namespace owl
           he_next = next(next(he_next));
           insert_edge(he_prev, he_next);
         }
+        return true;
+      }
+    
+      //catmull-clark subdivision of a polygon mesh, each level replaces every n-gon by n quads and moves the
+      //vertices by the smoothing rules, boundaries are refined as cubic b-spline curves.
+      //the connectivity of each level is computed directly from the element indices of the previous level into
+      //a new mesh and the positions are computed in parallel, all other properties are discarded.
+      //removed elements have to be erased by garbage_collection() first.
+      //returns false if the subdivision was cancelled, the mesh is then unchanged
+      bool subdivide_catmull_clark(std::size_t levels = 1)
+      {
+        OWL_PROFILE_FUNCTION();
+        return subdivide_out_of_place(levels, [](const mesh& m, mesh& result){ m.catmull_clark_level(result); });
+      }
+    
+      //loop subdivision of a triangle mesh, each level splits every triangle into four and moves the vertices
+      //by the smoothing rules, boundaries are refined as cubic b-spline curves.
+      //like subdivide_catmull_clark() the levels are built out of place and only positions are kept.
+      //returns false if the subdivision was cancelled, the mesh is then unchanged
+      bool subdivide_loop(std::size_t levels = 1)
+      {
+        OWL_PROFILE_FUNCTION();
+        assert(is_triangle_mesh());
+        return subdivide_out_of_place(levels, [](const mesh& m, mesh& result){ m.loop_level(result); });
       }
     
       face_handle create_face(halfedge_handle he)
       {
-        faces_.emplace_back(he);
+        face_halfedge_.push_back(he);
+        face_status_.emplace_back();
         return face_properties_.add_elem();
       }
     
@@ -783,10 +889,10 @@ namespace owl
         auto he_next_prev = prev(he_next);
         face(he_opp) = face(he_prev);
         inner(fold) = he_opp;
-        next(he_opp) = next(he_prev);
-        next(he_prev) = he;
-        next(he) = he_next;
-        next(he_next_prev) = he_opp;
+        set_next(he_opp, next(he_prev));
+        set_next(he_prev, he);
+        set_next(he, he_next);
+        set_next(he_next_prev, he_opp);
       
         auto f_new = create_face(he);
         face(he) = f_new;
@@ -838,19 +944,19 @@ namespace owl
           split(he, centroid(he));
           auto e = add_edge(target(he), v);
           edges_new.push_back(e);
-          next(opposite(halfedge(e))) = next(he);
-          next(he) = halfedge(e);
+          set_next(opposite(halfedge(e)), next(he));
+          set_next(he, halfedge(e));
         }
       
         for(auto e : utils::make_adjacent_range(edges_new))
         {
           auto he2 = halfedge(e.current);
-          if(f == faces_.size())
+          if(f == num_faces())
             create_face(he2);
           else
             inner(f) = he2;
           auto he_start = he2;
-          next(he2) = opposite(halfedge(e.prev));
+          set_next(he2, opposite(halfedge(e.prev)));
           do
           {
             face(he2) = f;
@@ -858,7 +964,7 @@ namespace owl
           }
           while(he2 != he_start);
         
-          f = faces_.size();
+          f = num_faces();
         
         }
         incoming(v) = halfedge(edges_new.front());
@@ -935,47 +1041,78 @@ namespace owl
         return compute_loop_normal(inner(f));
       }
     
-      vector3 compute_vertex_normal(vertex_handle v) const
+      //sums the sector normals of the faces around v, the sector normal of a triangle is twice its area
+      vector3 compute_vertex_normal(vertex_handle v, normal_weighting weighting = normal_weighting::area) const
       {
         auto nml = vector3::zero();
-        if(v.index() == 217)
+        if(is_isolated(v))
           return nml;
         for(auto he : incoming_halfedges(v))
-          nml += compute_sector_normal(he, false);
-      
+        {
+          if(is_boundary(he))
+            continue;
+          auto sector_nml = compute_sector_normal(he, false);
+          if(weighting == normal_weighting::angle)
+          {
+            scalar len = sector_nml.length();
+            if(len == 0)
+              continue;
+            sector_nml *= std::atan2(len, dot(direction(next(he)), direction(opposite(he)))) / len;
+          }
+          nml += sector_nml;
+        }
         nml.normalize();
         return nml;
       }
-    
+
+      //computes the normals of all vertices in parallel, each vertex gathers the sectors around it
+      std::vector<vector3> compute_vertex_normals(normal_weighting weighting = normal_weighting::area) const
+      {
+        std::vector<vector3> nmls(num_vertices());
+        utils::parallel_for_blocks(std::size_t(0), num_vertices(), normal_block_size, [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t v = first; v < last; ++v)
+              nmls[v] = compute_vertex_normal(vertex_handle(v), weighting);
+          });
+        return nmls;
+      }
+
+      //computes the face normals in parallel, triangle meshes take a batched kernel
       void update_face_normals()
       {
-//        utils::progress progress(num_faces());
-        for(auto f : faces())
-        {
-          normal(f) = compute_face_normal(f);
-       //   progress.step();
-        }
+        OWL_PROFILE_SCOPE("mesh::update_face_normals");
+        bool triangles = is_triangle_mesh();
+        utils::parallel_for_blocks(std::size_t(0), num_faces(), normal_block_size, [&](std::size_t first, std::size_t last)
+          {
+            if(triangles)
+              update_triangle_normals(first, last);
+            else
+              for(std::size_t f = first; f < last; ++f)
+                normal(face_handle(f)) = compute_face_normal(face_handle(f));
+          });
       }
-    
-      void update_halfedge_normals(const angle& max_angle = degrees<scalar>(44))
+
+      //halfedges of sharp edges take the normal of their face, all others the normal of their target vertex
+      void update_halfedge_normals(const angle& max_angle = degrees<scalar>(44),
+        normal_weighting weighting = normal_weighting::area)
       {
-      //  utils::progress progress(num_halfedges());
-        for(auto he : halfedges())
-        {
-          normal(he) = is_sharp(he, max_angle) ? compute_loop_normal(he) : compute_vertex_normal(target(he));
-       //   progress.step();
-        }
+        OWL_PROFILE_SCOPE("mesh::update_halfedge_normals");
+        auto vertex_nmls = compute_vertex_normals(weighting);
+        utils::parallel_for_blocks(std::size_t(0), num_halfedges(), normal_block_size, [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t i = first; i < last; ++i)
+            {
+              halfedge_handle he(i);
+              normal(he) = is_sharp(he, max_angle) ? compute_loop_normal(he) : vertex_nmls[target(he).index()];
+            }
+          });
       }
-    
-      void update_normals(const angle& max_angle = degrees<scalar>(44))
+
+      void update_normals(const angle& max_angle = degrees<scalar>(44), normal_weighting weighting = normal_weighting::area)
       {
-   //     utils::progress progress(num_faces() + num_halfedges());
-      //  progress.make_current(num_faces());
+        OWL_PROFILE_SCOPE("mesh::update_normals");
         update_face_normals();
-    //    progress.resign_current();
-     //   progress.make_current(num_halfedges());
-        update_halfedge_normals(max_angle);
-     //   progress.resign_current();
+        update_halfedge_normals(max_angle, weighting);
       }
     
       template <typename Handle>
@@ -986,7 +1123,7 @@ namespace owl
 
       bool is_n_gon_mesh(std::size_t n) const
       {
-        return utils::all_of(faces(), [this,&n](face_handle f){ return is_n_gon(f, n); });
+        return utils::all_of(utils::execution::par, faces(), [this,&n](face_handle f){ return is_n_gon(f, n); });
       }
 
       bool is_quad_mesh() const
@@ -1023,23 +1160,23 @@ namespace owl
     
       void clear()
       {
-        faces_.clear();
+        resize_faces(0);
         face_properties_.clear();
-        edges_.clear();
+        resize_edges(0);
         edge_properties_.clear();
         halfedge_properties_.clear();
-        vertices_.clear();
+        resize_vertices(0);
         vertex_properties_.clear();
       }
     
       bool empty() const
       {
-        return faces_.empty() && vertices_.empty() && edges_.empty();
+        return num_faces() == 0 && num_vertices() == 0 && num_edges() == 0;
       }
     
       auto add_vertex()
       {
-        vertices_.emplace_back();
+        resize_vertices(num_vertices() + 1);
         return vertex_properties_.add_elem();
       }
     
@@ -1052,7 +1189,7 @@ namespace owl
     
       auto add_vertices(std::size_t n)
       {
-        vertices_.resize(num_vertices() + n);
+        resize_vertices(num_vertices() + n);
         return vertex_properties_.add_elems(n);
       }
     
@@ -1060,7 +1197,7 @@ namespace owl
       auto add_vertices(VectorRange&& points)
       {
         auto n = std::size(points);
-        vertices_.resize(num_vertices() + n);
+        resize_vertices(num_vertices() + n);
         auto verts = vertex_properties_.add_elems(n);
         owl::utils::copy(points, positions(verts).begin());
         return verts;
@@ -1078,6 +1215,7 @@ namespace owl
       template <typename VertexHandleRange, typename = std::enable_if_t<is_vertex_handle_range<VertexHandleRange>::value>>
       face_handle add_face(VertexHandleRange&& vertices)
       {
+        OWL_PROFILE_FINE_SCOPE("mesh::add_face");
         if(std::size(vertices) < 3)
         {
           std::cout << "not enough vertices" << std::endl;
@@ -1091,7 +1229,7 @@ namespace owl
           return face_handle::invalid();
         }
       
-        face_handle f = face_handle{faces_.size()};
+        face_handle f = face_handle(num_faces());
       
       
         std::vector<halfedge_handle> hes;
@@ -1106,7 +1244,9 @@ namespace owl
           {
             if(!is_boundary(he))
             {
-              edges_.resize(num_edges_old);
+              for(auto h : hes)
+                face(h) = face_handle::invalid();
+              resize_edges(num_edges_old);
               edge_properties_.resize(num_edges_old);
               halfedge_properties_.resize(num_edges_old * 2);
               return face_handle::invalid();
@@ -1124,9 +1264,9 @@ namespace owl
         
           if(is_isolated(v))
           {
-            next(he.current) = he.next;
+            set_next(he.current, he.next);
             auto temp = opposite(he.next);
-            next(temp) = opposite(he.current);
+            set_next(temp, opposite(he.current));
             incoming(v) = temp;
             continue;
           }
@@ -1148,16 +1288,16 @@ namespace owl
               auto he_gap = opposite(he.next);
               while(!is_boundary(he_gap))
                 he_gap = next_incoming(he_gap);
-              next(b) = next(he_gap);
-              next(he_gap) = a;
-              next(he.current) = he.next;
+              set_next(b, next(he_gap));
+              set_next(he_gap, a);
+              set_next(he.current, he.next);
               adjust_incoming(v);
             }
             else
             {
               auto temp = opposite(he.next);
-              next(temp) = next(he.current);
-              next(he.current) = he.next;
+              set_next(temp, next(he.current));
+              set_next(he.current, he.next);
               incoming(v) = temp;
             }
           }
@@ -1166,17 +1306,17 @@ namespace owl
             if(next(opposite(he.next)).is_valid())
             {
               auto b = prev_circ(he.next);
-              next(b) = opposite(he.current);
-              next(he.current) = he.next;
+              set_next(b, opposite(he.current));
+              set_next(he.current, he.next);
               adjust_incoming(v);
             }
             else //both invalid
             {
               auto he_gap = incoming(v);
               assert(is_boundary(he_gap));
-              next(opposite(he.next)) = next(he_gap);
-              next(he_gap) = opposite(he.current);
-              next(he.current) = he.next;
+              set_next(opposite(he.next), next(he_gap));
+              set_next(he_gap, opposite(he.current));
+              set_next(he.current, he.next);
               adjust_incoming(v);
             }
           }
@@ -1184,7 +1324,198 @@ namespace owl
   
         return f;
       }
-    
+
+      //builds the whole mesh from flat arrays, face f is given by the vertex indices
+      //face_indices[face_offsets[f]], ..., face_indices[face_offsets[f + 1] - 1]
+      //returns false if the faces do not form an oriented 2-manifold, the mesh then only contains the vertices
+      template <typename VectorRange, typename OffsetRange, typename IndexRange,
+        typename = std::enable_if_t<is_vector_range<VectorRange>::value>>
+      bool build(VectorRange&& positions, const OffsetRange& face_offsets, const IndexRange& face_indices)
+      {
+        OWL_PROFILE_SCOPE("mesh::build");
+        clear();
+        add_vertices(std::forward<VectorRange>(positions));
+        return build_faces(face_offsets, face_indices);
+      }
+
+      //creates the connectivity of all faces at once without any find_halfedge calls,
+      //twins are matched by grouping all corners by their (min,max) vertex index pair
+      //requires a mesh without faces and edges, returns false and leaves the mesh unchanged
+      //if the faces do not form an oriented 2-manifold
+      template <typename OffsetRange, typename IndexRange>
+      bool build_faces(const OffsetRange& face_offsets, const IndexRange& face_indices)
+      {
+        if(num_edges() != 0 || num_faces() != 0)
+          return false;
+        if(std::size(face_offsets) < 2)
+          return true;
+
+        const std::size_t nv = num_vertices();
+        const std::size_t nf = std::size(face_offsets) - 1;
+        const std::size_t first_corner = static_cast<std::size_t>(*std::begin(face_offsets));
+        const std::size_t last_corner = static_cast<std::size_t>(*std::prev(std::end(face_offsets)));
+        if(last_corner < first_corner || last_corner > std::size(face_indices))
+          return false;
+
+        auto offset = [&face_offsets](std::size_t f){ return static_cast<std::size_t>(std::begin(face_offsets)[f]); };
+        auto index = [&face_indices](std::size_t c){ return static_cast<std::size_t>(std::begin(face_indices)[c]); };
+        const std::size_t nc = last_corner - first_corner;
+        constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+        //origin vertex of each corner, the halfedge of corner c points from origin[c] to index(c)
+        std::vector<std::size_t> origin(nc);
+        for(std::size_t f = 0; f < nf; ++f)
+        {
+          std::size_t first = offset(f), last = offset(f + 1);
+          if(last < first + 3 || first < first_corner || last > last_corner)
+            return false;
+          for(std::size_t c = first; c < last; ++c)
+          {
+            std::size_t from = index(c == first ? last - 1 : c - 1);
+            std::size_t to = index(c);
+            if(from >= nv || to >= nv || from == to)
+              return false;
+            origin[c - first_corner] = from;
+          }
+        }
+
+        //bucket the corners by the smaller vertex of their edge, then sort each short bucket by the larger one
+        struct corner_key
+        {
+          std::size_t hi, corner;
+        };
+        std::vector<std::size_t> bucket_begin(nv + 1, 0);
+        for(std::size_t c = 0; c < nc; ++c)
+          ++bucket_begin[std::min(origin[c], index(c + first_corner)) + 1];
+        for(std::size_t v = 0; v < nv; ++v)
+          bucket_begin[v + 1] += bucket_begin[v];
+        std::vector<corner_key> keys(nc);
+        {
+          std::vector<std::size_t> fill(bucket_begin.begin(), bucket_begin.end() - 1);
+          for(std::size_t c = 0; c < nc; ++c)
+          {
+            std::size_t from = origin[c], to = index(c + first_corner);
+            keys[fill[std::min(from, to)]++] = corner_key{std::max(from, to), c};
+          }
+        }
+
+        std::vector<std::size_t> twin(nc, none);
+        for(std::size_t v = 0; v < nv; ++v)
+        {
+          auto first = keys.begin() + bucket_begin[v], last = keys.begin() + bucket_begin[v + 1];
+          std::sort(first, last, [](const corner_key& a, const corner_key& b)
+            {
+              return a.hi < b.hi || (a.hi == b.hi && a.corner < b.corner);
+            });
+          for(auto it = first; it != last;)
+          {
+            auto jt = std::next(it);
+            while(jt != last && jt->hi == it->hi)
+              ++jt;
+            if(jt - it > 2)
+              return false;
+            if(jt - it == 2)
+            {
+              std::size_t a = it->corner, b = std::next(it)->corner;
+              if(origin[a] == origin[b])
+                return false;
+              twin[a] = b;
+              twin[b] = a;
+            }
+            it = jt;
+          }
+        }
+        keys = std::vector<corner_key>();
+        bucket_begin = std::vector<std::size_t>();
+
+        //edges are numbered in order of their first corner, the halfedge of the first corner is the even one
+        std::vector<std::size_t> corner_halfedge(nc);
+        std::size_t ne = 0;
+        for(std::size_t c = 0; c < nc; ++c)
+        {
+          if(twin[c] != none && twin[c] < c)
+            continue;
+          corner_halfedge[c] = 2 * ne;
+          if(twin[c] != none)
+            corner_halfedge[twin[c]] = 2 * ne + 1;
+          ++ne;
+        }
+
+        std::vector<halfedge_handle> next(2 * ne), face_halfedge(nf), incoming(nv);
+        std::vector<vertex_handle> target(2 * ne);
+        std::vector<face_handle> face(2 * ne);
+        std::vector<std::size_t> valence(nv, 0);
+
+        for(std::size_t f = 0; f < nf; ++f)
+        {
+          std::size_t first = offset(f) - first_corner, last = offset(f + 1) - first_corner;
+          face_halfedge[f] = halfedge_handle(corner_halfedge[first]);
+          for(std::size_t c = first; c < last; ++c)
+          {
+            std::size_t he = corner_halfedge[c];
+            std::size_t to = index(c + first_corner);
+            target[he] = vertex_handle(to);
+            face[he] = face_handle(f);
+            next[he] = halfedge_handle(corner_halfedge[c + 1 == last ? first : c + 1]);
+            if(twin[c] == none)
+            {
+              target[he ^ 1] = vertex_handle(origin[c]);
+              ++valence[origin[c]];
+              //boundary halfedges become the incoming halfedge of their target
+              auto& in = incoming[origin[c]];
+              if(in.is_valid() && !face[in.index()].is_valid())
+                return false;
+              in = halfedge_handle(he ^ 1);
+            }
+            ++valence[to];
+            if(!incoming[to].is_valid())
+              incoming[to] = halfedge_handle(he);
+          }
+        }
+
+        //the boundary halfedge entering a vertex continues with the boundary halfedge leaving it,
+        //both are unique as every vertex has as many incoming as outgoing boundary halfedges
+        std::vector<std::size_t> boundary_outgoing(nv, none);
+        for(std::size_t c = 0; c < nc; ++c)
+          if(twin[c] == none)
+            boundary_outgoing[index(c + first_corner)] = corner_halfedge[c] ^ 1;
+        for(std::size_t c = 0; c < nc; ++c)
+          if(twin[c] == none)
+            next[corner_halfedge[c] ^ 1] = halfedge_handle(boundary_outgoing[origin[c]]);
+
+        //each vertex must have a single fan containing all of its incoming halfedges
+        for(std::size_t v = 0; v < nv; ++v)
+        {
+          if(!incoming[v].is_valid())
+            continue;
+          std::size_t he = incoming[v].index();
+          std::size_t n = 0;
+          do
+          {
+            he = next[he].index() ^ 1;
+            ++n;
+          } while(he != incoming[v].index() && n <= valence[v]);
+          if(n != valence[v])
+            return false;
+        }
+
+        halfedge_next_ = std::move(next);
+        halfedge_target_ = std::move(target);
+        halfedge_face_ = std::move(face);
+        vertex_incoming_ = std::move(incoming);
+        face_halfedge_ = std::move(face_halfedge);
+        halfedge_status_.assign(2 * ne, status_flags());
+        edge_status_.assign(ne, status_flags());
+        face_status_.assign(nf, status_flags());
+        vertex_status_.assign(nv, status_flags());
+        edge_properties_.resize(ne);
+        halfedge_properties_.resize(2 * ne);
+        face_properties_.resize(nf);
+        if(has_stored_prev())
+          store_prev();
+        return true;
+      }
+
       bool is_flipable(edge_handle e) const
       {
         if (is_boundary(e))
@@ -1217,12 +1548,12 @@ namespace owl
         auto v3 = target(he1);
         auto v4 = target(he2);
       
-        next(p1) = n2;
-        next(p2) = n1;
-        next(n2) = he2;
-        next(n1) = he1;
-        next(he1) = p2;
-        next(he2) = p1;
+        set_next(p1, n2);
+        set_next(p2, n1);
+        set_next(n2, he2);
+        set_next(n1, he1);
+        set_next(he1, p2);
+        set_next(he2, p1);
       
         face(p2) = f1;
         face(p1) = f2;
@@ -1238,6 +1569,78 @@ namespace owl
           incoming(v4) = p1;
       }
     
+      //checks the link condition of the collapse of he: the one rings of origin(he) and target(he) may only share
+      //the opposite vertices of the triangles of he, otherwise the collapse would create non manifold edges
+      bool is_collapsable(halfedge_handle he) const
+      {
+        auto he_opp = opposite(he);
+        auto v0 = origin(he);
+        auto v1 = target(he);
+        if(status(edge(he)).is_removed() || status(v0).is_removed() || status(v1).is_removed())
+          return false;
+    
+        //the opposite vertex of a triangle must not lose its last face
+        auto left = vertex_handle::invalid();
+        auto right = vertex_handle::invalid();
+        if(!is_boundary(he))
+        {
+          auto n = next(he);
+          if(is_triangle(face(he)))
+          {
+            left = target(n);
+            if(is_boundary(opposite(n)) && is_boundary(opposite(next(n))))
+              return false;
+          }
+        }
+        if(!is_boundary(he_opp))
+        {
+          auto n = next(he_opp);
+          if(is_triangle(face(he_opp)))
+          {
+            right = target(n);
+            if(is_boundary(opposite(n)) && is_boundary(opposite(next(n))))
+              return false;
+          }
+        }
+        if(left == right)
+          return false;
+        //an inner opposite vertex of valence 3 would be left with two faces sharing two edges, e.g. on a tetrahedron
+        for(auto v : {left, right})
+          if(v.is_valid() && !is_boundary(v) && valence(v) == 3)
+            return false;
+    
+        //an inner edge between two boundary vertices would pinch the mesh
+        if(is_boundary(v0) && is_boundary(v1) && !is_boundary(edge(he)))
+          return false;
+    
+        //one rings are short, a linear search is cheaper than marking
+        for(auto he0 : incoming_halfedges(v0))
+        {
+          auto v = origin(he0);
+          if(v == v1 || v == left || v == right)
+            continue;
+          for(auto he1 : incoming_halfedges(v1))
+            if(origin(he1) == v)
+              return false;
+        }
+        return true;
+      }
+    
+      //removes the edge of he by merging origin(he) into target(he), triangles of he degenerate and are removed
+      //as well. the removed elements are only marked, they are erased by garbage_collection()
+      void collapse(halfedge_handle he)
+      {
+        OWL_PROFILE_FINE_SCOPE("mesh::collapse");
+        assert(is_collapsable(he));
+        auto he_next = next(he);
+        auto he_opp_next = next(opposite(he));
+        collapse_edge(he);
+        if(next(next(he_next)) == he_next)
+          collapse_loop(next(he_next));
+        if(next(next(he_opp_next)) == he_opp_next)
+          collapse_loop(he_opp_next);
+      }
+    
     
       /*//mark vertex v and all incident faces and edges as removed
       void remove(vertex_handle v, bool remove_isolated_vertices)
@@ -1269,22 +1672,191 @@ namespace owl
     */
     
     
+      //marks all isolated vertices as removed, they are erased by the next garbage_collection()
       void remove_isolated_vertices()
       {
         for(auto v: vertices())
-          if(is_isolated(v) && !is_removed(v))
-            remove(v);
+          if(is_isolated(v))
+            status(v).remove();
       }
     
-      void erase_removed_vertices()
+      //maps the handles before a garbage collection to the handles after it,
+      //removed elements are mapped to invalid handles
+      struct handle_remap
       {
-        auto verts = vertices();
-        auto last = verts.end();
-        auto first = utils::find_if(verts, [this](vertex_handle v) { return status(v).removed(); });
-        if(first != last)
-          for(auto i = first; ++i != last; )
-            if (!status(*i).removed())
-              move(*i, *first++);
+        std::vector<vertex_handle> vertices;
+        std::vector<halfedge_handle> halfedges;
+        std::vector<edge_handle> edges;
+        std::vector<face_handle> faces;
+      };
+    
+      //erases all vertices, edges and faces marked as removed and renumbers the remaining elements
+      //without changing their order, the halfedges of removed edges are erased as well.
+      //the remaining elements must not reference removed ones, except for halfedges of removed faces
+      //which become boundary halfedges
+      void garbage_collection()
+      {
+        handle_remap remap;
+        garbage_collection(remap);
+      }
+    
+      //garbage_collection() which additionally returns the tables mapping the old to the new handles
+      void garbage_collection(handle_remap& remap)
+      {
+        OWL_PROFILE_FUNCTION();
+        std::vector<std::size_t> kept_vertices, kept_edges, kept_faces;
+        compute_remap(num_vertices(), [this](std::size_t v){ return !vertex_status_[v].is_removed(); },
+          remap.vertices, kept_vertices);
+        compute_remap(num_edges(), [this](std::size_t e){ return !edge_status_[e].is_removed(); },
+          remap.edges, kept_edges);
+        compute_remap(num_faces(), [this](std::size_t f){ return !face_status_[f].is_removed(); },
+          remap.faces, kept_faces);
+        //vertices of removed faces may gain boundary halfedges, their incoming halfedge is adjusted afterwards
+        std::vector<vertex_handle> opened_vertices;
+        if(kept_faces.size() != num_faces())
+          for(auto f : faces())
+            if(status(f).is_removed())
+              for(auto he : inner_halfedges(f))
+                if(!status(target(he)).is_removed())
+                  opened_vertices.push_back(target(he));
+        reorder_elements(remap, kept_vertices, kept_edges, kept_faces);
+        for(auto v : opened_vertices)
+          adjust_incoming(remap.vertices[v.index()]);
+      }
+    
+      //renumbers the elements such that vertex_order[i] becomes vertex i, edge_order[i] becomes edge i and
+      //face_order[i] becomes face i, each order has to contain every element of its kind exactly once.
+      //the halfedges follow their edges, all connectivity and properties are updated
+      void permute(const std::vector<vertex_handle>& vertex_order, const std::vector<edge_handle>& edge_order,
+        const std::vector<face_handle>& face_order)
+      {
+        OWL_PROFILE_FUNCTION();
+        assert(vertex_order.size() == num_vertices() && edge_order.size() == num_edges()
+          && face_order.size() == num_faces());
+        handle_remap remap;
+        std::vector<std::size_t> new_to_old_vertices, new_to_old_edges, new_to_old_faces;
+        invert_order(vertex_order, remap.vertices, new_to_old_vertices);
+        invert_order(edge_order, remap.edges, new_to_old_edges);
+        invert_order(face_order, remap.faces, new_to_old_faces);
+        reorder_elements(remap, new_to_old_vertices, new_to_old_edges, new_to_old_faces);
+      }
+    
+      //copies each group of faces with their vertices and edges into a mesh of its own including all properties,
+      //face_groups assigns each face to a group in [0, num_groups). faces sharing an edge have to be in the same
+      //group, e.g. each group is a union of shells. a vertex whose faces lie in several groups is copied into each
+      //of them, isolated vertices are dropped.
+      //the groups are copied in parallel, removed elements should be erased by garbage_collection() first
+      std::vector<mesh> split(const std::vector<std::size_t>& face_groups, std::size_t num_groups) const
+      {
+        OWL_PROFILE_FUNCTION();
+        assert(face_groups.size() == num_faces());
+        //vertices and edges belong to the group of an adjacent face
+        auto group_of = [&](halfedge_handle he)
+          {
+            if(!face(he).is_valid())
+              he = opposite(he);
+            return face(he).is_valid() ? face_groups[face(he).index()] : num_groups;
+          };
+        //a vertex whose faces lie in several groups is left out of the grouping and copied into each group below
+        std::vector<std::size_t> vertex_groups(num_vertices());
+        std::vector<char> shared_vertex(num_vertices(), 0);
+        utils::parallel_for(vertices(), [&](vertex_handle v)
+          {
+            vertex_groups[v.index()] = is_isolated(v) ? num_groups : group_of(incoming(v));
+            if(is_isolated(v))
+              return;
+            for(auto he : incoming_halfedges(v))
+            {
+              if(group_of(he) != vertex_groups[v.index()])
+              {
+                vertex_groups[v.index()] = num_groups;
+                shared_vertex[v.index()] = 1;
+                break;
+              }
+            }
+          });
+        std::vector<std::size_t> edge_groups(num_edges());
+        utils::parallel_for(edges(), [&](edge_handle e){ edge_groups[e.index()] = group_of(halfedge(e)); });
+
+        std::vector<std::vector<std::size_t>> group_vertices, group_edges, group_faces;
+        std::vector<mesh_index> local_vertices, local_edges, local_faces;
+        group_elements(vertex_groups, num_groups, group_vertices, local_vertices);
+        group_elements(edge_groups, num_groups, group_edges, local_edges);
+        group_elements(face_groups, num_groups, group_faces, local_faces);
+
+        //one copy per shared vertex and group, ordered by vertex. the incoming halfedge of a copy is taken from
+        //its group and is a boundary halfedge if there is one
+        struct vertex_copy
+        {
+          vertex_handle vertex;
+          std::size_t group;
+          halfedge_handle incoming;
+          mesh_index local;
+        };
+        std::vector<vertex_copy> copies;
+        std::vector<std::vector<std::size_t>> group_copies(num_groups);
+        for(auto v : vertices())
+        {
+          if(!shared_vertex[v.index()])
+            continue;
+          std::size_t first = copies.size();
+          for(auto he : incoming_halfedges(v))
+          {
+            std::size_t g = group_of(he);
+            auto copy = std::find_if(copies.begin() + first, copies.end(),
+              [g](const vertex_copy& c){ return c.group == g; });
+            if(copy == copies.end())
+            {
+              group_copies[g].push_back(copies.size());
+              copies.push_back({v, g, he, static_cast<mesh_index>(group_vertices[g].size())});
+              group_vertices[g].push_back(v.index());
+            }
+            else if(is_boundary(he) && !is_boundary(copy->incoming))
+              copy->incoming = he;
+          }
+        }
+
+        std::vector<mesh> parts(num_groups);
+        utils::parallel_for(std::size_t(0), num_groups, [&](std::size_t g)
+          {
+            auto map_halfedge = [&](halfedge_handle he)
+              {
+                return he.is_valid() ? halfedge_handle(2 * local_edges[he.index() / 2] + he.index() % 2) : he;
+              };
+            auto map_vertex = [&](vertex_handle v)
+              {
+                if(!v.is_valid() || !shared_vertex[v.index()])
+                  return v.is_valid() ? vertex_handle(local_vertices[v.index()]) : v;
+                auto copy = std::lower_bound(copies.begin(), copies.end(), v,
+                  [](const vertex_copy& c, vertex_handle w){ return c.vertex.index() < w.index(); });
+                while(copy->group != g)
+                  ++copy;
+                return vertex_handle(copy->local);
+              };
+            auto map_face = [&](face_handle f){ return f.is_valid() ? face_handle(local_faces[f.index()]) : f; };
+
+            mesh& part = parts[g];
+            const auto& vertices = group_vertices[g];
+            const auto& edges = group_edges[g];
+            const auto& faces = group_faces[g];
+            std::vector<std::size_t> halfedges;
+            //large shells are copied in parallel as well, small ones stay on the thread of their group
+            gather_connectivity(part, vertices, edges, faces, halfedges, map_vertex, map_halfedge, map_face);
+            for(auto c : group_copies[g])
+              part.vertex_incoming_[copies[c].local] = map_halfedge(copies[c].incoming);
+
+            part.vertex_properties_ = vertex_properties_.gathered(vertices);
+            part.edge_properties_ = edge_properties_.gathered(edges);
+            part.halfedge_properties_ = halfedge_properties_.gathered(halfedges);
+            part.face_properties_ = face_properties_.gathered(faces);
+            part.mesh_properties_ = mesh_properties_;
+            part.vertex_position_handle_ = vertex_position_handle_;
+            part.face_normal_handle_ = face_normal_handle_;
+            part.face_color_handle_ = face_color_handle_;
+            part.halfedge_normal_handle_ = halfedge_normal_handle_;
+            part.halfedge_texcoord_handle_ = halfedge_texcoord_handle_;
+          });
+        return parts;
       }
     
       template <typename TexCoordRange, typename = std::enable_if_t<is_vector_range<TexCoordRange,2>::value>>
@@ -1344,6 +1916,54 @@ namespace owl
         mesh_properties_.add_property(ph, name);
       }
     
+      template <typename T>
+      decltype(auto) property(const vertex_property_handle<T>& ph, vertex_handle v)
+      {
+        return vertex_properties_[ph][v.index()];
+      }
+    
+      template <typename T>
+      decltype(auto) property(const vertex_property_handle<T>& ph, vertex_handle v) const
+      {
+        return vertex_properties_[ph][v.index()];
+      }
+    
+      template <typename T>
+      decltype(auto) property(const edge_property_handle<T>& ph, edge_handle e)
+      {
+        return edge_properties_[ph][e.index()];
+      }
+    
+      template <typename T>
+      decltype(auto) property(const edge_property_handle<T>& ph, edge_handle e) const
+      {
+        return edge_properties_[ph][e.index()];
+      }
+    
+      template <typename T>
+      decltype(auto) property(const halfedge_property_handle<T>& ph, halfedge_handle he)
+      {
+        return halfedge_properties_[ph][he.index()];
+      }
+    
+      template <typename T>
+      decltype(auto) property(const halfedge_property_handle<T>& ph, halfedge_handle he) const
+      {
+        return halfedge_properties_[ph][he.index()];
+      }
+    
+      template <typename T>
+      decltype(auto) property(const face_property_handle<T>& ph, face_handle f)
+      {
+        return face_properties_[ph][f.index()];
+      }
+    
+      template <typename T>
+      decltype(auto) property(const face_property_handle<T>& ph, face_handle f) const
+      {
+        return face_properties_[ph][f.index()];
+      }
+    
       template <typename T>
       void remove_property(vertex_property_handle<T>& ph)
       {
@@ -1374,6 +1994,36 @@ namespace owl
         mesh_properties_.remove_property(ph);
       }
     
+      //looks up the property of given type and name, e.g. of a mesh read from a snapshot,
+      //returns false and leaves ph invalid if there is none
+      template <typename T>
+      bool get_property(vertex_property_handle<T>& ph, const std::string& name = "") const
+      {
+        ph = vertex_properties_.get_property<T>(name);
+        return ph.is_valid();
+      }
+    
+      template <typename T>
+      bool get_property(edge_property_handle<T>& ph, const std::string& name = "") const
+      {
+        ph = edge_properties_.get_property<T>(name);
+        return ph.is_valid();
+      }
+    
+      template <typename T>
+      bool get_property(halfedge_property_handle<T>& ph, const std::string& name = "") const
+      {
+        ph = halfedge_properties_.get_property<T>(name);
+        return ph.is_valid();
+      }
+    
+      template <typename T>
+      bool get_property(face_property_handle<T>& ph, const std::string& name = "") const
+      {
+        ph = face_properties_.get_property<T>(name);
+        return ph.is_valid();
+      }
+    
       template <typename T>
       bool has_vertex_property(const std::string& name = "") const
       {
@@ -1383,19 +2033,19 @@ namespace owl
       template <typename T>
       bool has_edge_property(const std::string& name = "") const
       {
-        return edge_properties_.has_property(name);
+        return edge_properties_.has_property<T>(name);
       }
     
       template <typename T>
       bool has_halfedge_property(const std::string& name = "") const
       {
-        return halfedge_properties_.has_property(name);
+        return halfedge_properties_.has_property<T>(name);
       }
     
       template <typename T>
       bool has_face_property(const std::string& name = "") const
       {
-        return face_properties_.has_property(name);
+        return face_properties_.has_property<T>(name);
       }
     
       template <typename T>
@@ -1406,7 +2056,7 @@ namespace owl
     
       const face_handle& face(halfedge_handle he) const
       {
-        return operator[](he).face;
+        return halfedge_face_[he.index()];
       }
     
       halfedge_handle opposite(halfedge_handle he) const
@@ -1416,27 +2066,56 @@ namespace owl
     
       const halfedge_handle& inner(face_handle f) const
       {
-        return operator[](f).halfedge;
+        return face_halfedge_[f.index()];
       }
     
       face_handle& face(halfedge_handle he)
       {
-        return operator[](he).face;
+        return halfedge_face_[he.index()];
       }
     
       halfedge_handle& inner(face_handle f)
       {
-        return operator[](f).halfedge;
+        return face_halfedge_[f.index()];
       }
     
       halfedge_handle& incoming(vertex_handle v)
       {
-        return operator[](v).incoming;
+        return vertex_incoming_[v.index()];
       }
     
+      //writing through the returned reference bypasses the stored prev pointers, use set_next instead
       halfedge_handle& next(halfedge_handle he)
       {
-        return operator[](he).next;
+        return halfedge_next_[he.index()];
+      }
+    
+      void set_next(halfedge_handle he, halfedge_handle he_next)
+      {
+        halfedge_next_[he.index()] = he_next;
+        if(has_stored_prev() && he_next.is_valid())
+          halfedge_prev_[he_next.index()] = he;
+      }
+    
+      //enables or disables storing prev pointers which are maintained by all topology operations,
+      //this trades one index per halfedge for O(1) prev() and prev_circ()
+      void store_prev(bool enable = true)
+      {
+        store_prev_ = enable;
+        if(!enable)
+        {
+          halfedge_prev_ = std::vector<halfedge_handle>();
+          return;
+        }
+        halfedge_prev_.assign(num_halfedges(), halfedge_handle::invalid());
+        for(auto he : halfedges())
+          if(next(he).is_valid())
+            halfedge_prev_[next(he).index()] = he;
+      }
+    
+      bool has_stored_prev() const
+      {
+        return store_prev_;
       }
     
       halfedge_handle outer(face_handle f) const
@@ -1446,7 +2125,7 @@ namespace owl
     
       const halfedge_handle& next(halfedge_handle he) const
       {
-        return operator[](he).next;
+        return halfedge_next_[he.index()];
       }
     
       halfedge_handle next_incoming(halfedge_handle he) const
@@ -1471,7 +2150,7 @@ namespace owl
     
       const halfedge_handle& incoming(vertex_handle v) const
       {
-        return operator[](v).incoming;
+        return vertex_incoming_[v.index()];
       }
     
       halfedge_handle outgoing(vertex_handle v) const
@@ -1481,8 +2160,11 @@ namespace owl
         return opposite(incoming(v));
       }
   
+      //O(1) if prev pointers are stored, otherwise walks around the face loop
       halfedge_handle prev(halfedge_handle he) const
       {
+        if(has_stored_prev())
+          return halfedge_prev_[he.index()];
         auto prev_he = next(he);
         auto next_prev_he = next(prev_he);
      
@@ -1494,8 +2176,11 @@ namespace owl
         return prev_he;
       }
     
+      //same as prev(he) but walks around the origin of he instead of the face loop
       halfedge_handle prev_circ(halfedge_handle he) const
       {
+        if(has_stored_prev())
+          return halfedge_prev_[he.index()];
         auto prev_he = opposite(next(opposite(he)));
         auto next_prev_he = next(prev_he);
      
@@ -1547,6 +2232,8 @@ namespace owl
         std::size_t count_warning = 0;
         for(auto he: halfedges())
        {
+          if(status(edge(he)).is_removed())
+            continue;
           if(!target(he).is_valid() )
           {
              std::cout << "target(" << he << ") is invalid "<< he << std::endl;
@@ -1557,6 +2244,11 @@ namespace owl
             std::cout << "next(" << he << ") is invalid "<< he << std::endl;
             ++count_error;
           }
+          else if(status(edge(next(he))).is_removed())
+          {
+            std::cout << "next(" << he << ") = " << next(he) << " is removed" << std::endl;
+            ++count_error;
+          }
           else if(face(he) != face(next(he)))
           {
             std::cout << "face(" << he <<") = "<<face(he) << std::endl;
@@ -1564,9 +2256,16 @@ namespace owl
             std::cout << "face(" << next(he) <<") = "<< face(next(he)) << std::endl;
             ++count_error;
           }
+          else if(has_stored_prev() && halfedge_prev_[next(he).index()] != he)
+          {
+            std::cout << "prev(" << next(he) << ") = " << halfedge_prev_[next(he).index()] << " but should be " << he << std::endl;
+            ++count_error;
+          }
        }
         for(auto v: vertices())
         {
+          if(status(v).is_removed())
+            continue;
           if(is_isolated(v))
           {
             if(!supress_warnings)
@@ -1641,102 +2340,592 @@ namespace owl
      }
 
    private:
+      friend struct detail::mesh_snapshot<Scalar>;
    
-      struct vertex_t
+      //merges origin(he) into target(he) and unlinks the edge of he, the faces of he may become loops of two halfedges
+      void collapse_edge(halfedge_handle he)
       {
-        vertex_t() = default;
-        halfedge_handle incoming;
-        status_flags status;
-      };
-   
-      struct halfedge_t
-      {
-        halfedge_t() = default;
-        halfedge_t(vertex_handle to, face_handle f = face_handle::invalid())
-          : target{to}
-          , face{f}
+        auto he_opp = opposite(he);
+        auto he_next = next(he);
+        auto he_prev = prev(he);
+        auto he_opp_next = next(he_opp);
+        auto he_opp_prev = prev(he_opp);
+        auto f = face(he);
+        auto f_opp = face(he_opp);
+        auto v_keep = target(he);
+        auto v_remove = origin(he);
+    
+        for(auto in : incoming_halfedges(v_remove))
+          target(in) = v_keep;
+        set_next(he_prev, he_next);
+        set_next(he_opp_prev, he_opp_next);
+        if(f.is_valid())
+          inner(f) = he_next;
+        if(f_opp.is_valid())
+          inner(f_opp) = he_opp_next;
+        if(incoming(v_keep) == he)
+          incoming(v_keep) = he_prev;
+        adjust_incoming(v_keep);
+    
+        incoming(v_remove).invalidate();
+        status(v_remove).remove();
+        status(edge(he)).remove();
+      }
+    
+      //removes the loop formed by he and next(he) together with the edge of he
+      void collapse_loop(halfedge_handle he)
+      {
+        auto he_next = next(he);
+        auto he_opp = opposite(he);
+        auto he_opp_next = next(he_opp);
+        auto he_opp_prev = prev(he_opp);
+        auto v0 = target(he);
+        auto v1 = target(he_next);
+        auto f = face(he);
+        auto f_opp = face(he_opp);
+        assert(next(he_next) == he && he_next != he_opp);
+    
+        set_next(he_next, he_opp_next);
+        set_next(he_opp_prev, he_next);
+        face(he_next) = f_opp;
+        incoming(v0) = opposite(he_next);
+        adjust_incoming(v0);
+        incoming(v1) = he_next;
+        adjust_incoming(v1);
+        if(f_opp.is_valid() && inner(f_opp) == he_opp)
+          inner(f_opp) = he_next;
+        if(f.is_valid())
         {
+          inner(f).invalidate();
+          status(f).remove();
         }
-     
-        vertex_handle target;
-        halfedge_handle next;
-        face_handle face;
-        status_flags status;
-      };
+        status(edge(he)).remove();
+      }
     
-      struct edge_t
+      void resize_vertices(std::size_t n)
       {
-        edge_t() = default;
-        edge_t(vertex_handle from, vertex_handle to)
-          : halfedges{{halfedge_t(to), halfedge_t(from)}}
+        vertex_incoming_.resize(n);
+        vertex_status_.resize(n);
+      }
+    
+      void resize_edges(std::size_t n)
+      {
+        if(has_stored_prev())
+          halfedge_prev_.resize(2 * n);
+        halfedge_next_.resize(2 * n);
+        halfedge_target_.resize(2 * n);
+        halfedge_face_.resize(2 * n);
+        halfedge_status_.resize(2 * n);
+        edge_status_.resize(n);
+      }
+    
+      void resize_faces(std::size_t n)
+      {
+        face_halfedge_.resize(n);
+        face_status_.resize(n);
+      }
+
+      //faces or vertices processed per parallel block of the normal computation
+      static constexpr std::size_t normal_block_size = 4096;
+      //number of elements processed between two progress updates
+      static constexpr std::size_t progress_step_size = 1 << 14;
+      //elements renumbered per parallel block of garbage_collection() and permute()
+      static constexpr std::size_t compaction_block_size = 1 << 14;
+    
+      template <typename Handle>
+      static void invert_order(const std::vector<Handle>& order, std::vector<Handle>& old_to_new,
+        std::vector<std::size_t>& new_to_old)
+      {
+        old_to_new.resize(order.size());
+        new_to_old.resize(order.size());
+        utils::parallel_for_blocks(std::size_t(0), order.size(), compaction_block_size,
+          [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t i = first; i < last; ++i)
+            {
+              old_to_new[order[i].index()] = Handle(static_cast<mesh_index>(i));
+              new_to_old[i] = order[i].index();
+            }
+          });
+      }
+    
+      //gathers the connectivity and status of the elements new_to_old_*[i] of this mesh into index i of the arrays
+      //of target and stores the old index of each gathered halfedge, references are rewritten by the map functors.
+      //all arrays are gathered in blocks processed independently, used by reorder_elements and split
+      template <typename MapVertex, typename MapHalfedge, typename MapFace>
+      void gather_connectivity(mesh& target, const std::vector<std::size_t>& new_to_old_vertices,
+        const std::vector<std::size_t>& new_to_old_edges, const std::vector<std::size_t>& new_to_old_faces,
+        std::vector<std::size_t>& new_to_old_halfedges, MapVertex&& map_vertex, MapHalfedge&& map_halfedge,
+        MapFace&& map_face) const
+      {
+        std::size_t n_halfedges = 2 * new_to_old_edges.size();
+        new_to_old_halfedges.resize(n_halfedges);
+        target.store_prev_ = store_prev_;
+        target.halfedge_next_.resize(n_halfedges);
+        target.halfedge_prev_.resize(store_prev_ ? n_halfedges : 0);
+        target.halfedge_target_.resize(n_halfedges);
+        target.halfedge_face_.resize(n_halfedges);
+        target.halfedge_status_.resize(n_halfedges);
+        target.edge_status_.resize(new_to_old_edges.size());
+        utils::parallel_for_blocks(std::size_t(0), new_to_old_edges.size(), compaction_block_size,
+          [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t e = first; e < last; ++e)
+            {
+              target.edge_status_[e] = edge_status_[new_to_old_edges[e]];
+              for(std::size_t he = 2 * e; he < 2 * e + 2; ++he)
+              {
+                std::size_t old_he = 2 * new_to_old_edges[e] + he % 2;
+                new_to_old_halfedges[he] = old_he;
+                target.halfedge_next_[he] = map_halfedge(halfedge_next_[old_he]);
+                if(store_prev_)
+                  target.halfedge_prev_[he] = map_halfedge(halfedge_prev_[old_he]);
+                target.halfedge_target_[he] = map_vertex(halfedge_target_[old_he]);
+                target.halfedge_face_[he] = map_face(halfedge_face_[old_he]);
+                target.halfedge_status_[he] = halfedge_status_[old_he];
+              }
+            }
+          });
+
+        target.vertex_incoming_.resize(new_to_old_vertices.size());
+        target.vertex_status_.resize(new_to_old_vertices.size());
+        utils::parallel_for_blocks(std::size_t(0), new_to_old_vertices.size(), compaction_block_size,
+          [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t v = first; v < last; ++v)
+            {
+              target.vertex_incoming_[v] = map_halfedge(vertex_incoming_[new_to_old_vertices[v]]);
+              target.vertex_status_[v] = vertex_status_[new_to_old_vertices[v]];
+            }
+          });
+
+        target.face_halfedge_.resize(new_to_old_faces.size());
+        target.face_status_.resize(new_to_old_faces.size());
+        utils::parallel_for_blocks(std::size_t(0), new_to_old_faces.size(), compaction_block_size,
+          [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t f = first; f < last; ++f)
+            {
+              target.face_halfedge_[f] = map_halfedge(face_halfedge_[new_to_old_faces[f]]);
+              target.face_status_[f] = face_status_[new_to_old_faces[f]];
+            }
+          });
+      }
+
+      //moves the elements new_to_old[i] to index i and erases the elements which are not listed,
+      //all references are rewritten through the remap tables. gathering into new arrays reads and writes
+      //every array once and lets each block be processed independently
+      void reorder_elements(handle_remap& remap, const std::vector<std::size_t>& new_to_old_vertices,
+        const std::vector<std::size_t>& new_to_old_edges, const std::vector<std::size_t>& new_to_old_faces)
+      {
+        remap.halfedges.resize(halfedge_next_.size());
+        utils::parallel_for_blocks(std::size_t(0), remap.halfedges.size(), compaction_block_size,
+          [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t he = first; he < last; ++he)
+            {
+              edge_handle e = remap.edges[he / 2];
+              remap.halfedges[he] = e.is_valid()
+                ? halfedge_handle(static_cast<mesh_index>(2 * e.index() + he % 2)) : halfedge_handle::invalid();
+            }
+          });
+    
+        auto map = [](const auto& table, auto h)
+        {
+          return h.is_valid() ? table[h.index()] : h;
+        };
+    
+        mesh gathered;
+        std::vector<std::size_t> new_to_old_halfedges;
+        gather_connectivity(gathered, new_to_old_vertices, new_to_old_edges, new_to_old_faces, new_to_old_halfedges,
+          [&](vertex_handle v){ return map(remap.vertices, v); },
+          [&](halfedge_handle he){ return map(remap.halfedges, he); },
+          [&](face_handle f){ return map(remap.faces, f); });
+
+        halfedge_next_.swap(gathered.halfedge_next_);
+        halfedge_prev_.swap(gathered.halfedge_prev_);
+        halfedge_target_.swap(gathered.halfedge_target_);
+        halfedge_face_.swap(gathered.halfedge_face_);
+        halfedge_status_.swap(gathered.halfedge_status_);
+        edge_status_.swap(gathered.edge_status_);
+        vertex_incoming_.swap(gathered.vertex_incoming_);
+        vertex_status_.swap(gathered.vertex_status_);
+        face_halfedge_.swap(gathered.face_halfedge_);
+        face_status_.swap(gathered.face_status_);
+
+        vertex_properties_.gather(new_to_old_vertices);
+        edge_properties_.gather(new_to_old_edges);
+        halfedge_properties_.gather(new_to_old_halfedges);
+        face_properties_.gather(new_to_old_faces);
+      }
+    
+      template <typename Level>
+      bool subdivide_out_of_place(std::size_t levels, Level&& level)
+      {
+        utils::progress subdividing(levels);
+        mesh result;
+        for(std::size_t i = 0; i < levels; ++i)
         {
+          mesh refined;
+          level(i == 0 ? *this : result, refined);
+          result = std::move(refined);
+          if(!subdividing.step())
+            return false;
         }
-     
-        std::array<halfedge_t,2> halfedges;
-        status_flags status;
-      };
+        if(levels == 0)
+          return true;
+        result.store_prev(has_stored_prev());
+        *this = std::move(result);
+        return true;
+      }
     
-      struct face_t
+      //lists the elements of each group in [0, num_groups) in ascending order and stores the position of each
+      //element in the list of its group, elements of group num_groups are not listed
+      static void group_elements(const std::vector<std::size_t>& groups, std::size_t num_groups,
+        std::vector<std::vector<std::size_t>>& members, std::vector<mesh_index>& local_index)
       {
-        face_t() = default;
-     
-        face_t(halfedge_handle he)
-          : halfedge{he}
+        members.assign(num_groups, {});
+        local_index.resize(groups.size());
+        for(std::size_t i = 0; i < groups.size(); ++i)
         {
+          if(groups[i] == num_groups)
+            continue;
+          local_index[i] = static_cast<mesh_index>(members[groups[i]].size());
+          members[groups[i]].push_back(i);
         }
-     
-        halfedge_handle halfedge;
-        status_flags status;
-      };
+      }
     
+      //numbers the corners of the faces, which are the halfedges not on the boundary, returns their number
+      std::size_t number_corners(std::vector<face_handle>& corner_index) const
+      {
+        std::vector<std::size_t> corner_halfedges;
+        compute_remap(num_halfedges(), [this](std::size_t he){ return halfedge_face_[he].is_valid(); },
+          corner_index, corner_halfedges);
+        return corner_halfedges.size();
+      }
     
-      auto operator[](edge_handle e)
+      static void allocate_elements(mesh& result, std::size_t num_vertices, std::size_t num_edges,
+        std::size_t num_faces)
       {
-        auto he = halfedge(e);
-        return std::tie(operator[](he), operator[](he + 1));
+        result.resize_vertices(num_vertices);
+        result.vertex_properties_.resize(num_vertices);
+        result.resize_edges(num_edges);
+        result.edge_properties_.resize(num_edges);
+        result.halfedge_properties_.resize(2 * num_edges);
+        result.resize_faces(num_faces);
+        result.face_properties_.resize(num_faces);
       }
     
-      auto operator[](edge_handle e) const
+      //each edge e of this mesh is split at vertex num_vertices() + e, the halfedge he is split into the halfedge
+      //2 * he ending at target(he) and the halfedge 2 * opposite(he) + 1 starting at origin(he).
+      //the halfedges of boundary halfedges are linked along the boundary
+      void split_halfedges(mesh& result, std::size_t first, std::size_t last) const
       {
-        auto he = halfedge(e);
-        return std::tie(operator[](he), operator[](he + 1));
+        for(std::size_t he = first; he < last; ++he)
+        {
+          halfedge_handle h(static_cast<mesh_index>(he));
+          std::size_t first_half = 2 * he;
+          std::size_t second_half = 2 * (he ^ 1) + 1;
+          result.halfedge_target_[first_half] = target(h);
+          result.halfedge_target_[second_half] = vertex_handle(static_cast<mesh_index>(num_vertices() + he / 2));
+          if(is_boundary(h))
+          {
+            result.halfedge_next_[first_half] = halfedge_handle(static_cast<mesh_index>(2 * (next(h).index() ^ 1) + 1));
+            result.halfedge_next_[second_half] = halfedge_handle(static_cast<mesh_index>(first_half));
+          }
+        }
       }
-
-      auto& operator[](halfedge_handle he)
+    
+      //the split vertices keep the incoming halfedges of the old vertices, the new vertex on an edge
+      //takes the second half of a boundary halfedge to stay a boundary vertex
+      void link_split_vertices(mesh& result) const
       {
-        edge_handle e = edge(he);
-        return edges_[e.index()].halfedges[he.index() - (e.index() << 1)];
+        utils::parallel_for_blocks(std::size_t(0), num_vertices(), compaction_block_size,
+          [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t v = first; v < last; ++v)
+            {
+              auto he = vertex_incoming_[v];
+              result.vertex_incoming_[v] = he.is_valid() ? halfedge_handle(static_cast<mesh_index>(2 * he.index()))
+                : halfedge_handle::invalid();
+            }
+          });
+        utils::parallel_for_blocks(std::size_t(0), num_edges(), compaction_block_size,
+          [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t e = first; e < last; ++e)
+            {
+              std::size_t he = is_boundary(halfedge_handle(static_cast<mesh_index>(2 * e))) ? 2 * e : 2 * e + 1;
+              result.vertex_incoming_[num_vertices() + e] = halfedge_handle(static_cast<mesh_index>(2 * (he ^ 1) + 1));
+            }
+          });
       }
-        
-      const auto& operator[](halfedge_handle he) const
+    
+      //moves an old vertex by the boundary rule 3/4 p + 1/8 (a + b) with its two boundary neighbors,
+      //vertices with non manifold boundaries or without edges keep their position
+      bool smooth_boundary_vertex(vertex_handle v, vector3& p) const
       {
-        edge_handle e = edge(he);
-        return edges_[e.index()].halfedges[he.index() - (e.index() << 1)];
+        auto he = incoming(v);
+        if(!he.is_valid())
+        {
+          p = position(v);
+          return true;
+        }
+        if(!is_boundary(he))
+          return false;
+        p = scalar(0.75) * position(v) + scalar(0.125) * (position(origin(he)) + position(target(next(he))));
+        return true;
       }
-
-      auto& operator[](face_handle f)
+    
+      //builds the next catmull-clark level, the vertices of result are the old vertices followed by one vertex per
+      //edge and one per face, each corner of a face becomes a quad
+      void catmull_clark_level(mesh& result) const
       {
-        return faces_[f.index()];
+        std::size_t nv = num_vertices();
+        std::size_t ne = num_edges();
+        std::vector<face_handle> corner_face;
+        std::size_t num_corners = number_corners(corner_face);
+        allocate_elements(result, nv + ne + num_faces(), 2 * ne + num_corners, num_corners);
+        std::size_t split_halfedges_count = 4 * ne;
+    
+        //the corner he contributes the quad edge from the vertex on its edge to the face vertex
+        auto to_face = [&](halfedge_handle he)
+        {
+          return split_halfedges_count + 2 * corner_face[he.index()].index();
+        };
+        utils::parallel_for_blocks(std::size_t(0), num_halfedges(), compaction_block_size,
+          [&](std::size_t first, std::size_t last)
+          {
+            split_halfedges(result, first, last);
+            for(std::size_t he = first; he < last; ++he)
+            {
+              halfedge_handle h(static_cast<mesh_index>(he));
+              if(is_boundary(h))
+                continue;
+              auto h_next = next(h);
+              auto quad = corner_face[he];
+              std::size_t quad_halfedges[4] = {2 * he, 2 * (h_next.index() ^ 1) + 1, to_face(h_next), to_face(h) + 1};
+              for(std::size_t i = 0; i < 4; ++i)
+              {
+                result.halfedge_next_[quad_halfedges[i]] = halfedge_handle(static_cast<mesh_index>(quad_halfedges[(i + 1) % 4]));
+                result.halfedge_face_[quad_halfedges[i]] = quad;
+              }
+              result.halfedge_target_[to_face(h)] = vertex_handle(static_cast<mesh_index>(nv + ne + face(h).index()));
+              result.halfedge_target_[to_face(h) + 1] = vertex_handle(static_cast<mesh_index>(nv + he / 2));
+              result.face_halfedge_[quad.index()] = halfedge_handle(static_cast<mesh_index>(2 * he));
+            }
+          });
+        link_split_vertices(result);
+        utils::parallel_for_blocks(std::size_t(0), num_faces(), compaction_block_size,
+          [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t f = first; f < last; ++f)
+              result.vertex_incoming_[nv + ne + f] = halfedge_handle(static_cast<mesh_index>(
+                to_face(inner(face_handle(static_cast<mesh_index>(f))))));
+          });
+    
+        auto face_point = [&](face_handle f) -> vector3&
+        {
+          return result.position(vertex_handle(static_cast<mesh_index>(nv + ne + f.index())));
+        };
+        utils::parallel_for(faces(), [&](face_handle f){ face_point(f) = centroid(f); });
+        utils::parallel_for(edges(), [&](edge_handle e)
+          {
+            auto [h0, h1] = halfedges(e);
+            auto& p = result.position(vertex_handle(static_cast<mesh_index>(nv + e.index())));
+            p = position(target(h0)) + position(target(h1));
+            if(is_boundary(e))
+              p *= scalar(0.5);
+            else
+              p = scalar(0.25) * (p + face_point(face(h0)) + face_point(face(h1)));
+          });
+        utils::parallel_for(vertices(), [&](vertex_handle v)
+          {
+            auto& p = result.position(v);
+            if(smooth_boundary_vertex(v, p))
+              return;
+            //(f + 2 r + (n - 3) p) / n with the mean f of the face points and the mean r of the edge midpoints
+            vector3 sum_faces = vector3::zero();
+            vector3 sum_neighbors = vector3::zero();
+            scalar n = 0;
+            for(auto he : incoming_halfedges(v))
+            {
+              sum_faces += face_point(face(he));
+              sum_neighbors += position(origin(he));
+              n += 1;
+            }
+            p = (sum_faces / n + (sum_neighbors / n + position(v)) + (n - 3) * position(v)) / n;
+          });
       }
-
-      const auto& operator[](face_handle f) const
+    
+      //builds the next loop level, the vertices of result are the old vertices followed by one vertex per edge,
+      //each corner of a triangle becomes a triangle followed by one center triangle per face
+      void loop_level(mesh& result) const
       {
-        return faces_[f.index()];
+        std::size_t nv = num_vertices();
+        std::size_t ne = num_edges();
+        std::vector<face_handle> corner_face;
+        std::size_t num_corners = number_corners(corner_face);
+        allocate_elements(result, nv + ne, 2 * ne + num_corners, num_corners + num_faces());
+        std::size_t split_halfedges_count = 4 * ne;
+    
+        //the corner he contributes the edge between the vertices on its edge and on the next edge,
+        //the even halfedge belongs to the corner triangle and the odd one to the center triangle
+        auto inner_edge = [&](halfedge_handle he)
+        {
+          return split_halfedges_count + 2 * corner_face[he.index()].index();
+        };
+        utils::parallel_for_blocks(std::size_t(0), num_halfedges(), compaction_block_size,
+          [&](std::size_t first, std::size_t last)
+          {
+            split_halfedges(result, first, last);
+            for(std::size_t he = first; he < last; ++he)
+            {
+              halfedge_handle h(static_cast<mesh_index>(he));
+              if(is_boundary(h))
+                continue;
+              auto h_next = next(h);
+              auto corner = corner_face[he];
+              std::size_t triangle_halfedges[3] = {2 * he, 2 * (h_next.index() ^ 1) + 1, inner_edge(h)};
+              for(std::size_t i = 0; i < 3; ++i)
+              {
+                result.halfedge_next_[triangle_halfedges[i]] = halfedge_handle(static_cast<mesh_index>(triangle_halfedges[(i + 1) % 3]));
+                result.halfedge_face_[triangle_halfedges[i]] = corner;
+              }
+              std::size_t center_he = inner_edge(h) + 1;
+              result.halfedge_target_[inner_edge(h)] = vertex_handle(static_cast<mesh_index>(nv + he / 2));
+              result.halfedge_target_[center_he] = vertex_handle(static_cast<mesh_index>(nv + h_next.index() / 2));
+              result.halfedge_next_[center_he] = halfedge_handle(static_cast<mesh_index>(inner_edge(h_next) + 1));
+              result.halfedge_face_[center_he] = face_handle(static_cast<mesh_index>(num_corners + face(h).index()));
+              result.face_halfedge_[corner.index()] = halfedge_handle(static_cast<mesh_index>(2 * he));
+            }
+          });
+        link_split_vertices(result);
+        utils::parallel_for_blocks(std::size_t(0), num_faces(), compaction_block_size,
+          [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t f = first; f < last; ++f)
+              result.face_halfedge_[num_corners + f] = halfedge_handle(static_cast<mesh_index>(
+                inner_edge(inner(face_handle(static_cast<mesh_index>(f)))) + 1));
+          });
+    
+        utils::parallel_for(edges(), [&](edge_handle e)
+          {
+            auto [h0, h1] = halfedges(e);
+            auto& p = result.position(vertex_handle(static_cast<mesh_index>(nv + e.index())));
+            p = position(target(h0)) + position(target(h1));
+            if(is_boundary(e))
+              p *= scalar(0.5);
+            else
+              p = scalar(0.375) * p + scalar(0.125) * (position(target(next(h0))) + position(target(next(h1))));
+          });
+        utils::parallel_for(vertices(), [&](vertex_handle v)
+          {
+            auto& p = result.position(v);
+            if(smooth_boundary_vertex(v, p))
+              return;
+            vector3 sum_neighbors = vector3::zero();
+            std::size_t n = 0;
+            for(auto he : incoming_halfedges(v))
+            {
+              sum_neighbors += position(origin(he));
+              ++n;
+            }
+            //weights of loop's original scheme
+            scalar c = scalar(0.375) + scalar(0.25) * std::cos(constants::two_pi<scalar> / n);
+            scalar beta = (scalar(0.625) - c * c) / n;
+            p = (1 - n * beta) * position(v) + beta * sum_neighbors;
+          });
       }
     
-      auto& operator[](vertex_handle v)
+      //assigns consecutive indices to the elements i in [0, n) for which is_kept(i) holds, old_to_new maps the
+      //other elements to invalid handles and kept lists the old indices of the kept elements in ascending order.
+      //the elements are counted per block first so that both passes run in parallel
+      template <typename Handle, typename IsKept>
+      static void compute_remap(std::size_t n, IsKept&& is_kept, std::vector<Handle>& old_to_new,
+        std::vector<std::size_t>& kept)
       {
-        return vertices_[v.index()];
+        std::size_t n_blocks = (n + compaction_block_size - 1) / compaction_block_size;
+        std::vector<std::size_t> offsets(n_blocks + 1, 0);
+        utils::parallel_for(std::size_t(0), n_blocks, [&](std::size_t b)
+          {
+            std::size_t last = std::min(n, (b + 1) * compaction_block_size);
+            for(std::size_t i = b * compaction_block_size; i < last; ++i)
+              if(is_kept(i))
+                ++offsets[b + 1];
+          });
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    
+        old_to_new.resize(n);
+        kept.resize(offsets.back());
+        utils::parallel_for(std::size_t(0), n_blocks, [&](std::size_t b)
+          {
+            std::size_t last = std::min(n, (b + 1) * compaction_block_size);
+            std::size_t j = offsets[b];
+            for(std::size_t i = b * compaction_block_size; i < last; ++i)
+            {
+              if(is_kept(i))
+              {
+                old_to_new[i] = Handle(static_cast<mesh_index>(j));
+                kept[j++] = i;
+              }
+              else
+                old_to_new[i] = Handle::invalid();
+            }
+          });
       }
 
-      const auto& operator[](vertex_handle v) const
-      {
-        return vertices_[v.index()];
+      //computes the normals of the triangles [first, last) in batches, the edge vectors of a batch are gathered
+      //into separate coordinate arrays first so that the cross products compile to vector instructions
+      void update_triangle_normals(std::size_t first, std::size_t last)
+      {
+        constexpr std::size_t batch_size = 256;
+        scalar e[6][batch_size];
+        scalar n[3][batch_size];
+        for(std::size_t batch_first = first; batch_first < last; batch_first += batch_size)
+        {
+          std::size_t count = std::min(batch_size, last - batch_first);
+          for(std::size_t i = 0; i < count; ++i)
+          {
+            auto he = inner(face_handle(batch_first + i));
+            const auto& p0 = position(target(he));
+            he = next(he);
+            const auto& p1 = position(target(he));
+            const auto& p2 = position(target(next(he)));
+            for(std::size_t j = 0; j < 3; ++j)
+            {
+              e[j][i] = p1[j] - p0[j];
+              e[3 + j][i] = p2[j] - p0[j];
+            }
+          }
+
+          for(std::size_t i = 0; i < count; ++i)
+          {
+            n[0][i] = e[1][i] * e[5][i] - e[2][i] * e[4][i];
+            n[1][i] = e[2][i] * e[3][i] - e[0][i] * e[5][i];
+            n[2][i] = e[0][i] * e[4][i] - e[1][i] * e[3][i];
+          }
+
+          for(std::size_t i = 0; i < count; ++i)
+          {
+            scalar len = std::sqrt(n[0][i] * n[0][i] + n[1][i] * n[1][i] + n[2][i] * n[2][i]);
+            scalar inv_len = len > 0 ? 1 / len : 0;
+            n[0][i] *= inv_len;
+            n[1][i] *= inv_len;
+            n[2][i] *= inv_len;
+          }
+
+          for(std::size_t i = 0; i < count; ++i)
+            normal(face_handle(batch_first + i)) = vector3(n[0][i], n[1][i], n[2][i]);
+        }
       }
-    
+
       edge_handle add_edge(vertex_handle from, vertex_handle to)
       {
-        edges_.emplace_back(from, to);
+        halfedge_handle he(num_halfedges());
+        resize_edges(num_edges() + 1);
+        target(he) = to;
+        target(opposite(he)) = from;
         halfedge_properties_.add_elems(2);
         return edge_properties_.add_elem();
       }
@@ -1747,8 +2936,8 @@ namespace owl
       {
         for(auto he : incoming_halfedges(from))
           target(he) = to;
-        incoming(to) = std::move(incoming(from));
-        vertices_[to.index()] = std::move(vertices_[from.index()]);
+        incoming(to) = incoming(from);
+        status(to) = status(from);
         vertex_properties_.move(to.index(), from.index());
         incoming(from).invalidate();
       }
@@ -1760,9 +2949,8 @@ namespace owl
         for(auto he : inner_halfedges(from))
           face(he) = to;
       
-        halfedge(from) = halfedge(to);
-      
-        faces_[to.index()] = std::move(faces_[from.index()]);
+        inner(to) = inner(from);
+        status(to) = status(from);
         face_properties_.move(to.index(), from.index());
       }
     
@@ -1812,16 +3000,26 @@ namespace owl
       
         halfedge_properties_.move(hea1.index(), heb1.index());
         halfedge_properties_.move(hea2.index(), heb2.index());
-        edges_[to.index()] = std::move(edges_[from.index()]);
+        edge_status_[to.index()] = edge_status_[from.index()];
         edge_properties_.move(from.index(), to.index());
       }
     */
     
       
     
-      std::vector<edge_t> edges_;
-      std::vector<vertex_t> vertices_;
-      std::vector<face_t> faces_;
+      //connectivity is stored as structure of arrays so traversals only touch the arrays they read
+      std::vector<halfedge_handle> halfedge_next_;
+      std::vector<halfedge_handle> halfedge_prev_;
+      bool store_prev_ = false;
+      std::vector<vertex_handle> halfedge_target_;
+      std::vector<face_handle> halfedge_face_;
+      std::vector<halfedge_handle> vertex_incoming_;
+      std::vector<halfedge_handle> face_halfedge_;
+
+      std::vector<status_flags> vertex_status_;
+      std::vector<status_flags> halfedge_status_;
+      std::vector<status_flags> edge_status_;
+      std::vector<status_flags> face_status_;
 
       vertex_property_handle<vector3> vertex_position_handle_;
       face_property_handle<vector3> face_normal_handle_;
@@ -1829,10 +3027,10 @@ namespace owl
       halfedge_property_handle<vector3> halfedge_normal_handle_;
       halfedge_property_handle<vector2> halfedge_texcoord_handle_;
     
-      utils::indexed_property_container<vertex_tag> vertex_properties_;
-      utils::indexed_property_container<edge_tag> edge_properties_;
-      utils::indexed_property_container<halfedge_tag> halfedge_properties_;
-      utils::indexed_property_container<face_tag> face_properties_;
+      utils::indexed_property_container<vertex_tag, mesh_index> vertex_properties_;
+      utils::indexed_property_container<edge_tag, mesh_index> edge_properties_;
+      utils::indexed_property_container<halfedge_tag, mesh_index> halfedge_properties_;
+      utils::indexed_property_container<face_tag, mesh_index> face_properties_;
       utils::property_container mesh_properties_;
     };
   
@@ -1845,39 +3043,80 @@ namespace owl
   
     }
   
-    template<typename Scalar>
-    std::size_t num_shells(mesh<Scalar>& mesh)
+    namespace detail
     {
-      std::size_t count = 0;
-      std::vector<bool> visited(mesh.num_faces(), false);
-      for(auto f : mesh.faces())
+      //stores the smallest face of the shell of each face, faces connected over an edge belong to the same shell
+      template<typename Scalar>
+      void find_shell_roots(const mesh<Scalar>& m, std::vector<std::size_t>& roots)
       {
-        if(visited[f.index()])
-          continue;
-        ++count;
-      
-        std::stack<face_handle> stack;
-        stack.push(f);
-        while(!stack.empty())
-        {
-          auto fc = stack.top();
-          visited[fc.index()] = true;
-          stack.pop();
-        
-          for(auto adj_face : mesh.faces(fc))
+        utils::concurrent_union_find shells(m.num_faces());
+        utils::parallel_for(m.edges(), [&](edge_handle e)
           {
-            if(!visited[adj_face.index()])
-              stack.push(adj_face);
-          }
-        }
+            auto he = m.halfedge(e);
+            auto f0 = m.face(he);
+            auto f1 = m.face(m.opposite(he));
+            if(f0.is_valid() && f1.is_valid())
+              shells.unite(f0.index(), f1.index());
+          });
+        roots.resize(m.num_faces());
+        utils::parallel_for(std::size_t(0), roots.size(), [&](std::size_t f){ roots[f] = shells.find(f); });
+      }
+
+      //replaces the roots by consecutive shell indices in order of the first face of each shell,
+      //returns the number of shells
+      inline std::size_t number_shells(std::vector<std::size_t>& shell_ids)
+      {
+        //a root precedes all other faces of its shell, so it is numbered before them
+        std::size_t n = 0;
+        for(std::size_t f = 0; f < shell_ids.size(); ++f)
+          shell_ids[f] = shell_ids[f] == f ? n++ : shell_ids[shell_ids[f]];
+        return n;
       }
+    }
+
+    template<typename Scalar>
+    std::size_t num_shells(const mesh<Scalar>& mesh)
+    {
+      std::vector<std::size_t> roots;
+      detail::find_shell_roots(mesh, roots);
+      std::size_t count = 0;
+      for(std::size_t f = 0; f < roots.size(); ++f)
+        if(roots[f] == f)
+          ++count;
       return count;
     }
+
+    //labels each face with the index of its shell, faces connected over an edge belong to the same shell.
+    //the shells are numbered in order of their first face. adds the face property shell_ids, which the caller
+    //removes when it is no longer needed, returns the number of shells
+    template<typename Scalar>
+    std::size_t label_shells(mesh<Scalar>& m, face_property_handle<std::size_t>& shell_ids)
+    {
+      OWL_PROFILE_FUNCTION();
+      std::vector<std::size_t> ids;
+      detail::find_shell_roots(m, ids);
+      std::size_t n = detail::number_shells(ids);
+      m.add_property(shell_ids, "face_shell");
+      utils::parallel_for(m.faces(), [&](face_handle f){ m.property(shell_ids, f) = ids[f.index()]; });
+      return n;
+    }
+
+    //copies each shell into a mesh of its own including all properties, the shells are ordered by their first
+    //face and copied in parallel. shells touching at a vertex get a copy of it each
+    template<typename Scalar>
+    std::vector<mesh<Scalar>> split_shells(const mesh<Scalar>& m)
+    {
+      OWL_PROFILE_FUNCTION();
+      std::vector<std::size_t> ids;
+      detail::find_shell_roots(m, ids);
+      std::size_t n = detail::number_shells(ids);
+      return m.split(ids, n);
+    }
   
     template<typename Scalar>
     bool is_closed(mesh<Scalar>& mesh)
     {
-      return owl::utils::none_of(mesh.halfedges(),
+      return owl::utils::none_of(owl::utils::execution::par, mesh.halfedges(),
         [&mesh](auto he){ return mesh.is_boundary(he); });
     }
   
@@ -0,0 +1,408 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "owl/math/mesh_io.hpp"
+#include "owl/math/quadric.hpp"
+#include "owl/utils/hash_utils.hpp"
+
+namespace owl
+{
+  namespace math
+  {
+    namespace detail
+    {
+      //accumulated geometry of all input vertices inside one grid cell
+      struct vertex_cluster
+      {
+        quadric<double> q;
+        vector<double, 3> sum = vector<double, 3>(0, 0, 0);
+        std::size_t count = 0;
+      };
+
+      struct cluster_triangle_hash
+      {
+        std::size_t operator()(const std::array<std::uint32_t, 3>& t) const
+        {
+          return utils::hash_value(t.begin(), t.end());
+        }
+      };
+
+      using cluster_cell = std::array<std::int64_t, 3>;
+
+      //hashes all three grid coordinates, cells are compared as a whole on lookup
+      struct cluster_cell_hash
+      {
+        std::size_t operator()(const cluster_cell& cell) const
+        {
+          return utils::hash_value(cell.begin(), cell.end());
+        }
+      };
+
+      //grid coordinate of x in cells, coordinates too large for 64 bit integers are clamped
+      inline std::int64_t cluster_coordinate(double x)
+      {
+        constexpr double bound = 1e18;
+        if(x > -bound && x < bound)
+          return static_cast<std::int64_t>(std::floor(x));
+        return static_cast<std::int64_t>(x > 0 ? bound : -bound);
+      }
+
+      //removes the triangles which share a directed edge with a previous triangle and duplicates each vertex
+      //whose triangles form more than one fan, afterwards the triangles form an oriented 2-manifold.
+      //returns for each vertex the vertex it was copied from
+      inline std::vector<std::uint32_t> make_manifold(std::vector<std::array<std::uint32_t, 3>>& triangles,
+        std::size_t num_vertices)
+      {
+        //the directed edges grouped by their origin, a triangle is kept if none of its edges is used by a
+        //previously kept triangle
+        std::vector<std::size_t> offsets(num_vertices + 1, 0);
+        for(auto& t : triangles)
+          for(auto v : t)
+            ++offsets[v + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<std::uint32_t> edge_targets(3 * triangles.size());
+        std::vector<std::size_t> corner_edges(3 * triangles.size());
+        std::vector<bool> used(3 * triangles.size(), false);
+        {
+          auto cursor = offsets;
+          for(std::size_t c = 0; c < corner_edges.size(); ++c)
+          {
+            std::size_t i = cursor[triangles[c / 3][c % 3]]++;
+            edge_targets[i] = triangles[c / 3][(c + 1) % 3];
+            corner_edges[c] = i;
+          }
+        }
+        auto is_used = [&](std::uint32_t a, std::uint32_t b)
+          {
+            for(std::size_t i = offsets[a]; i < offsets[a + 1]; ++i)
+              if(used[i] && edge_targets[i] == b)
+                return true;
+            return false;
+          };
+        std::size_t num_kept = 0;
+        for(std::size_t t = 0; t < triangles.size(); ++t)
+        {
+          auto& tri = triangles[t];
+          if(is_used(tri[0], tri[1]) || is_used(tri[1], tri[2]) || is_used(tri[2], tri[0]))
+            continue;
+          for(std::size_t k = 0; k < 3; ++k)
+            used[corner_edges[3 * t + k]] = true;
+          triangles[num_kept++] = tri;
+        }
+        triangles.resize(num_kept);
+
+        //the corners of each vertex, a corner is the wedge from the next to the previous vertex of its triangle
+        offsets.assign(num_vertices + 1, 0);
+        for(auto& t : triangles)
+          for(auto v : t)
+            ++offsets[v + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<std::size_t> corners(3 * triangles.size());
+        {
+          auto cursor = offsets;
+          for(std::size_t c = 0; c < corners.size(); ++c)
+            corners[cursor[triangles[c / 3][c % 3]]++] = c;
+        }
+        auto wedge_begin = [&](std::size_t c){ return triangles[c / 3][(c + 1) % 3]; };
+        auto wedge_end = [&](std::size_t c){ return triangles[c / 3][(c + 2) % 3]; };
+
+        //the wedges of a vertex form disjoint chains since every directed edge is unique,
+        //all chains except the first get a copy of the vertex
+        std::vector<std::uint32_t> copied_from(num_vertices);
+        std::iota(copied_from.begin(), copied_from.end(), 0);
+        std::vector<std::size_t> fan;
+        std::vector<bool> visited;
+        for(std::size_t v = 0; v < num_vertices; ++v)
+        {
+          fan.assign(corners.begin() + offsets[v], corners.begin() + offsets[v + 1]);
+          visited.assign(fan.size(), false);
+          auto find = [&](auto&& matches)
+            {
+              for(std::size_t i = 0; i < fan.size(); ++i)
+                if(matches(fan[i]))
+                  return i;
+              return fan.size();
+            };
+          bool first_chain = true;
+          for(std::size_t i = 0; i < fan.size(); ++i)
+          {
+            if(visited[i])
+              continue;
+            //walk back to the start of the chain, a closed chain is started anywhere
+            std::size_t start = i;
+            for(std::size_t j = find([&](std::size_t c){ return wedge_end(c) == wedge_begin(fan[start]); });
+              j != fan.size() && j != i; j = find([&](std::size_t c){ return wedge_end(c) == wedge_begin(fan[start]); }))
+              start = j;
+            std::uint32_t copy = static_cast<std::uint32_t>(v);
+            if(!first_chain)
+            {
+              copy = static_cast<std::uint32_t>(copied_from.size());
+              copied_from.push_back(static_cast<std::uint32_t>(v));
+            }
+            first_chain = false;
+            for(std::size_t j = start; j != fan.size() && !visited[j];
+              j = find([&](std::size_t c){ return wedge_begin(c) == wedge_end(fan[j]); }))
+            {
+              visited[j] = true;
+              triangles[fan[j] / 3][fan[j] % 3] = copy;
+            }
+          }
+        }
+        return copied_from;
+      }
+
+      //streams the vertices and faces of a ply file into the clusters of a uniform grid, apart from a position
+      //and a cluster per input vertex only the clusters and the triangles spanning three clusters are stored
+      template <typename Scalar>
+      class ply_vertex_clustering
+      {
+      public:
+        explicit ply_vertex_clustering(Scalar cell_size)
+          : cell_size_(cell_size)
+        {
+        }
+
+        //the stream parser can not be interrupted, after cancellation the remaining items are only skipped
+        bool read(io::ply_reader& ply)
+        {
+          if(!listen(ply))
+            return false;
+          utils::progress streaming(ply.get_element_count("vertex") + ply.get_element_count("face"));
+          streaming_ = &streaming;
+          bool ok = ply.read();
+          streaming_ = nullptr;
+          return ok && !streaming.is_cancelled();
+        }
+
+        //places each cluster vertex at the point of least quadric error if it lies inside its cell,
+        //at the mean of the clustered vertices otherwise
+        bool build(mesh<Scalar>& result) const
+        {
+          //the clusters are numbered in the order of the input, sorting restores the locality of the input
+          std::vector<std::array<std::uint32_t, 3>> triangles(triangles_.begin(), triangles_.end());
+          std::sort(triangles.begin(), triangles.end());
+          std::vector<std::uint32_t> new_index(clusters_.size(), invalid_index);
+          std::vector<std::uint32_t> used_clusters;
+          for(auto& t : triangles)
+          {
+            for(auto& c : t)
+            {
+              if(new_index[c] == invalid_index)
+              {
+                new_index[c] = static_cast<std::uint32_t>(used_clusters.size());
+                used_clusters.push_back(c);
+              }
+              c = new_index[c];
+            }
+          }
+
+          auto copied_from = make_manifold(triangles, used_clusters.size());
+          std::vector<vector<Scalar, 3>> positions(copied_from.size());
+          for(std::size_t v = 0; v < positions.size(); ++v)
+            positions[v] = representative(clusters_[used_clusters[copied_from[v]]]);
+          std::vector<std::size_t> face_offsets(triangles.size() + 1);
+          std::vector<std::size_t> face_indices;
+          face_indices.reserve(3 * triangles.size());
+          for(std::size_t f = 0; f < triangles.size(); ++f)
+          {
+            face_offsets[f] = 3 * f;
+            face_indices.insert(face_indices.end(), triangles[f].begin(), triangles[f].end());
+          }
+          face_offsets.back() = face_indices.size();
+          result.add_vertices(positions);
+          return add_faces(result, face_offsets, face_indices);
+        }
+
+      private:
+        static constexpr std::uint32_t invalid_index = std::numeric_limits<std::uint32_t>::max();
+
+        bool listen(io::ply_reader& ply)
+        {
+          auto vertex_layout = ply.get_element_layout("vertex");
+          auto face_layout = ply.get_element_layout("face");
+          std::size_t num_coordinates = 0;
+          for(auto& property : vertex_layout)
+          {
+            std::size_t c = property.name == "x" ? 0 : property.name == "y" ? 1 : property.name == "z" ? 2 : 3;
+            if(c == 3 || property.is_list)
+              continue;
+            ++num_coordinates;
+            dispatch_ply_type(property.value_type, [&](auto tag)
+              {
+                using T = decltype(tag);
+                ply.listen_2_element_property<T>("vertex", property.name,
+                  [this, c](const T& value){ position_[c] = static_cast<Scalar>(value); });
+              });
+          }
+          ply.listen_2_element_item_end("vertex", [this](std::size_t){ add_vertex(); });
+
+          bool has_faces = false;
+          for(auto& property : face_layout)
+          {
+            if(property.name != "vertex_indices" || !property.is_list || !is_integral(property.value_type))
+              continue;
+            has_faces = true;
+            dispatch_ply_type(property.value_type, [&](auto tag)
+              {
+                using T = decltype(tag);
+                if constexpr(std::is_integral<T>::value)
+                  ply.listen_2_element_property<T>("face", property.name,
+                    [this](const std::vector<T>& indices){ add_face(indices); });
+              });
+          }
+          return num_coordinates == 3 && has_faces;
+        }
+
+        //returns false once the reading was cancelled
+        bool step()
+        {
+          if(cancelled_)
+            return false;
+          if(++num_items_ % progress_step_size == 0 && !streaming_->step(progress_step_size))
+            cancelled_ = true;
+          return !cancelled_;
+        }
+
+        void add_vertex()
+        {
+          if(!step())
+            return;
+          cluster_cell cell;
+          for(std::size_t c = 0; c < 3; ++c)
+            cell[c] = cluster_coordinate(double(position_[c]) / cell_size_);
+          auto inserted = cluster_indices_.emplace(cell, static_cast<std::uint32_t>(clusters_.size()));
+          if(inserted.second)
+            clusters_.emplace_back();
+          std::uint32_t cluster = inserted.first->second;
+          clusters_[cluster].sum += vector<double, 3>(position_[0], position_[1], position_[2]);
+          ++clusters_[cluster].count;
+          vertex_positions_.push_back(position_);
+          vertex_clusters_.push_back(cluster);
+        }
+
+        template <typename T>
+        void add_face(const std::vector<T>& indices)
+        {
+          if(!step())
+            return;
+          for(auto i : indices)
+            if(static_cast<std::size_t>(i) >= vertex_clusters_.size())
+              return;
+          //polygons are split into a triangle fan
+          for(std::size_t k = 2; k < indices.size(); ++k)
+            add_triangle(static_cast<std::size_t>(indices[0]), static_cast<std::size_t>(indices[k - 1]),
+              static_cast<std::size_t>(indices[k]));
+        }
+
+        //every triangle contributes its area weighted plane to the clusters of its corners
+        //and survives only if its corners lie in three different clusters
+        void add_triangle(std::size_t i0, std::size_t i1, std::size_t i2)
+        {
+          vector<double, 3> p[3];
+          std::size_t corners[3] = {i0, i1, i2};
+          for(std::size_t k = 0; k < 3; ++k)
+            for(std::size_t c = 0; c < 3; ++c)
+              p[k][c] = vertex_positions_[corners[k]][c];
+          vector<double, 3> n = cross(p[1] - p[0], p[2] - p[0]);
+          double area = n.length() / 2;
+          if(area > 0)
+          {
+            n /= 2 * area;
+            auto plane = quadric<double>::plane(n, -dot(n, p[0]), area);
+            for(auto i : corners)
+              clusters_[vertex_clusters_[i]].q += plane;
+          }
+
+          std::array<std::uint32_t, 3> t = {vertex_clusters_[i0], vertex_clusters_[i1], vertex_clusters_[i2]};
+          if(t[0] == t[1] || t[1] == t[2] || t[2] == t[0])
+            return;
+          //the rotation starting at the smallest cluster identifies the triangle, its orientation is kept
+          std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+          triangles_.insert(t);
+        }
+
+        vector<Scalar, 3> representative(const vertex_cluster& cluster) const
+        {
+          vector<double, 3> mean = cluster.sum;
+          mean /= static_cast<double>(cluster.count);
+          vector<double, 3> p;
+          if(!cluster.q.minimizer(p))
+            return vector<Scalar, 3>(mean[0], mean[1], mean[2]);
+          for(std::size_t c = 0; c < 3; ++c)
+          {
+            double lower = std::floor(mean[c] / cell_size_) * cell_size_;
+            if(p[c] < lower || p[c] > lower + cell_size_)
+              return vector<Scalar, 3>(mean[0], mean[1], mean[2]);
+          }
+          return vector<Scalar, 3>(p[0], p[1], p[2]);
+        }
+
+        Scalar cell_size_;
+        vector<Scalar, 3> position_ = vector<Scalar, 3>(0, 0, 0);
+        utils::progress* streaming_ = nullptr;
+        std::size_t num_items_ = 0;
+        bool cancelled_ = false;
+        //the faces reference the vertices by index, so the positions and clusters of the input vertices are kept
+        std::vector<vector<Scalar, 3>> vertex_positions_;
+        std::vector<std::uint32_t> vertex_clusters_;
+        std::unordered_map<cluster_cell, std::uint32_t, cluster_cell_hash> cluster_indices_;
+        std::vector<vertex_cluster> clusters_;
+        std::unordered_set<std::array<std::uint32_t, 3>, cluster_triangle_hash> triangles_;
+      };
+    }
+
+    //simplifies the mesh stored in the ply file at p while it is read by merging all vertices inside the cells of
+    //a uniform grid with given cell size (lindstrom 2000), only triangles spanning three cells are kept.
+    //the input is never built as mesh. unlike a soup of triangles with inline positions, ply faces reference
+    //vertices by index, so a position and a cluster per input vertex are kept until the faces are read, which
+    //is the only memory growing with the input. the clusters and triangles grow with the output. polygons are
+    //triangulated, the result may be non manifold where the grid is too coarse for
+    //thin features, such faces are skipped.
+    //returns false if the file could not be read or reading was cancelled
+    template <typename Scalar>
+    bool simplify_ply(math::mesh<Scalar>& result, const std::string& p, Scalar cell_size)
+    {
+      OWL_PROFILE_SCOPE("simplify_ply");
+      assert(cell_size > 0);
+      result.clear();
+      io::ply_reader ply;
+      ply.open(p);
+      if(!ply.is_open())
+        return false;
+
+      detail::ply_vertex_clustering<Scalar> clustering(cell_size);
+
+      utils::progress simplifying(2);
+      simplifying.make_current(1);
+      bool read = clustering.read(ply);
+      simplifying.resign_current();
+      if(!read)
+        return false;
+      simplifying.make_current(1);
+      bool built = clustering.build(result);
+      simplifying.resign_current();
+      if(!built)
+        result.clear();
+      return built;
+    }
+  }
+}
@@ -0,0 +1,624 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "owl/io/buffered_writer.hpp"
+#include "owl/io/range_coder.hpp"
+#include "owl/math/mesh.hpp"
+#include "owl/utils/mapped_file.hpp"
+#include "owl/utils/parallel.hpp"
+#include "owl/utils/profiler.hpp"
+
+namespace owl
+{
+  namespace math
+  {
+    namespace detail
+    {
+      //a gate is an edge of the boundary between the coded triangles and the remaining ones, the triangle behind
+      //the gate is coded next when the gate is popped. the gates form cyclic loops linked by prev and next
+      struct compression_gate
+      {
+        std::size_t from;
+        std::size_t to;
+        //third vertex of the coded triangle in front of the gate used for parallelogram prediction
+        std::size_t opposite;
+        std::size_t prev;
+        std::size_t next;
+        //halfedge of the triangle behind the gate, only used by the encoder
+        std::size_t halfedge;
+        bool live;
+      };
+
+      //edgebreaker style front of gate loops which is updated identically by encoder and decoder, so only the
+      //symbol of each triangle and the vertex references which can not be derived from the front are coded
+      class compression_front
+      {
+      public:
+        enum symbol : std::size_t
+        {
+          //the third vertex of the triangle is new
+          create,
+          //the triangle also closes the previous, the next or both neighbor gates of the gate
+          left,
+          right,
+          end,
+          //the third vertex starts a gate further ahead in the loop, which is split there into two loops
+          split,
+          //the third vertex is referenced by its index
+          merge,
+          //there is no uncoded triangle behind the gate
+          boundary,
+          num_symbols
+        };
+
+        const compression_gate& operator[](std::size_t g) const
+        {
+          return gates_[g];
+        }
+
+        //starts a new front around triangle v0, v1, v2, he0 is the halfedge behind the edge v0 v1 and so on
+        void seed(std::size_t v0, std::size_t v1, std::size_t v2, std::size_t he0, std::size_t he1, std::size_t he2)
+        {
+          std::size_t g0 = add_gate(v1, v0, v2, he0);
+          std::size_t g1 = add_gate(v2, v1, v0, he1);
+          std::size_t g2 = add_gate(v0, v2, v1, he2);
+          link(g0, g2);
+          link(g2, g1);
+          link(g1, g0);
+        }
+
+        //pops the next live gate, returns false if there is none
+        bool pop(std::size_t& g)
+        {
+          while(!stack_.empty())
+          {
+            g = stack_.back();
+            stack_.pop_back();
+            if(gates_[g].live)
+              return true;
+          }
+          return false;
+        }
+
+        bool can_close_left(std::size_t g) const
+        {
+          return gates_[g].prev != g && gates_[g].prev != gates_[g].next;
+        }
+
+        bool can_close_right(std::size_t g) const
+        {
+          return can_close_left(g);
+        }
+
+        //returns the number of gates between the gate after next(g) and the first gate starting at v
+        //or max_offset if there is none within max_offset gates
+        std::size_t split_offset(std::size_t g, std::size_t v, std::size_t max_offset) const
+        {
+          std::size_t offset = 0;
+          for(std::size_t q = gates_[gates_[g].next].next; q != g && offset < max_offset; q = gates_[q].next, ++offset)
+            if(gates_[q].from == v)
+              return offset;
+          return max_offset;
+        }
+
+        //returns the gate at given split_offset or g if the loop is shorter
+        std::size_t split_gate(std::size_t g, std::size_t offset) const
+        {
+          if(gates_[g].next == g)
+            return g;
+          std::size_t q = gates_[gates_[g].next].next;
+          for(; q != g && offset > 0; --offset)
+            q = gates_[q].next;
+          return q;
+        }
+
+        //replaces gate g by the two other edges of the triangle behind it with third vertex v. he1 and he2 are
+        //the halfedges behind the new edges from(g) v and v to(g), q is the split gate of a split
+        void attach(std::size_t g, symbol s, std::size_t v, std::size_t q, std::size_t he1, std::size_t he2)
+        {
+          auto gate = gates_[g];
+          gates_[g].live = false;
+          std::size_t p = gate.prev;
+          std::size_t n = gate.next;
+          if(s == left)
+          {
+            gates_[p].live = false;
+            std::size_t e2 = add_gate(v, gate.to, gate.from, he2);
+            link(gates_[p].prev, e2);
+            link(e2, n);
+          }
+          else if(s == right)
+          {
+            gates_[n].live = false;
+            std::size_t e1 = add_gate(gate.from, v, gate.to, he1);
+            link(p, e1);
+            link(e1, gates_[n].next);
+          }
+          else if(s == end)
+          {
+            gates_[p].live = false;
+            gates_[n].live = false;
+            if(gates_[p].prev != n)
+              link(gates_[p].prev, gates_[n].next);
+          }
+          else
+          {
+            std::size_t e1 = add_gate(gate.from, v, gate.to, he1);
+            std::size_t e2 = add_gate(v, gate.to, gate.from, he2);
+            if(s == split)
+            {
+              std::size_t r = gates_[q].prev;
+              link(p, e1);
+              link(e1, q);
+              link(r, e2);
+              link(e2, n);
+            }
+            else if(p == g)
+            {
+              link(e1, e2);
+              link(e2, e1);
+            }
+            else
+            {
+              link(p, e1);
+              link(e1, e2);
+              link(e2, n);
+            }
+          }
+        }
+
+        //removes gate g which has no triangle behind it
+        void close(std::size_t g)
+        {
+          gates_[g].live = false;
+          if(gates_[g].next != g)
+            link(gates_[g].prev, gates_[g].next);
+        }
+
+      private:
+        std::size_t add_gate(std::size_t from, std::size_t to, std::size_t opposite, std::size_t halfedge)
+        {
+          gates_.push_back({from, to, opposite, gates_.size(), gates_.size(), halfedge, true});
+          stack_.push_back(gates_.size() - 1);
+          return gates_.size() - 1;
+        }
+
+        void link(std::size_t a, std::size_t b)
+        {
+          gates_[a].next = b;
+          gates_[b].prev = a;
+        }
+
+        std::vector<compression_gate> gates_;
+        std::vector<std::size_t> stack_;
+      };
+
+      constexpr char compression_magic[4] = {'o', 'w', 'l', 'c'};
+      constexpr std::uint64_t compression_version = 1;
+      //longest walk along a loop to find the gate of a split, farther vertices are coded by index
+      constexpr std::size_t max_split_offset = 1 << 12;
+      //signed residuals are coded by their bit length and sign followed by the bits below the leading one
+      constexpr std::size_t max_residual_length = 32;
+      constexpr std::size_t num_residual_symbols = 2 * max_residual_length + 1;
+
+      inline std::size_t bit_length(std::uint64_t x)
+      {
+        std::size_t n = 0;
+        for(; x != 0; x >>= 1)
+          ++n;
+        return n;
+      }
+
+      inline void encode_residual(io::range_encoder& out, io::adaptive_model& model, std::int64_t r)
+      {
+        std::uint64_t magnitude = r < 0 ? 0 - static_cast<std::uint64_t>(r) : static_cast<std::uint64_t>(r);
+        std::size_t length = bit_length(magnitude);
+        out.encode(length == 0 ? 0 : 2 * length - (r > 0), model);
+        if(length > 1)
+          out.encode_bits(magnitude, length - 1);
+      }
+
+      inline std::int64_t decode_residual(io::range_decoder& in, io::adaptive_model& model)
+      {
+        std::size_t s = in.decode(model);
+        if(s == 0)
+          return 0;
+        std::size_t length = (s + 1) / 2;
+        std::int64_t magnitude = static_cast<std::int64_t>((std::uint64_t(1) << (length - 1))
+          | (length > 1 ? in.decode_bits(length - 1) : 0));
+        return s % 2 == 1 ? magnitude : -magnitude;
+      }
+
+      //adaptive models of the compressed streams, connectivity symbols are conditioned on the previous symbol
+      struct compression_models
+      {
+        compression_models()
+          : symbols(compression_front::num_symbols + 1, io::adaptive_model(compression_front::num_symbols))
+          , seeds(2)
+          , offsets(num_residual_symbols)
+          , predicted(3, io::adaptive_model(num_residual_symbols))
+          , unpredicted(3, io::adaptive_model(num_residual_symbols))
+        {
+        }
+
+        std::vector<io::adaptive_model> symbols;
+        io::adaptive_model seeds;
+        io::adaptive_model offsets;
+        std::vector<io::adaptive_model> predicted;
+        std::vector<io::adaptive_model> unpredicted;
+      };
+
+      using quantized_position = std::array<std::int64_t, 3>;
+
+      //parallelogram prediction of the vertex opposite to w across the edge a b, clamped to the quantization grid
+      inline quantized_position predict_position(const quantized_position& a, const quantized_position& b,
+        const quantized_position& w, std::int64_t max_coordinate)
+      {
+        quantized_position p;
+        for(std::size_t i = 0; i < 3; ++i)
+          p[i] = std::clamp(a[i] + b[i] - w[i], std::int64_t(0), max_coordinate);
+        return p;
+      }
+
+      inline void encode_double(io::range_encoder& out, double x)
+      {
+        std::uint64_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        out.encode_bits(bits, 64);
+      }
+
+      inline double decode_double(io::range_decoder& in)
+      {
+        std::uint64_t bits = in.decode_bits(64);
+        double x;
+        std::memcpy(&x, &bits, sizeof(x));
+        return x;
+      }
+    }
+
+    //compresses the positions and faces of a triangle mesh into bytes. positions are quantized to position_bits
+    //bits per coordinate on a uniform grid over mesh::bounds() and predicted by parallelograms across the edge
+    //of the triangle they are reached from. the connectivity is traversed edgebreaker style, which codes most
+    //triangles by one of a handful of symbols. symbols and residuals are entropy coded by an adaptive range
+    //coder. vertices and faces are stored in traversal order, properties are not stored. returns false if the
+    //mesh has non triangular faces or position_bits is not in [1, 30]
+    template <typename Scalar>
+    bool compress(const mesh<Scalar>& m, std::vector<std::uint8_t>& bytes, std::size_t position_bits = 16)
+    {
+      OWL_PROFILE_FUNCTION();
+      using front_type = detail::compression_front;
+      if(position_bits < 1 || position_bits > 30 || !m.is_triangle_mesh())
+        return false;
+
+      std::size_t nv = m.num_vertices();
+      std::size_t nf = m.num_faces();
+      std::array<double, 3> lower = {0, 0, 0};
+      double step = 0;
+      if(nv > 0)
+      {
+        auto box = m.bounds();
+        auto extents = box.extents();
+        for(std::size_t i = 0; i < 3; ++i)
+        {
+          lower[i] = box.lower_bound[i];
+          step = std::max(step, double(extents[i]));
+        }
+        step /= (std::int64_t(1) << position_bits) - 1;
+      }
+      std::int64_t max_coordinate = (std::int64_t(1) << position_bits) - 1;
+      std::vector<detail::quantized_position> quantized(nv);
+      utils::parallel_for(std::size_t(0), nv, [&](std::size_t v)
+        {
+          const auto& p = m.position(vertex_handle(static_cast<mesh_index>(v)));
+          for(std::size_t i = 0; i < 3; ++i)
+            quantized[v][i] = step > 0 ? std::clamp(std::llround((p[i] - lower[i]) / step),
+              0ll, static_cast<long long>(max_coordinate)) : 0;
+        });
+
+      bytes.assign(std::begin(detail::compression_magic), std::end(detail::compression_magic));
+      io::range_encoder out(bytes);
+      out.encode_bits(detail::compression_version, 8);
+      out.encode_bits(position_bits, 8);
+      out.encode_bits(nv, 64);
+      out.encode_bits(nf, 64);
+      for(double x : lower)
+        detail::encode_double(out, x);
+      detail::encode_double(out, step);
+
+      constexpr std::size_t no_id = std::numeric_limits<std::size_t>::max();
+      detail::compression_models models;
+      front_type front;
+      std::size_t index_bits = detail::bit_length(nv);
+      std::vector<std::size_t> ids(nv, no_id);
+      std::vector<std::size_t> vertices;
+      vertices.reserve(nv);
+      std::vector<std::uint8_t> coded(nf, 0);
+      std::size_t num_coded = 0;
+      std::size_t next_seed = 0;
+      std::size_t last_symbol = front_type::num_symbols;
+
+      //assigns the next id to v and codes its position as residual of the prediction
+      auto add_vertex = [&](std::size_t v, const detail::quantized_position& prediction,
+        std::vector<io::adaptive_model>& residual_models)
+        {
+          ids[v] = vertices.size();
+          vertices.push_back(v);
+          for(std::size_t i = 0; i < 3; ++i)
+            detail::encode_residual(out, residual_models[i], quantized[v][i] - prediction[i]);
+        };
+      auto last_position = [&]
+        {
+          return vertices.empty() ? detail::quantized_position{0, 0, 0} : quantized[vertices.back()];
+        };
+
+      while(num_coded < nf)
+      {
+        std::size_t g;
+        if(!front.pop(g))
+        {
+          while(coded[next_seed])
+            ++next_seed;
+          auto he0 = m.inner(face_handle(static_cast<mesh_index>(next_seed)));
+          auto he1 = m.next(he0);
+          auto he2 = m.next(he1);
+          std::array<std::size_t, 3> corners = {m.origin(he0).index(), m.origin(he1).index(), m.origin(he2).index()};
+          for(auto v : corners)
+          {
+            out.encode(ids[v] == no_id ? 0 : 1, models.seeds);
+            if(ids[v] == no_id)
+              add_vertex(v, last_position(), models.unpredicted);
+            else
+              out.encode_bits(ids[v], index_bits);
+          }
+          front.seed(ids[corners[0]], ids[corners[1]], ids[corners[2]], m.opposite(he0).index(),
+            m.opposite(he1).index(), m.opposite(he2).index());
+          coded[next_seed] = 1;
+          ++num_coded;
+          continue;
+        }
+
+        auto gate = front[g];
+        auto he = halfedge_handle(static_cast<mesh_index>(gate.halfedge));
+        auto f = m.face(he);
+        auto& symbols = models.symbols[last_symbol];
+        if(!f.is_valid() || coded[f.index()])
+        {
+          out.encode(last_symbol = front_type::boundary, symbols);
+          front.close(g);
+          continue;
+        }
+        coded[f.index()] = 1;
+        ++num_coded;
+
+        auto he_next = m.next(he);
+        auto he_prev = m.next(he_next);
+        std::size_t v = m.target(he_next).index();
+        bool closes_left = front.can_close_left(g) && front[gate.prev].halfedge == he_prev.index();
+        bool closes_right = front.can_close_right(g) && front[gate.next].halfedge == he_next.index();
+        std::size_t q = g;
+        front_type::symbol s;
+        if(ids[v] == no_id)
+          s = front_type::create;
+        else if(closes_left && closes_right)
+          s = front_type::end;
+        else if(closes_left)
+          s = front_type::left;
+        else if(closes_right)
+          s = front_type::right;
+        else
+        {
+          std::size_t offset = front.split_offset(g, ids[v], detail::max_split_offset);
+          s = offset < detail::max_split_offset ? front_type::split : front_type::merge;
+          out.encode(last_symbol = s, symbols);
+          if(s == front_type::split)
+          {
+            detail::encode_residual(out, models.offsets, static_cast<std::int64_t>(offset));
+            q = front.split_gate(g, offset);
+          }
+          else
+          {
+            out.encode_bits(ids[v], index_bits);
+          }
+        }
+        if(s != front_type::split && s != front_type::merge)
+          out.encode(last_symbol = s, symbols);
+        if(s == front_type::create)
+          add_vertex(v, detail::predict_position(quantized[vertices[gate.from]], quantized[vertices[gate.to]],
+            quantized[vertices[gate.opposite]], max_coordinate), models.predicted);
+        front.attach(g, s, ids[v], q, m.opposite(he_prev).index(), m.opposite(he_next).index());
+      }
+
+      //vertices without faces
+      for(std::size_t v = 0; v < nv; ++v)
+        if(ids[v] == no_id)
+          add_vertex(v, last_position(), models.unpredicted);
+      out.finish();
+      return true;
+    }
+
+    //restores a mesh compressed by compress, returns false and leaves the mesh unchanged if the bytes are not
+    //a valid compressed mesh
+    template <typename Scalar>
+    bool decompress(mesh<Scalar>& m, const std::uint8_t* data, std::size_t size)
+    {
+      OWL_PROFILE_FUNCTION();
+      using front_type = detail::compression_front;
+      constexpr std::size_t magic_size = sizeof(detail::compression_magic);
+      if(size < magic_size || std::memcmp(data, detail::compression_magic, magic_size) != 0)
+        return false;
+      io::range_decoder in(data + magic_size, data + size);
+      std::size_t version = in.decode_bits(8);
+      std::size_t position_bits = in.decode_bits(8);
+      std::size_t nv = in.decode_bits(64);
+      std::size_t nf = in.decode_bits(64);
+      std::array<double, 3> lower;
+      for(auto& x : lower)
+        x = detail::decode_double(in);
+      double step = detail::decode_double(in);
+      if(version != detail::compression_version || position_bits < 1 || position_bits > 30 || in.overrun())
+        return false;
+
+      std::int64_t max_coordinate = (std::int64_t(1) << position_bits) - 1;
+      detail::compression_models models;
+      front_type front;
+      std::size_t index_bits = detail::bit_length(nv);
+      //the counts are not trusted for allocations before the data confirms them
+      std::vector<detail::quantized_position> quantized;
+      quantized.reserve(std::min(nv, 8 * size));
+      std::vector<std::size_t> face_indices;
+      face_indices.reserve(3 * std::min(nf, 8 * size));
+      std::size_t last_symbol = front_type::num_symbols;
+
+      auto add_vertex = [&](const detail::quantized_position& prediction,
+        std::vector<io::adaptive_model>& residual_models)
+        {
+          if(quantized.size() == nv)
+            return false;
+          detail::quantized_position p;
+          for(std::size_t i = 0; i < 3; ++i)
+            p[i] = prediction[i] + detail::decode_residual(in, residual_models[i]);
+          quantized.push_back(p);
+          return true;
+        };
+      auto last_position = [&]
+        {
+          return quantized.empty() ? detail::quantized_position{0, 0, 0} : quantized.back();
+        };
+
+      while(face_indices.size() < 3 * nf)
+      {
+        if(in.overrun())
+          return false;
+        std::size_t g;
+        if(!front.pop(g))
+        {
+          std::array<std::size_t, 3> corners;
+          for(auto& c : corners)
+          {
+            if(in.decode(models.seeds) == 0)
+            {
+              c = quantized.size();
+              if(!add_vertex(last_position(), models.unpredicted))
+                return false;
+            }
+            else
+            {
+              c = in.decode_bits(index_bits);
+              if(c >= quantized.size())
+                return false;
+            }
+          }
+          front.seed(corners[0], corners[1], corners[2], 0, 0, 0);
+          face_indices.insert(face_indices.end(), corners.begin(), corners.end());
+          continue;
+        }
+
+        auto gate = front[g];
+        auto s = static_cast<front_type::symbol>(in.decode(models.symbols[last_symbol]));
+        last_symbol = s;
+        if(s == front_type::boundary)
+        {
+          front.close(g);
+          continue;
+        }
+        std::size_t v = quantized.size();
+        std::size_t q = g;
+        if(s == front_type::create)
+        {
+          if(!add_vertex(detail::predict_position(quantized[gate.from], quantized[gate.to], quantized[gate.opposite],
+            max_coordinate), models.predicted))
+            return false;
+        }
+        else if(s == front_type::left || s == front_type::right || s == front_type::end)
+        {
+          if(!front.can_close_left(g))
+            return false;
+          v = s == front_type::right ? front[gate.next].to : front[gate.prev].from;
+        }
+        else if(s == front_type::split)
+        {
+          std::int64_t offset = detail::decode_residual(in, models.offsets);
+          if(offset < 0 || offset >= static_cast<std::int64_t>(detail::max_split_offset))
+            return false;
+          q = front.split_gate(g, static_cast<std::size_t>(offset));
+          if(q == g)
+            return false;
+          v = front[q].from;
+        }
+        else
+        {
+          v = in.decode_bits(index_bits);
+          if(v >= quantized.size())
+            return false;
+        }
+        front.attach(g, s, v, q, 0, 0);
+        face_indices.insert(face_indices.end(), {gate.from, gate.to, v});
+      }
+      while(quantized.size() < nv && !in.overrun())
+        add_vertex(last_position(), models.unpredicted);
+      if(in.overrun())
+        return false;
+
+      std::vector<vector<Scalar, 3>> positions(nv);
+      utils::parallel_for(std::size_t(0), nv, [&](std::size_t v)
+        {
+          for(std::size_t i = 0; i < 3; ++i)
+            positions[v][i] = static_cast<Scalar>(lower[i] + quantized[v][i] * step);
+        });
+      std::vector<std::size_t> face_offsets(nf + 1);
+      for(std::size_t f = 0; f <= nf; ++f)
+        face_offsets[f] = 3 * f;
+      mesh<Scalar> result;
+      result.add_vertices(positions);
+      //build_faces rejects vertices where several fans of faces meet, such meshes are linked face by face
+      if(!result.build_faces(face_offsets, face_indices))
+        for(std::size_t f = 0; f < nf; ++f)
+          if(!result.add_face(vertex_handle(static_cast<mesh_index>(face_indices[3 * f])),
+            vertex_handle(static_cast<mesh_index>(face_indices[3 * f + 1])),
+            vertex_handle(static_cast<mesh_index>(face_indices[3 * f + 2]))).is_valid())
+            return false;
+      m = std::move(result);
+      return true;
+    }
+
+    //writes the mesh compressed by compress, see there
+    template <typename Scalar>
+    bool write_owlc(const mesh<Scalar>& m, const std::string& p, std::size_t position_bits = 16)
+    {
+      OWL_PROFILE_SCOPE("write_owlc");
+      std::vector<std::uint8_t> bytes;
+      if(!compress(m, bytes, position_bits))
+        return false;
+      io::buffered_writer out(p);
+      if(!out.is_open())
+        return false;
+      out.write(bytes.data(), bytes.size());
+      return out.close();
+    }
+
+    template <typename Scalar>
+    bool read_owlc(mesh<Scalar>& m, const std::string& p)
+    {
+      OWL_PROFILE_SCOPE("read_owlc");
+      utils::mapped_file file(p);
+      return file.is_open() && decompress(m, file.data(), file.size());
+    }
+  }
+}
@@ -0,0 +1,222 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "owl/math/mesh.hpp"
+#include "owl/math/quadric.hpp"
+#include "owl/utils/mutable_priority_queue.hpp"
+#include "owl/utils/parallel.hpp"
+#include "owl/utils/profiler.hpp"
+#include "owl/utils/progress.hpp"
+
+namespace owl
+{
+  namespace math
+  {
+    namespace detail
+    {
+      //edge collapses ordered by the quadric error of the merged vertex at its optimal position
+      template <typename Scalar>
+      class quadric_decimater
+      {
+      public:
+        using vector3 = vector<Scalar, 3>;
+
+        //boundary edges are kept in place by planes perpendicular to their face, weighted by this factor
+        static constexpr Scalar boundary_weight = 1000;
+
+        explicit quadric_decimater(mesh<Scalar>& m)
+          : m_(m)
+        {
+          m_.add_property(quadrics_, "vertex_quadric");
+        }
+
+        ~quadric_decimater()
+        {
+          m_.remove_property(quadrics_);
+        }
+
+        bool decimate(std::size_t target_faces, Scalar max_error)
+        {
+          std::size_t num_faces = m_.num_faces();
+          utils::progress decimating(num_faces > target_faces ? num_faces - target_faces : 0);
+          init_quadrics();
+          init_queue();
+
+          std::size_t num_removed = 0;
+          while(num_faces > target_faces && !queue_.empty() && queue_.top_priority() <= max_error)
+          {
+            edge_handle e(static_cast<mesh_index>(queue_.top()));
+            queue_.pop();
+            if(m_.status(e).is_removed())
+              continue;
+            vector3 p;
+            evaluate(e, p);
+            auto he = m_.halfedge(e);
+            if(!is_legal(he, p))
+            {
+              he = m_.opposite(he);
+              if(!is_legal(he, p))
+                continue;
+            }
+
+            std::size_t num_faces_collapsed = !m_.is_boundary(he) + !m_.is_boundary(m_.opposite(he));
+            auto v = m_.target(he);
+            m_.property(quadrics_, v) += m_.property(quadrics_, m_.origin(he));
+            m_.collapse(he);
+            m_.position(v) = p;
+            for(auto in : m_.incoming_halfedges(v))
+            {
+              auto e_in = m_.edge(in);
+              vector3 p_in;
+              queue_.push(e_in.index(), evaluate(e_in, p_in));
+            }
+
+            num_faces -= num_faces_collapsed;
+            num_removed += num_faces_collapsed;
+            if(num_removed >= progress_step_size)
+            {
+              if(!decimating.step(num_removed))
+                return false;
+              num_removed = 0;
+            }
+          }
+          return true;
+        }
+
+      private:
+        static constexpr std::size_t progress_step_size = 1 << 14;
+
+        //sums the area weighted plane quadrics of the faces around each vertex, faces and vertices are
+        //processed in parallel without atomics by gathering from the faces
+        void init_quadrics()
+        {
+          std::vector<quadric<Scalar>> face_quadrics(m_.num_faces());
+          std::vector<vector3> face_normals(m_.num_faces());
+          utils::parallel_for(m_.faces(), [&](face_handle f)
+            {
+              auto he = m_.inner(f);
+              const auto& p0 = m_.position(m_.target(he));
+              const auto& p1 = m_.position(m_.target(m_.next(he)));
+              const auto& p2 = m_.position(m_.target(m_.next(m_.next(he))));
+              vector3 n = cross(p1 - p0, p2 - p0);
+              Scalar area = n.length() / 2;
+              if(area > 0)
+                n /= 2 * area;
+              face_normals[f.index()] = n;
+              face_quadrics[f.index()] = quadric<Scalar>::plane(n, -dot(n, p0), area);
+            });
+
+          utils::parallel_for(m_.vertices(), [&](vertex_handle v)
+            {
+              quadric<Scalar> q;
+              for(auto in : m_.incoming_halfedges(v))
+              {
+                if(!m_.is_boundary(in))
+                  q += face_quadrics[m_.face(in).index()];
+                if(!m_.is_boundary(m_.edge(in)))
+                  continue;
+                auto he = m_.is_boundary(in) ? m_.opposite(in) : in;
+                const auto& a = m_.position(m_.origin(he));
+                const auto& b = m_.position(m_.target(he));
+                vector3 n = cross(b - a, face_normals[m_.face(he).index()]);
+                Scalar length = n.length();
+                if(length > 0)
+                  q += quadric<Scalar>::plane(n / length, -dot(n, a) / length, boundary_weight * sqr_length(b - a));
+              }
+              m_.property(quadrics_, v) = q;
+            });
+        }
+
+        void init_queue()
+        {
+          std::vector<typename utils::mutable_priority_queue<Scalar>::entry> entries(m_.num_edges());
+          utils::parallel_for(m_.edges(), [&](edge_handle e)
+            {
+              vector3 p;
+              entries[e.index()] = {evaluate(e, p), e.index()};
+            });
+          queue_.assign(m_.num_edges(), std::move(entries));
+        }
+
+        //computes the position of the merged vertex and returns its error,
+        //falls back to the best of the end points and the midpoint if the optimal position is not unique
+        Scalar evaluate(edge_handle e, vector3& p) const
+        {
+          auto he = m_.halfedge(e);
+          auto q = m_.property(quadrics_, m_.origin(he)) + m_.property(quadrics_, m_.target(he));
+          if(!q.minimizer(p))
+          {
+            const auto& p0 = m_.position(m_.origin(he));
+            const auto& p1 = m_.position(m_.target(he));
+            p = (p0 + p1) / 2;
+            for(const auto& candidate : {p0, p1})
+              if(q.error(candidate) < q.error(p))
+                p = candidate;
+          }
+          return std::max<Scalar>(q.error(p), 0);
+        }
+
+        //the collapse of he with the merged vertex at p has to keep the mesh manifold and must not flip a face
+        bool is_legal(halfedge_handle he, const vector3& p) const
+        {
+          if(!m_.is_collapsable(he))
+            return false;
+          auto f0 = m_.face(he);
+          auto f1 = m_.face(m_.opposite(he));
+          for(auto v : {m_.origin(he), m_.target(he)})
+          {
+            const auto& pv = m_.position(v);
+            for(auto in : m_.incoming_halfedges(v))
+            {
+              auto f = m_.face(in);
+              if(!f.is_valid() || f == f0 || f == f1)
+                continue;
+              const auto& a = m_.position(m_.origin(in));
+              const auto& b = m_.position(m_.target(m_.next(in)));
+              if(dot(cross(pv - a, b - a), cross(p - a, b - a)) <= 0)
+                return false;
+            }
+          }
+          return true;
+        }
+
+        mesh<Scalar>& m_;
+        vertex_property_handle<quadric<Scalar>> quadrics_;
+        utils::mutable_priority_queue<Scalar> queue_;
+      };
+    }
+
+    //simplifies a triangle mesh by collapsing the edges of least quadric error until it has at most target_faces
+    //faces or the error of the next collapse would exceed max_error, the error is the area weighted sum of squared
+    //distances to the planes of the merged faces. the merged vertex is placed at the position of least error,
+    //collapses which would make the mesh non manifold or flip a face are skipped.
+    //the removed elements are erased by garbage_collection() at the end.
+    //returns false if the decimation was cancelled, the mesh is then partially decimated
+    template <typename Scalar>
+    bool decimate(mesh<Scalar>& m, std::size_t target_faces,
+      Scalar max_error = std::numeric_limits<Scalar>::max())
+    {
+      OWL_PROFILE_FUNCTION();
+      assert(m.is_triangle_mesh());
+      bool completed;
+      {
+        detail::quadric_decimater<Scalar> decimater(m);
+        completed = decimater.decimate(target_faces, max_error);
+      }
+      m.garbage_collection();
+      return completed;
+    }
+  }
+}
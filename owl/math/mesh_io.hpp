@@ -9,20 +9,441 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
 #include "owl/color/color.hpp"
 #include "owl/math/mesh.hpp"
+#include "owl/math/mesh_compression.hpp"
+#include "owl/math/mesh_snapshot.hpp"
+#include "owl/math/mesh_welding.hpp"
 #include "owl/io/ply.hpp"
 #include "owl/io/off.hpp"
+#include "owl/io/ascii_reader.hpp"
+#include "owl/io/buffered_writer.hpp"
 #include "owl/utils/file_utils.hpp"
-//#include "owl/utils/progress.hpp"
+#include "owl/utils/mapped_file.hpp"
+#include "owl/utils/profiler.hpp"
+#include "owl/utils/progress.hpp"
 
 namespace owl
 {
   namespace math
   {
+    namespace detail
+    {
+      template <typename T>
+      inline T load_ply_value(const std::uint8_t* p, bool swap)
+      {
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        if(swap)
+        {
+          auto bytes = reinterpret_cast<unsigned char*>(&value);
+          std::reverse(bytes, bytes + sizeof(T));
+        }
+        return value;
+      }
+
+      inline bool host_is_little_endian()
+      {
+        const std::uint16_t one = 1;
+        std::uint8_t first_byte;
+        std::memcpy(&first_byte, &one, 1);
+        return first_byte == 1;
+      }
+
+      //calls fn with a value of the c++ type matching the given ply type
+      template <typename Fn>
+      void dispatch_ply_type(io::ply_reader::scalar_type type, Fn&& fn)
+      {
+        using type_t = io::ply_reader::scalar_type;
+        switch(type)
+        {
+          case type_t::int8: fn(std::int8_t{}); break;
+          case type_t::uint8: fn(std::uint8_t{}); break;
+          case type_t::int16: fn(std::int16_t{}); break;
+          case type_t::uint16: fn(std::uint16_t{}); break;
+          case type_t::int32: fn(std::int32_t{}); break;
+          case type_t::uint32: fn(std::uint32_t{}); break;
+          case type_t::float32: fn(float{}); break;
+          case type_t::float64: fn(double{}); break;
+        }
+      }
+
+      inline bool is_integral(io::ply_reader::scalar_type type)
+      {
+        return type != io::ply_reader::scalar_type::float32 && type != io::ply_reader::scalar_type::float64;
+      }
+
+      //byte size of one item of an element or 0 if the element contains list properties
+      inline std::size_t ply_element_stride(const std::vector<io::ply_reader::property_layout>& layout)
+      {
+        std::size_t stride = 0;
+        for(auto& p : layout)
+        {
+          if(p.is_list)
+            return 0;
+          stride += io::size_of(p.value_type);
+        }
+        return stride;
+      }
+
+      //copies the ply component at byte offset of count strided items into component c of the positions
+      template <typename Scalar>
+      void copy_ply_component(vector<Scalar,3>* positions, const std::uint8_t* src, std::size_t stride,
+        std::size_t count, const io::ply_reader::property_layout& component, std::size_t offset,
+        std::size_t c, bool swap)
+      {
+        dispatch_ply_type(component.value_type, [&](auto tag)
+          {
+            using T = decltype(tag);
+            const std::uint8_t* p = src + offset;
+            for(std::size_t i = 0; i < count; ++i, p += stride)
+              positions[i][c] = static_cast<Scalar>(load_ply_value<T>(p, swap));
+          });
+      }
+
+      //number of elements processed between two progress updates
+      constexpr std::size_t progress_step_size = 1 << 14;
+
+      //decodes the vertex_indices list of count faces starting at first
+      //returns the pointer behind the face block or nullptr if the block is truncated or reading was cancelled
+      inline const std::uint8_t* read_ply_face_block(const std::uint8_t* first, const std::uint8_t* last,
+        std::size_t count, const io::ply_reader::property_layout& list, std::size_t bytes_before,
+        std::size_t bytes_after, bool swap, std::vector<std::size_t>& face_offsets,
+        std::vector<std::size_t>& face_indices)
+      {
+        const std::uint8_t* p = first;
+        bool complete = false;
+        utils::progress decoding(count);
+        dispatch_ply_type(list.size_type, [&](auto size_tag)
+          {
+            dispatch_ply_type(list.value_type, [&](auto index_tag)
+              {
+                using C = decltype(size_tag);
+                using I = decltype(index_tag);
+                if constexpr(std::is_integral<C>::value && std::is_integral<I>::value)
+                {
+                  face_offsets.reserve(count + 1);
+                  face_indices.reserve(3 * count);
+                  face_offsets.push_back(0);
+                  for(std::size_t f = 0; f < count; ++f)
+                  {
+                    p += bytes_before;
+                    if(last - p < static_cast<std::ptrdiff_t>(sizeof(C)))
+                      return;
+                    auto n = static_cast<std::size_t>(load_ply_value<C>(p, swap));
+                    p += sizeof(C);
+                    if(static_cast<std::size_t>(last - p) < n * sizeof(I) + bytes_after)
+                      return;
+                    for(std::size_t k = 0; k < n; ++k, p += sizeof(I))
+                      face_indices.push_back(static_cast<std::size_t>(load_ply_value<I>(p, swap)));
+                    p += bytes_after;
+                    face_offsets.push_back(face_indices.size());
+                    if((f + 1) % progress_step_size == 0 && !decoding.step(progress_step_size))
+                      return;
+                  }
+                  complete = true;
+                }
+              });
+          });
+        return complete ? p : nullptr;
+      }
+
+      //adds all faces at once and falls back to add_face for input which is not an oriented manifold,
+      //faces referencing invalid vertices or producing complex vertices are skipped in that case.
+      //faces receives the handle of each added face or an invalid handle for a skipped face,
+      //returns false if adding the faces was cancelled
+      template <typename Scalar>
+      bool add_faces(math::mesh<Scalar>& mesh, const std::vector<std::size_t>& face_offsets,
+        const std::vector<std::size_t>& face_indices, std::vector<face_handle>& faces)
+      {
+        std::size_t num_faces = face_offsets.empty() ? 0 : face_offsets.size() - 1;
+        utils::progress adding(num_faces);
+        if(adding.is_cancelled())
+          return false;
+        faces.assign(num_faces, face_handle());
+        if(mesh.build_faces(face_offsets, face_indices))
+        {
+          for(std::size_t f = 0; f < num_faces; ++f)
+            faces[f] = face_handle(f);
+          return true;
+        }
+
+        std::vector<math::vertex_handle> vertex_indices;
+        for(std::size_t f = 0; f < num_faces; ++f)
+        {
+          if(f > 0 && f % progress_step_size == 0 && !adding.step(progress_step_size))
+            return false;
+          vertex_indices.clear();
+          for(std::size_t i = face_offsets[f]; i < face_offsets[f + 1]; ++i)
+          {
+            if(face_indices[i] >= mesh.num_vertices())
+              break;
+            vertex_indices.push_back(math::vertex_handle(face_indices[i]));
+          }
+          if(vertex_indices.size() == face_offsets[f + 1] - face_offsets[f])
+            faces[f] = mesh.add_face(vertex_indices);
+        }
+        return true;
+      }
+
+      template <typename Scalar>
+      bool add_faces(math::mesh<Scalar>& mesh, const std::vector<std::size_t>& face_offsets,
+        const std::vector<std::size_t>& face_indices)
+      {
+        std::vector<face_handle> faces;
+        return add_faces(mesh, face_offsets, face_indices, faces);
+      }
+
+      //reads a binary ply file through a memory mapping copying whole blocks of data,
+      //returns false without modifying the mesh if the file layout is not supported
+      template <typename Scalar>
+      bool read_ply_mapped(math::mesh<Scalar>& mesh, const io::ply_reader& ply, const std::string& p)
+      {
+        using layout_t = io::ply_reader::property_layout;
+        if(!ply.is_binary())
+          return false;
+
+        utils::mapped_file file(p);
+        if(!file.is_open() || file.size() < ply.get_data_offset())
+          return false;
+
+        //decoding the faces and adding them to the mesh take about the same time
+        utils::progress loading(2);
+        const bool swap = ply.needs_byte_swap();
+        const std::uint8_t* cursor = file.data() + ply.get_data_offset();
+        const std::uint8_t* last = file.end();
+
+        const std::uint8_t* vertex_block = nullptr;
+        std::size_t vertex_stride = 0;
+        std::size_t num_vertices = 0;
+        std::vector<layout_t> vertex_layout;
+        std::vector<std::size_t> face_offsets;
+        std::vector<std::size_t> face_indices;
+        bool has_faces = false;
+
+        for(auto& name : ply.get_element_names())
+        {
+          if(vertex_block != nullptr && has_faces)
+            break;
+
+          auto layout = ply.get_element_layout(name);
+          std::size_t count = ply.get_element_count(name);
+          std::size_t stride = ply_element_stride(layout);
+
+          if(name == "face")
+          {
+            auto list = std::find_if(layout.begin(), layout.end(), [](const layout_t& l)
+              {
+                return l.is_list && (l.name == "vertex_indices" || l.name == "vertex_index");
+              });
+            if(list == layout.end() || !is_integral(list->size_type) || !is_integral(list->value_type))
+              return false;
+
+            std::size_t bytes_before = 0, bytes_after = 0;
+            for(auto it = layout.begin(); it != layout.end(); ++it)
+            {
+              if(it == list)
+                continue;
+              if(it->is_list)
+                return false;
+              (it < list ? bytes_before : bytes_after) += io::size_of(it->value_type);
+            }
+            loading.make_current(1);
+            cursor = read_ply_face_block(cursor, last, count, *list, bytes_before, bytes_after, swap,
+              face_offsets, face_indices);
+            loading.resign_current();
+            if(cursor == nullptr)
+              return false;
+            has_faces = true;
+            continue;
+          }
+
+          if(stride == 0 && count > 0)
+            return false;
+          if(static_cast<std::size_t>(last - cursor) < stride * count)
+            return false;
+
+          if(name == "vertex")
+          {
+            vertex_block = cursor;
+            vertex_stride = stride;
+            num_vertices = count;
+            vertex_layout = std::move(layout);
+          }
+          cursor += stride * count;
+        }
+
+        if(vertex_block == nullptr)
+          return false;
+
+        std::array<std::size_t, 3> offsets;
+        std::array<const layout_t*, 3> components = {{nullptr, nullptr, nullptr}};
+        std::size_t offset = 0;
+        for(auto& l : vertex_layout)
+        {
+          for(std::size_t c = 0; c < 3; ++c)
+          {
+            if(l.name == std::string(1, "xyz"[c]))
+            {
+              components[c] = &l;
+              offsets[c] = offset;
+            }
+          }
+          offset += io::size_of(l.value_type);
+        }
+        if(std::find(components.begin(), components.end(), nullptr) != components.end())
+          return false;
+
+        mesh.reserve_vertices(num_vertices);
+        mesh.reserve_faces(face_offsets.empty() ? 0 : face_offsets.size() - 1);
+        mesh.add_vertices(num_vertices);
+        auto positions = mesh.position_data();
+
+        bool packed = std::is_same<Scalar, float>::value && !swap
+          && sizeof(vector<Scalar,3>) == 3 * sizeof(Scalar)
+          && components[0]->value_type == io::ply_reader::scalar_type::float32
+          && components[1]->value_type == io::ply_reader::scalar_type::float32
+          && components[2]->value_type == io::ply_reader::scalar_type::float32
+          && offsets[1] == offsets[0] + 4 && offsets[2] == offsets[0] + 8;
+
+        if(packed && vertex_stride == 3 * sizeof(float))
+          std::memcpy(positions, vertex_block, num_vertices * vertex_stride);
+        else if(packed)
+        {
+          const std::uint8_t* src = vertex_block + offsets[0];
+          for(std::size_t i = 0; i < num_vertices; ++i, src += vertex_stride)
+            std::memcpy(positions + i, src, 3 * sizeof(float));
+        }
+        else
+        {
+          for(std::size_t c = 0; c < 3; ++c)
+            copy_ply_component(positions, vertex_block, vertex_stride, num_vertices, *components[c],
+              offsets[c], c, swap);
+        }
+
+        loading.make_current(1);
+        return add_faces(mesh, face_offsets, face_indices);
+      }
+
+      //reads an ascii ply file by parsing chunks of lines in parallel,
+      //returns false without modifying the mesh if the file layout is not supported
+      template <typename Scalar>
+      bool read_ply_ascii(math::mesh<Scalar>& mesh, const io::ply_reader& ply, const std::string& p)
+      {
+        using layout_t = io::ply_reader::property_layout;
+        if(ply.is_binary())
+          return false;
+
+        std::size_t first_record = 0, vertex_record = 0, face_record = 0, num_vertices = 0, num_faces = 0;
+        std::array<std::size_t, 3> vertex_tokens;
+        std::size_t face_tokens = 0;
+        bool has_vertices = false;
+        for(auto& name : ply.get_element_names())
+        {
+          auto layout = ply.get_element_layout(name);
+          std::size_t count = ply.get_element_count(name);
+          if(name == "vertex")
+          {
+            std::size_t found = 0;
+            for(std::size_t i = 0; i < layout.size(); ++i)
+            {
+              if(layout[i].is_list)
+                return false;
+              for(std::size_t c = 0; c < 3; ++c)
+                if(layout[i].name == std::string(1, "xyz"[c]))
+                {
+                  vertex_tokens[c] = i;
+                  ++found;
+                }
+            }
+            if(found != 3)
+              return false;
+            has_vertices = true;
+            vertex_record = first_record;
+            num_vertices = count;
+          }
+          else if(name == "face")
+          {
+            auto list = std::find_if(layout.begin(), layout.end(), [](const layout_t& l)
+              {
+                return l.is_list && (l.name == "vertex_indices" || l.name == "vertex_index");
+              });
+            if(list == layout.end() || std::any_of(layout.begin(), list, [](const layout_t& l){ return l.is_list; }))
+              return false;
+            face_tokens = static_cast<std::size_t>(list - layout.begin());
+            face_record = first_record;
+            num_faces = count;
+          }
+          first_record += count;
+        }
+        if(!has_vertices)
+          return false;
+
+        io::ascii_reader text(p, ply.get_data_offset());
+        if(!text.is_open() || text.num_records() < first_record)
+          return false;
+
+        utils::progress loading(3);
+        std::vector<vector<Scalar,3>> positions(num_vertices);
+        std::size_t last_token = *std::max_element(vertex_tokens.begin(), vertex_tokens.end());
+        loading.make_current(1);
+        bool ok = text.parse_records(vertex_record, num_vertices,
+          [&](std::size_t i, const char* first, const char* last)
+          {
+            for(std::size_t t = 0; t <= last_token; ++t)
+            {
+              double value;
+              if(!io::parse_ascii(first, last, value))
+                return false;
+              for(std::size_t c = 0; c < 3; ++c)
+                if(vertex_tokens[c] == t)
+                  positions[i][c] = static_cast<Scalar>(value);
+            }
+            return true;
+          });
+        loading.resign_current();
+        if(!ok)
+          return false;
+
+        std::vector<std::size_t> face_offsets(1, 0);
+        std::vector<std::size_t> face_indices;
+        loading.make_current(1);
+        ok = text.parse_lists(face_record, num_faces, face_offsets, face_indices,
+          [face_tokens](const char* first, const char* last, std::vector<std::size_t>& indices)
+          {
+            std::size_t n;
+            if(!io::skip_ascii(first, last, face_tokens) || !io::parse_ascii(first, last, n))
+              return false;
+            for(std::size_t k = 0; k < n; ++k)
+            {
+              std::size_t v;
+              if(!io::parse_ascii(first, last, v))
+                return false;
+              indices.push_back(v);
+            }
+            return true;
+          });
+        loading.resign_current();
+        if(!ok)
+          return false;
+
+        mesh.add_vertices(positions);
+        loading.make_current(1);
+        return add_faces(mesh, face_offsets, face_indices);
+      }
+    }
+
     template <typename Scalar>
     bool read_off(math::mesh<Scalar>& mesh, const std::string& p)
     {
+      OWL_PROFILE_SCOPE("read_off");
       if(!utils::file_exists(p))
         return false;
     
@@ -33,35 +454,65 @@ namespace owl
       if(!reader.is_open())
         return false;
     
-//      const std::uint64_t vertex_step_size = 1;
-//      const std::uint64_t face_step_size = 6;
-    
-//      std::uint64_t n = vertex_step_size * reader.num_vertices() +
-//                      face_step_size * reader.num_faces();
-//      utils::progress loading_progress(n);
+      //parsing the text takes about twice as long as adding the faces
+      utils::progress loading(3);
       mesh.reserve_vertices(reader.num_vertices());
       mesh.reserve_faces(reader.num_faces());
     
+      std::vector<float> coordinates;
+      std::vector<std::size_t> face_offsets;
+      std::vector<std::size_t> face_indices;
+      loading.make_current(2);
+      bool parsed = reader.read(coordinates, face_offsets, face_indices);
+      loading.resign_current();
+      if(parsed)
+      {
+        mesh.add_vertices(reader.num_vertices());
+        auto positions = mesh.position_data();
+        for(std::size_t i = 0; i < reader.num_vertices(); ++i)
+          positions[i] = vector<Scalar,3>(coordinates[3 * i], coordinates[3 * i + 1], coordinates[3 * i + 2]);
+        loading.make_current(1);
+        if(detail::add_faces(mesh, face_offsets, face_indices))
+          return true;
+        mesh.clear();
+        return false;
+      }
+      if(loading.is_cancelled())
+        return false;
+    
+      //files which are not one record per line are read with the stream parser
+      face_offsets.assign(1, 0);
+      face_indices.clear();
+      face_offsets.reserve(reader.num_faces() + 1);
+      face_indices.reserve(3 * reader.num_faces());
     
       reader.listen_2_vertex([&mesh](const float& x, const float& y,const float& z)
         {
           mesh.add_vertex(vector<Scalar,3>(x, y, z));
         });
     
-      reader.listen_2_face([&mesh](const std::vector<std::size_t>& indices)
+      reader.listen_2_face([&](const std::vector<std::size_t>& indices)
         {
-          std::vector<math::vertex_handle> vertex_indices;
-          for(auto v: indices)
-            vertex_indices.push_back(math::vertex_handle(v));
-          mesh.add_face(vertex_indices);
+          face_indices.insert(face_indices.end(), indices.begin(), indices.end());
+          face_offsets.push_back(face_indices.size());
         });
    
-      return reader.read();
+      if(!reader.read() || loading.is_cancelled())
+      {
+        mesh.clear();
+        return false;
+      }
+      loading.make_current(1);
+      if(detail::add_faces(mesh, face_offsets, face_indices))
+        return true;
+      mesh.clear();
+      return false;
     }
   
     template <typename Scalar>
     bool read_ply(math::mesh<Scalar>& mesh, const std::string& p)
     {
+      OWL_PROFILE_SCOPE("read_ply");
       if(!utils::file_exists(p))
         return false;
     
@@ -73,13 +524,22 @@ namespace owl
       ply.open(p);
       if(!ply.is_open())
         return false;
+
+      //the first reader which supports the file layout reports the progress
+      utils::progress loading(1);
+      loading.make_current(1);
+      bool done = detail::read_ply_mapped(mesh, ply, p) || detail::read_ply_ascii(mesh, ply, p);
+      loading.resign_current();
+      if(done)
+        return true;
+      if(loading.is_cancelled())
+      {
+        mesh.clear();
+        return false;
+      }
     
-//      const std::uint64_t vertex_step_size = 1;
-//      const std::uint64_t face_step_size = 6;
-    
-//      std::uint64_t n = vertex_step_size * ply.get_element_count("vertex") +
-//                      face_step_size * ply.get_element_count("face");
-//      utils::progress loading_progress(n);
+      //the stream parser can not be interrupted, it is only cancelled before the faces are added
+      utils::progress streaming(ply.get_element_count("vertex") + ply.get_element_count("face"));
   
       std::vector<math::vector<Scalar,3>> positions;
       std::vector<math::vector<Scalar,3>> normals;
@@ -87,6 +547,8 @@ namespace owl
       math::vector<Scalar,3> pos, nml;
       color::rgba8u col, back_col;
       std::int32_t material_idx;
+      std::vector<std::size_t> face_offsets(1, 0);
+      std::vector<std::size_t> face_indices;
     
     
       ply.listen_2_element_begin(
@@ -95,7 +557,11 @@ namespace owl
           if(element_name == "vertex")
             mesh.reserve_vertices(n);
           if(element_name == "face")
+          {
             mesh.reserve_faces(n);
+            face_offsets.reserve(n + 1);
+            face_indices.reserve(3 * n);
+          }
           if(element_name == "edge")
             return;
           if(element_name == "material")
@@ -135,11 +601,10 @@ namespace owl
       ply.listen_2_element_property<int>("face", "vertex_indices",
         [&](const std::vector<int>& vindices)
         {
-          std::vector<math::vertex_handle> vertex_indices;
           for(auto v: vindices)
-            vertex_indices.push_back(math::vertex_handle(v));
-          mesh.add_face(vertex_indices);
-//          loading_progress.step(face_step_size);
+            face_indices.push_back(v < 0 ? std::numeric_limits<std::size_t>::max() : static_cast<std::size_t>(v));
+          face_offsets.push_back(face_indices.size());
+          streaming.step();
         });
     
       ply.listen_2_element_property<std::int32_t>("vertex", "material_index",
@@ -149,7 +614,7 @@ namespace owl
         [&](std::size_t)
         {
           mesh.add_vertex(pos);
-  //        loading_progress.step(vertex_step_size);
+          streaming.step();
         });
     
       ply.listen_2_element_property<std::int32_t>("edge", "vertex1",
@@ -178,30 +643,935 @@ namespace owl
         [](const float& extinct_coeff){ std::cout << extinct_coeff << " ";});
 
       ply.read();
+      if(streaming.is_cancelled() || !detail::add_faces(mesh, face_offsets, face_indices))
+      {
+        mesh.clear();
+        return false;
+      }
       return true;
     }
   
+    namespace detail
+    {
+      constexpr std::size_t stl_header_size = 84;
+      constexpr std::size_t stl_record_size = 50;
+
+      //triangles of an stl file as three separate corners and one facet normal each
+      template <typename Scalar>
+      struct stl_triangles
+      {
+        std::vector<vector<Scalar,3>> corners;
+        std::vector<vector<Scalar,3>> normals;
+
+        void resize(std::size_t n)
+        {
+          corners.resize(3 * n);
+          normals.resize(n);
+        }
+      };
+
+      //a binary stl file consists of an 80 byte header, the number of triangles and one 50 byte record per
+      //triangle, some writers append further bytes. ascii files start with solid, but so do the headers of some
+      //binary files, these are only recognized if the size matches the records exactly
+      inline bool is_binary_stl(const utils::mapped_file& file)
+      {
+        if(file.size() < stl_header_size)
+          return false;
+        auto n = load_ply_value<std::uint32_t>(file.data() + 80, !host_is_little_endian());
+        std::uint64_t size = stl_header_size + stl_record_size * std::uint64_t(n);
+        bool ascii_start = std::memcmp(file.data(), "solid", 5) == 0;
+        return file.size() == size || (file.size() > size && !ascii_start);
+      }
+
+      //decodes the fixed size records in parallel, returns false if decoding was cancelled
+      template <typename Scalar>
+      bool read_stl_binary(const utils::mapped_file& file, stl_triangles<Scalar>& triangles)
+      {
+        const bool swap = !host_is_little_endian();
+        std::size_t n = load_ply_value<std::uint32_t>(file.data() + 80, swap);
+        triangles.resize(n);
+        utils::progress decoding(n);
+        std::atomic<bool> ok(true);
+        utils::parallel_for_blocks(std::size_t(0), n, progress_step_size, [&](std::size_t first, std::size_t last)
+          {
+            if(!ok)
+              return;
+            const std::uint8_t* record = file.data() + stl_header_size + first * stl_record_size;
+            for(std::size_t t = first; t < last; ++t, record += stl_record_size)
+            {
+              for(std::size_t k = 0; k < 4; ++k)
+              {
+                vector<Scalar,3> v;
+                for(std::size_t c = 0; c < 3; ++c)
+                  v[c] = static_cast<Scalar>(load_ply_value<float>(record + 12 * k + 4 * c, swap));
+                (k == 0 ? triangles.normals[t] : triangles.corners[3 * t + k - 1]) = v;
+              }
+            }
+            if(!decoding.step(last - first))
+              ok = false;
+          });
+        return ok;
+      }
+
+      inline bool is_stl_space(char c)
+      {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+      }
+
+      inline void skip_stl_space(const char*& first, const char* last)
+      {
+        while(first != last && is_stl_space(*first))
+          ++first;
+      }
+
+      //skips whitespace and the given keyword of [first, last) if it is a whole token,
+      //first is advanced behind it
+      inline bool parse_stl_keyword(const char*& first, const char* last, const char* keyword)
+      {
+        skip_stl_space(first, last);
+        std::size_t n = std::strlen(keyword);
+        if(static_cast<std::size_t>(last - first) < n || std::strncmp(first, keyword, n) != 0
+          || (first + n != last && !is_stl_space(first[n])))
+          return false;
+        first += n;
+        return true;
+      }
+
+      template <typename Scalar>
+      bool parse_stl_vector(const char*& first, const char* last, vector<Scalar,3>& v)
+      {
+        for(std::size_t i = 0; i < 3; ++i)
+        {
+          skip_stl_space(first, last);
+          if(!io::parse_ascii(first, last, v[i]))
+            return false;
+        }
+        return true;
+      }
+
+      //parses the facets of [first, last) token by token regardless of their line breaks,
+      //solid and endsolid lines in between are skipped with their names
+      template <typename Scalar>
+      bool parse_stl_facets(const char* first, const char* last, stl_triangles<Scalar>& triangles)
+      {
+        while(skip_stl_space(first, last), first != last)
+        {
+          if(parse_stl_keyword(first, last, "solid") || parse_stl_keyword(first, last, "endsolid"))
+          {
+            first = std::find(first, last, '\n');
+            continue;
+          }
+          vector<Scalar,3> normal, corners[3];
+          if(!parse_stl_keyword(first, last, "facet") || !parse_stl_keyword(first, last, "normal")
+            || !parse_stl_vector(first, last, normal) || !parse_stl_keyword(first, last, "outer")
+            || !parse_stl_keyword(first, last, "loop"))
+            return false;
+          for(auto& corner : corners)
+            if(!parse_stl_keyword(first, last, "vertex") || !parse_stl_vector(first, last, corner))
+              return false;
+          if(!parse_stl_keyword(first, last, "endloop") || !parse_stl_keyword(first, last, "endfacet"))
+            return false;
+          triangles.normals.push_back(normal);
+          triangles.corners.insert(triangles.corners.end(), std::begin(corners), std::end(corners));
+        }
+        return true;
+      }
+
+      //parses an ascii stl file in parallel, the text is split into chunks behind endfacet keywords. returns false
+      //if the file does not start with solid and end with endsolid, is malformed or if parsing was cancelled
+      template <typename Scalar>
+      bool read_stl_ascii(const utils::mapped_file& file, stl_triangles<Scalar>& triangles)
+      {
+        const char* first = reinterpret_cast<const char*>(file.data());
+        const char* last = first + file.size();
+        const char* start = first;
+        if(!parse_stl_keyword(start, last, "solid"))
+          return false;
+        //the last line has to close the solid, which also rejects binary files with trailing bytes
+        const char* end = last;
+        while(end != first && is_stl_space(end[-1]))
+          --end;
+        const char* last_line = std::find(std::make_reverse_iterator(end), std::make_reverse_iterator(first), '\n').base();
+        if(!parse_stl_keyword(last_line, end, "endsolid"))
+          return false;
+
+        constexpr std::size_t min_chunk_size = 1 << 18;
+        const std::size_t n = std::max<std::size_t>(1, std::min(4 * utils::num_threads(), file.size() / min_chunk_size));
+        const char endfacet[] = "endfacet";
+        std::vector<const char*> bounds(1, first);
+        for(std::size_t c = 1; c < n; ++c)
+        {
+          const char* pos = std::max(bounds.back(), first + c * (file.size() / n));
+          pos = std::search(pos, last, std::begin(endfacet), std::end(endfacet) - 1);
+          bounds.push_back(pos == last ? last : pos + sizeof(endfacet) - 1);
+        }
+        bounds.push_back(last);
+
+        std::vector<stl_triangles<Scalar>> chunks(n);
+        utils::progress parsing(n);
+        std::atomic<bool> ok(true);
+        utils::parallel_for(std::size_t(0), n, [&](std::size_t c)
+          {
+            if(!ok || !parse_stl_facets(bounds[c], bounds[c + 1], chunks[c]) || !parsing.step())
+              ok = false;
+          });
+        if(!ok)
+          return false;
+        for(auto& chunk : chunks)
+        {
+          triangles.corners.insert(triangles.corners.end(), chunk.corners.begin(), chunk.corners.end());
+          triangles.normals.insert(triangles.normals.end(), chunk.normals.begin(), chunk.normals.end());
+        }
+        return true;
+      }
+    }
+
+    //reads a binary or ascii stl file, binary files are decoded in parallel through a memory mapping.
+    //the separate corners of the triangles are welded into shared vertices, an epsilon of zero only merges
+    //equal positions. triangles degenerated by welding are skipped and non manifold triangles are skipped as by
+    //add_face. the facet normals become the face normals, missing normals of zero length are computed
+    template <typename Scalar>
+    bool read_stl(math::mesh<Scalar>& mesh, const std::string& p, Scalar weld_epsilon = 0)
+    {
+      OWL_PROFILE_SCOPE("read_stl");
+      mesh.clear();
+      utils::mapped_file file(p);
+      if(!file.is_open())
+        return false;
+
+      //decoding, welding and adding the faces take about the same time
+      utils::progress loading(3);
+      detail::stl_triangles<Scalar> triangles;
+      loading.make_current(1);
+      bool decoded = detail::is_binary_stl(file) ? detail::read_stl_binary(file, triangles)
+        : detail::read_stl_ascii(file, triangles);
+      loading.resign_current();
+      file.close();
+      if(!decoded || loading.is_cancelled())
+        return false;
+
+      std::vector<std::size_t> remap;
+      auto positions = weld_vertices(triangles.corners, weld_epsilon, remap);
+      std::vector<std::size_t> face_offsets(1, 0);
+      std::vector<std::size_t> face_indices;
+      std::vector<vector<Scalar,3>> normals;
+      face_indices.reserve(triangles.corners.size());
+      face_offsets.reserve(triangles.normals.size() + 1);
+      normals.reserve(triangles.normals.size());
+      for(std::size_t t = 0; t < triangles.normals.size(); ++t)
+      {
+        std::size_t a = remap[3 * t], b = remap[3 * t + 1], c = remap[3 * t + 2];
+        if(a == b || b == c || c == a)
+          continue;
+        face_indices.insert(face_indices.end(), {a, b, c});
+        face_offsets.push_back(face_indices.size());
+        normals.push_back(triangles.normals[t]);
+      }
+      triangles = {};
+      if(!loading.step())
+        return false;
+
+      mesh.add_vertices(positions);
+      std::vector<face_handle> faces;
+      loading.make_current(1);
+      bool added = detail::add_faces(mesh, face_offsets, face_indices, faces);
+      loading.resign_current();
+      if(!added)
+      {
+        mesh.clear();
+        return false;
+      }
+      utils::parallel_for(std::size_t(0), faces.size(), [&](std::size_t f)
+        {
+          if(!faces[f].is_valid())
+            return;
+          mesh.normal(faces[f]) = sqr_length(normals[f]) > 0 ? normals[f] : mesh.compute_face_normal(faces[f]);
+        });
+      return true;
+    }
+
+    namespace detail
+    {
+      enum class obj_record
+      {
+        vertex,
+        texcoord,
+        normal,
+        face,
+        other
+      };
+
+      //returns the kind of the obj line [first, last), first is advanced behind the keyword
+      inline obj_record parse_obj_keyword(const char*& first, const char* last)
+      {
+        while(first != last && (*first == ' ' || *first == '\t'))
+          ++first;
+        const char* keyword = first;
+        while(first != last && *first != ' ' && *first != '\t' && *first != '\r')
+          ++first;
+        std::size_t n = static_cast<std::size_t>(first - keyword);
+        if(n == 1 && keyword[0] == 'v')
+          return obj_record::vertex;
+        if(n == 1 && keyword[0] == 'f')
+          return obj_record::face;
+        if(n == 2 && keyword[0] == 'v' && keyword[1] == 't')
+          return obj_record::texcoord;
+        if(n == 2 && keyword[0] == 'v' && keyword[1] == 'n')
+          return obj_record::normal;
+        return obj_record::other;
+      }
+
+      //number of corners of a face line behind its keyword
+      inline std::size_t count_obj_corners(const char* first, const char* last)
+      {
+        std::size_t n = 0;
+        bool in_corner = false;
+        for(; first != last; ++first)
+        {
+          bool blank = *first == ' ' || *first == '\t' || *first == '\r';
+          n += !blank && !in_corner;
+          in_corner = !blank;
+        }
+        return n;
+      }
+
+      //resolves a one based or negative relative obj index given the number of elements defined before
+      //and the total number of elements, returns false for 0 and indices out of range
+      inline bool resolve_obj_index(long long index, std::size_t defined, std::size_t total, std::size_t& resolved)
+      {
+        if(index > 0 && static_cast<std::size_t>(index) <= total)
+        {
+          resolved = static_cast<std::size_t>(index) - 1;
+          return true;
+        }
+        if(index < 0 && static_cast<std::size_t>(-index) <= defined)
+        {
+          resolved = defined - static_cast<std::size_t>(-index);
+          return true;
+        }
+        return false;
+      }
+
+      //counts of the obj records of one chunk, which are the first indices of the chunk after the prefix sum
+      struct obj_counts
+      {
+        std::size_t vertices = 0;
+        std::size_t texcoords = 0;
+        std::size_t normals = 0;
+        std::size_t faces = 0;
+        std::size_t corners = 0;
+
+        obj_counts& operator+=(const obj_counts& other)
+        {
+          vertices += other.vertices;
+          texcoords += other.texcoords;
+          normals += other.normals;
+          faces += other.faces;
+          corners += other.corners;
+          return *this;
+        }
+      };
+
+      //the elements of an obj file, corner k of face f is corner face_offsets[f] + k and references its position,
+      //texcoord and normal by index, missing texcoords and normals of a corner are marked by no_index
+      template <typename Scalar>
+      struct obj_data
+      {
+        static constexpr std::size_t no_index = std::numeric_limits<std::size_t>::max();
+
+        std::vector<vector<Scalar,3>> positions;
+        std::vector<vector<Scalar,2>> texcoords;
+        std::vector<vector<Scalar,3>> normals;
+        std::vector<std::size_t> face_offsets;
+        std::vector<std::size_t> face_indices;
+        std::vector<std::size_t> corner_texcoords;
+        std::vector<std::size_t> corner_normals;
+      };
+
+      //parses the corners of one face line to the corners starting at cursor.corners and advances it,
+      //cursor holds the numbers of elements defined before the line for relative indices
+      template <typename Scalar>
+      bool parse_obj_face(const char* first, const char* last, obj_counts& cursor, obj_data<Scalar>& data)
+      {
+        auto is_blank = [](char c){ return c == ' ' || c == '\t' || c == '\r'; };
+        while(true)
+        {
+          while(first != last && is_blank(*first))
+            ++first;
+          if(first == last)
+            return true;
+          long long index;
+          std::size_t v, t = data.no_index, n = data.no_index;
+          if(!io::parse_ascii(first, last, index) || !resolve_obj_index(index, cursor.vertices, data.positions.size(), v))
+            return false;
+          if(first != last && *first == '/')
+          {
+            ++first;
+            if(first != last && *first != '/')
+            {
+              if(!io::parse_ascii(first, last, index)
+                || !resolve_obj_index(index, cursor.texcoords, data.texcoords.size(), t))
+                return false;
+            }
+            if(first != last && *first == '/')
+            {
+              ++first;
+              if(!io::parse_ascii(first, last, index) || !resolve_obj_index(index, cursor.normals, data.normals.size(), n))
+                return false;
+            }
+          }
+          //corners have to be separated by blanks to match the count of the first pass
+          if(first != last && !is_blank(*first))
+            return false;
+          data.face_indices[cursor.corners] = v;
+          if(t != data.no_index)
+            data.corner_texcoords[cursor.corners] = t;
+          if(n != data.no_index)
+            data.corner_normals[cursor.corners] = n;
+          ++cursor.corners;
+        }
+      }
+
+      //parses the lines of an obj file in two parallel passes over the chunks of the file, the first one counts
+      //the records of each chunk and the second one writes each record to its final place. only positions,
+      //texcoords, normals and faces are read, all other records are ignored
+      template <typename Scalar>
+      bool read_obj_data(const io::ascii_reader& text, obj_data<Scalar>& data)
+      {
+        //counting the records is about a third of the work
+        utils::progress parsing(3);
+        std::vector<obj_counts> chunk_counts(text.chunks().size() + 1);
+        parsing.make_current(1);
+        bool counted = text.parse_chunks([&](std::size_t c, const char* first, const char* last)
+          {
+            auto& counts = chunk_counts[c + 1];
+            switch(parse_obj_keyword(first, last))
+            {
+              case obj_record::vertex: ++counts.vertices; break;
+              case obj_record::texcoord: ++counts.texcoords; break;
+              case obj_record::normal: ++counts.normals; break;
+              case obj_record::face: ++counts.faces; counts.corners += count_obj_corners(first, last); break;
+              case obj_record::other: break;
+            }
+            return true;
+          });
+        parsing.resign_current();
+        if(!counted)
+          return false;
+        for(std::size_t c = 1; c < chunk_counts.size(); ++c)
+          chunk_counts[c] += chunk_counts[c - 1];
+
+        const auto& total = chunk_counts.back();
+        data.positions.resize(total.vertices);
+        data.texcoords.resize(total.texcoords);
+        data.normals.resize(total.normals);
+        data.face_offsets.resize(total.faces + 1);
+        data.face_offsets[0] = 0;
+        data.face_indices.resize(total.corners);
+        data.corner_texcoords.assign(total.texcoords > 0 ? total.corners : 0, data.no_index);
+        data.corner_normals.assign(total.normals > 0 ? total.corners : 0, data.no_index);
+
+        parsing.make_current(2);
+        bool parsed = text.parse_chunks([&](std::size_t c, const char* first, const char* last)
+          {
+            auto& cursor = chunk_counts[c];
+            switch(parse_obj_keyword(first, last))
+            {
+              case obj_record::vertex:
+              {
+                auto& p = data.positions[cursor.vertices++];
+                return io::parse_ascii(first, last, p[0]) && io::parse_ascii(first, last, p[1])
+                  && io::parse_ascii(first, last, p[2]);
+              }
+              case obj_record::texcoord:
+              {
+                //the second coordinate is optional
+                auto& t = data.texcoords[cursor.texcoords++];
+                if(!io::parse_ascii(first, last, t[0]))
+                  return false;
+                if(!io::parse_ascii(first, last, t[1]))
+                  t[1] = 0;
+                return true;
+              }
+              case obj_record::normal:
+              {
+                auto& n = data.normals[cursor.normals++];
+                return io::parse_ascii(first, last, n[0]) && io::parse_ascii(first, last, n[1])
+                  && io::parse_ascii(first, last, n[2]);
+              }
+              case obj_record::face:
+              {
+                if(!parse_obj_face(first, last, cursor, data))
+                  return false;
+                data.face_offsets[++cursor.faces] = cursor.corners;
+                return true;
+              }
+              case obj_record::other:
+                return true;
+            }
+            return true;
+          });
+        parsing.resign_current();
+        return parsed;
+      }
+    }
+
+    //reads a wavefront obj file, the lines are parsed in parallel from a memory mapping of the file.
+    //the texcoords and normals referenced by the face corners are stored as halfedge texcoords and normals,
+    //the halfedges of corners without them keep the default. faces are added as by add_face if they do not
+    //form an oriented manifold. materials, groups and all other records are ignored
+    template <typename Scalar>
+    bool read_obj(math::mesh<Scalar>& mesh, const std::string& p)
+    {
+      OWL_PROFILE_SCOPE("read_obj");
+      mesh.clear();
+      io::ascii_reader text(p);
+      if(!text.is_open())
+        return false;
+
+      //parsing the text takes about twice as long as adding the faces
+      utils::progress loading(3);
+      detail::obj_data<Scalar> data;
+      loading.make_current(2);
+      bool parsed = detail::read_obj_data(text, data);
+      loading.resign_current();
+      if(!parsed)
+        return false;
+
+      mesh.add_vertices(data.positions);
+      std::vector<face_handle> faces;
+      loading.make_current(1);
+      bool added = detail::add_faces(mesh, data.face_offsets, data.face_indices, faces);
+      loading.resign_current();
+      if(!added)
+      {
+        mesh.clear();
+        return false;
+      }
+      if(data.corner_texcoords.empty() && data.corner_normals.empty())
+        return true;
+
+      //inner halfedge k of a face points to its corner k, the loop starts at an arbitrary halfedge
+      utils::parallel_for(std::size_t(0), faces.size(), [&](std::size_t f)
+        {
+          if(!faces[f].is_valid())
+            return;
+          std::size_t first = data.face_offsets[f];
+          auto he = mesh.inner(faces[f]);
+          while(mesh.target(he).index() != data.face_indices[first])
+            he = mesh.next(he);
+          for(std::size_t i = first; i < data.face_offsets[f + 1]; ++i, he = mesh.next(he))
+          {
+            if(!data.corner_texcoords.empty() && data.corner_texcoords[i] != data.no_index)
+              mesh.texcoord(he) = data.texcoords[data.corner_texcoords[i]];
+            if(!data.corner_normals.empty() && data.corner_normals[i] != data.no_index)
+              mesh.normal(he) = data.normals[data.corner_normals[i]];
+          }
+        });
+      return true;
+    }
+
     template <typename Scalar>
     bool read(math::mesh<Scalar>& mesh, const std::string& p)
     {
-      std::cout << "reading mesh "<< p << "... ";
-      std::cout.flush();
-    
-//      utils::progress overall_progress(10);
-//      overall_progress.make_current(10);
       bool ret;
       auto extension = utils::file_extension(p);
       if(extension == ".ply" || extension == ".PLY")
         ret = read_ply(mesh, p);
       else if(extension == ".off" || extension == ".OFF")
         ret = read_off(mesh, p);
+      else if(extension == ".stl" || extension == ".STL")
+        ret = read_stl(mesh, p);
+      else if(extension == ".obj" || extension == ".OBJ")
+        ret = read_obj(mesh, p);
+      else if(extension == ".owlm")
+        ret = math::read_owlm(mesh, p);
+      else if(extension == ".owlc")
+        ret = math::read_owlc(mesh, p);
       else ret = false;
-   //  overall_progress.resign_current();
-      std::cout << "complete" << std::endl;
      // if(ret)
      //   mesh.check();
     
       return ret;
     }
+    //optional attributes which are written in addition to positions and faces
+    struct mesh_write_options
+    {
+      bool binary = true;
+      bool halfedge_normals = false;
+      bool halfedge_texcoords = false;
+      bool face_colors = false;
+      //bits per quantized coordinate of compressed owlc files
+      std::size_t position_bits = 16;
+    };
+
+    namespace detail
+    {
+      template <typename Scalar>
+      const char* ply_type_name()
+      {
+        return std::is_same<Scalar, double>::value ? "double" : "float";
+      }
+
+      template <typename T>
+      void write_ascii_values(io::buffered_writer& out, const T* values, std::size_t n)
+      {
+        for(std::size_t i = 0; i < n; ++i)
+        {
+          out.put(' ');
+          out.write_ascii(values[i]);
+        }
+      }
+
+      template <typename Scalar>
+      std::size_t max_valence(const math::mesh<Scalar>& mesh)
+      {
+        std::size_t n = 0;
+        for(auto f : mesh.faces())
+          if(!mesh.status(f).is_removed())
+            n = std::max<std::size_t>(n, std::distance(mesh.inner_halfedges(f).begin(), mesh.inner_halfedges(f).end()));
+        return n;
+      }
+
+      //returns false if the options ask for an attribute whose property the mesh does not have
+      template <typename Scalar>
+      bool has_written_properties(const math::mesh<Scalar>& mesh, const mesh_write_options& options)
+      {
+        using mesh_type = math::mesh<Scalar>;
+        return (!options.halfedge_normals
+            || mesh.template has_halfedge_property<typename mesh_type::vector3>("halfedge_normal"))
+          && (!options.halfedge_texcoords
+            || mesh.template has_halfedge_property<typename mesh_type::vector2>("halfedge_texcoord"))
+          && (!options.face_colors || mesh.template has_face_property<typename mesh_type::color_t>("face_color"));
+      }
+
+      //numbers the vertices which are not removed consecutively and returns their number. indices stays empty
+      //if no vertex is removed, the written index of each vertex is its own index then
+      template <typename Scalar>
+      std::size_t number_written_vertices(const math::mesh<Scalar>& mesh, std::vector<std::size_t>& indices)
+      {
+        indices.clear();
+        std::size_t n = 0;
+        for(auto v : mesh.vertices())
+          n += !mesh.status(v).is_removed();
+        if(n == mesh.num_vertices())
+          return n;
+        indices.assign(mesh.num_vertices(), std::numeric_limits<std::size_t>::max());
+        n = 0;
+        for(auto v : mesh.vertices())
+          if(!mesh.status(v).is_removed())
+            indices[v.index()] = n++;
+        return n;
+      }
+
+      template <typename Scalar, typename Handle>
+      std::size_t num_written(const math::mesh<Scalar>& mesh, std::size_t n)
+      {
+        std::size_t written = 0;
+        for(std::size_t i = 0; i < n; ++i)
+          written += !mesh.status(Handle(static_cast<mesh_index>(i))).is_removed();
+        return written;
+      }
+    }
+
+    //writes the mesh as binary ply in the byte order of the host or as ascii ply,
+    //halfedge normals and texcoords are stored as per face lists named normal and texcoord.
+    //removed elements are skipped and the remaining vertices are renumbered consecutively.
+    //returns false if the options ask for an attribute the mesh does not have or if more vertices
+    //are written than 32 bit indices can address
+    template <typename Scalar>
+    bool write_ply(const math::mesh<Scalar>& mesh, const std::string& p, const mesh_write_options& options = {})
+    {
+      OWL_PROFILE_SCOPE("write_ply");
+      using vector3 = vector<Scalar,3>;
+      if(!detail::has_written_properties(mesh, options))
+        return false;
+      std::vector<std::size_t> vertex_indices;
+      std::size_t num_vertices = detail::number_written_vertices(mesh, vertex_indices);
+      if(num_vertices > std::numeric_limits<std::uint32_t>::max())
+        return false;
+      std::size_t num_faces = detail::num_written<Scalar, face_handle>(mesh, mesh.num_faces());
+      io::buffered_writer out(p);
+      if(!out.is_open())
+        return false;
+
+      std::size_t max_list_length = detail::max_valence(mesh) * (options.halfedge_normals ? 3
+        : options.halfedge_texcoords ? 2 : 1);
+      bool uchar_count = max_list_length <= std::numeric_limits<std::uint8_t>::max();
+      bool int_index = num_vertices <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max());
+      const char* count_type = uchar_count ? "uchar" : "uint";
+      const char* scalar_type = detail::ply_type_name<Scalar>();
+
+      out.write(std::string("ply\nformat ") + (!options.binary ? "ascii" :
+        detail::host_is_little_endian() ? "binary_little_endian" : "binary_big_endian") + " 1.0\n");
+      out.write("comment created by owl\n");
+      out.write("element vertex " + std::to_string(num_vertices) + "\n");
+      for(auto c : {"x", "y", "z"})
+        out.write(std::string("property ") + scalar_type + " " + c + "\n");
+      out.write("element face " + std::to_string(num_faces) + "\n");
+      out.write(std::string("property list ") + count_type + (int_index ? " int" : " uint") + " vertex_indices\n");
+      if(options.halfedge_texcoords)
+        out.write(std::string("property list ") + count_type + " " + scalar_type + " texcoord\n");
+      if(options.halfedge_normals)
+        out.write(std::string("property list ") + count_type + " " + scalar_type + " normal\n");
+      if(options.face_colors)
+        for(auto c : {"red", "green", "blue", "alpha"})
+          out.write(std::string("property uchar ") + c + "\n");
+      out.write("end_header\n");
+
+      auto write_count = [&](std::size_t n)
+      {
+        if(uchar_count)
+          out.write_value(static_cast<std::uint8_t>(n));
+        else
+          out.write_value(static_cast<std::uint32_t>(n));
+      };
+
+      const vector3* positions = mesh.position_data();
+      if(options.binary && vertex_indices.empty() && sizeof(vector3) == 3 * sizeof(Scalar))
+      {
+        out.write(positions, mesh.num_vertices() * sizeof(vector3));
+      }
+      else
+      {
+        for(std::size_t i = 0; i < mesh.num_vertices(); ++i)
+        {
+          if(!vertex_indices.empty() && mesh.status(vertex_handle(static_cast<mesh_index>(i))).is_removed())
+            continue;
+          if(options.binary)
+          {
+            out.write(positions[i].data(), 3 * sizeof(Scalar));
+            continue;
+          }
+          out.write_ascii(positions[i].x());
+          detail::write_ascii_values(out, positions[i].data() + 1, 2);
+          out.put('\n');
+        }
+      }
+
+      std::vector<std::uint32_t> indices;
+      for(auto f : mesh.faces())
+      {
+        if(mesh.status(f).is_removed())
+          continue;
+        indices.clear();
+        for(auto v : mesh.vertices(f))
+          indices.push_back(static_cast<std::uint32_t>(vertex_indices.empty() ? v.index() : vertex_indices[v.index()]));
+        std::size_t n = indices.size();
+
+        if(options.binary)
+        {
+          write_count(n);
+          out.write(indices.data(), n * sizeof(std::uint32_t));
+          if(options.halfedge_texcoords)
+          {
+            write_count(2 * n);
+            for(auto he : mesh.inner_halfedges(f))
+              out.write(mesh.texcoord(he).data(), 2 * sizeof(Scalar));
+          }
+          if(options.halfedge_normals)
+          {
+            write_count(3 * n);
+            for(auto he : mesh.inner_halfedges(f))
+              out.write(mesh.normal(he).data(), 3 * sizeof(Scalar));
+          }
+          if(options.face_colors)
+          {
+            auto& col = mesh.color(f);
+            const std::uint8_t rgba[4] = {col.r(), col.g(), col.b(), col.a()};
+            out.write(rgba, 4);
+          }
+        }
+        else
+        {
+          out.write_ascii(n);
+          detail::write_ascii_values(out, indices.data(), n);
+          if(options.halfedge_texcoords)
+          {
+            out.put(' ');
+            out.write_ascii(2 * n);
+            for(auto he : mesh.inner_halfedges(f))
+              detail::write_ascii_values(out, mesh.texcoord(he).data(), 2);
+          }
+          if(options.halfedge_normals)
+          {
+            out.put(' ');
+            out.write_ascii(3 * n);
+            for(auto he : mesh.inner_halfedges(f))
+              detail::write_ascii_values(out, mesh.normal(he).data(), 3);
+          }
+          if(options.face_colors)
+          {
+            auto& col = mesh.color(f);
+            for(auto c : {col.r(), col.g(), col.b(), col.a()})
+            {
+              out.put(' ');
+              out.write_ascii(static_cast<unsigned>(c));
+            }
+          }
+          out.put('\n');
+        }
+      }
+      return out.close();
+    }
+
+    //writes the mesh as ascii off, face colors are appended to the face lines,
+    //halfedge normals and texcoords can not be stored in off files. removed elements are skipped and the
+    //remaining vertices are renumbered consecutively. returns false if the mesh has no face colors to write
+    template <typename Scalar>
+    bool write_off(const math::mesh<Scalar>& mesh, const std::string& p, const mesh_write_options& options = {})
+    {
+      OWL_PROFILE_SCOPE("write_off");
+      mesh_write_options colors;
+      colors.face_colors = options.face_colors;
+      if(!detail::has_written_properties(mesh, colors))
+        return false;
+      std::vector<std::size_t> vertex_indices;
+      std::size_t num_vertices = detail::number_written_vertices(mesh, vertex_indices);
+      io::buffered_writer out(p);
+      if(!out.is_open())
+        return false;
+
+      out.write("OFF\n" + std::to_string(num_vertices) + " "
+        + std::to_string(detail::num_written<Scalar, face_handle>(mesh, mesh.num_faces())) + " "
+        + std::to_string(detail::num_written<Scalar, edge_handle>(mesh, mesh.num_edges())) + "\n");
+      auto positions = mesh.position_data();
+      for(std::size_t i = 0; i < mesh.num_vertices(); ++i)
+      {
+        if(!vertex_indices.empty() && mesh.status(vertex_handle(static_cast<mesh_index>(i))).is_removed())
+          continue;
+        out.write_ascii(positions[i].x());
+        detail::write_ascii_values(out, positions[i].data() + 1, 2);
+        out.put('\n');
+      }
+
+      std::vector<std::size_t> indices;
+      for(auto f : mesh.faces())
+      {
+        if(mesh.status(f).is_removed())
+          continue;
+        indices.clear();
+        for(auto v : mesh.vertices(f))
+          indices.push_back(vertex_indices.empty() ? v.index() : vertex_indices[v.index()]);
+        out.write_ascii(indices.size());
+        detail::write_ascii_values(out, indices.data(), indices.size());
+        if(options.face_colors)
+        {
+          auto& col = mesh.color(f);
+          for(auto c : {col.r(), col.g(), col.b(), col.a()})
+          {
+            out.put(' ');
+            out.write_ascii(static_cast<unsigned>(c));
+          }
+        }
+        out.put('\n');
+      }
+      return out.close();
+    }
+
+    //writes the faces as binary stl in little endian byte order or as ascii stl, polygons are split into
+    //triangle fans around their first corner which share the face normal. face normals of zero length are
+    //computed, the stored normals are written otherwise. removed faces are skipped.
+    //returns false if there are more than 2^32 triangles
+    template <typename Scalar>
+    bool write_stl(const math::mesh<Scalar>& mesh, const std::string& p, const mesh_write_options& options = {})
+    {
+      OWL_PROFILE_SCOPE("write_stl");
+      std::size_t num_triangles = 0;
+      for(auto f : mesh.faces())
+        if(!mesh.status(f).is_removed())
+          num_triangles += std::distance(mesh.vertices(f).begin(), mesh.vertices(f).end()) - 2;
+      if(num_triangles > std::numeric_limits<std::uint32_t>::max())
+        return false;
+
+      io::buffered_writer out(p);
+      if(!out.is_open())
+        return false;
+
+      const bool swap = !detail::host_is_little_endian();
+      std::array<float, 12> values;
+      auto write_triangle = [&]()
+        {
+          if(options.binary)
+          {
+            std::uint8_t record[detail::stl_record_size] = {};
+            std::memcpy(record, values.data(), sizeof(values));
+            if(swap)
+              for(std::size_t i = 0; i < values.size(); ++i)
+                std::reverse(record + 4 * i, record + 4 * i + 4);
+            out.write(record, sizeof(record));
+            return;
+          }
+          const char* prefixes[4] = {"facet normal", "  outer loop\n    vertex", "    vertex", "    vertex"};
+          for(std::size_t k = 0; k < 4; ++k)
+          {
+            out.write(prefixes[k]);
+            detail::write_ascii_values(out, values.data() + 3 * k, 3);
+            out.put('\n');
+          }
+          out.write("  endloop\nendfacet\n");
+        };
+
+      if(options.binary)
+      {
+        std::uint8_t header[detail::stl_header_size] = {};
+        const char name[] = "binary stl written by owl";
+        std::memcpy(header, name, sizeof(name) - 1);
+        auto n = static_cast<std::uint32_t>(num_triangles);
+        std::memcpy(header + 80, &n, sizeof(n));
+        if(swap)
+          std::reverse(header + 80, header + 84);
+        out.write(header, sizeof(header));
+      }
+      else
+      {
+        out.write("solid owl\n");
+      }
+
+      for(auto f : mesh.faces())
+      {
+        if(mesh.status(f).is_removed())
+          continue;
+        auto n = mesh.normal(f);
+        if(sqr_length(n) == 0)
+          n = mesh.compute_face_normal(f);
+        for(std::size_t c = 0; c < 3; ++c)
+          values[c] = static_cast<float>(n[c]);
+        auto he = mesh.inner(f);
+        const auto& p0 = mesh.position(mesh.target(he));
+        for(auto next = mesh.next(he); mesh.next(next) != he; next = mesh.next(next))
+        {
+          const auto& p1 = mesh.position(mesh.target(next));
+          const auto& p2 = mesh.position(mesh.target(mesh.next(next)));
+          for(std::size_t c = 0; c < 3; ++c)
+          {
+            values[3 + c] = static_cast<float>(p0[c]);
+            values[6 + c] = static_cast<float>(p1[c]);
+            values[9 + c] = static_cast<float>(p2[c]);
+          }
+          write_triangle();
+        }
+      }
+      if(!options.binary)
+        out.write("endsolid owl\n");
+      return out.close();
+    }
+
+    template <typename Scalar>
+    bool write(const math::mesh<Scalar>& mesh, const std::string& p, const mesh_write_options& options = {})
+    {
+      auto extension = utils::file_extension(p);
+      if(extension == ".ply" || extension == ".PLY")
+        return write_ply(mesh, p, options);
+      if(extension == ".off" || extension == ".OFF")
+        return write_off(mesh, p, options);
+      if(extension == ".stl" || extension == ".STL")
+        return write_stl(mesh, p, options);
+      if(extension == ".owlm")
+        return math::write_owlm(mesh, p);
+      if(extension == ".owlc")
+        return math::write_owlc(mesh, p, options.position_bits);
+      return false;
+    }
   }
 }
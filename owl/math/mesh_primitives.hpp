@@ -340,7 +340,7 @@ namespace owl
     
       for(std::size_t i = 0; i < slices; ++i)
       {
-        Scalar angle= -i * constants::two_pi<Scalar>/slices;
+        Scalar angle = -Scalar(i) * constants::two_pi<Scalar> / slices;
         positions.emplace_back(cos(angle) * radius, 0, sin(angle) * radius);
       }
       auto vhandles = m.add_vertices(positions);
@@ -0,0 +1,207 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "owl/math/mesh.hpp"
+#include "owl/math/utils.hpp"
+#include "owl/utils/parallel.hpp"
+#include "owl/utils/profiler.hpp"
+#include "owl/utils/radix_sort.hpp"
+
+namespace owl
+{
+  namespace math
+  {
+    enum class vertex_ordering
+    {
+      //z-order curve through the vertex positions, cheapest to compute
+      morton,
+      //hilbert curve through the vertex positions, consecutive cells of the curve are always adjacent in space
+      hilbert,
+      //breadth first traversal of the vertex graph, minimizes the index distance of neighboring vertices
+      //independent of the embedding
+      reverse_cuthill_mckee
+    };
+
+    namespace detail
+    {
+      //transforms the cell coordinates of a 1024^3 grid in place such that interleaving their bits
+      //gives the hilbert index of the cell (skilling 2004)
+      inline void hilbert_transpose(std::uint32_t (&x)[3])
+      {
+        for(std::uint32_t q = 1u << 9; q > 1; q >>= 1)
+        {
+          std::uint32_t p = q - 1;
+          for(std::size_t i = 0; i < 3; ++i)
+          {
+            if(x[i] & q)
+              x[0] ^= p;
+            else
+            {
+              std::uint32_t t = (x[0] ^ x[i]) & p;
+              x[0] ^= t;
+              x[i] ^= t;
+            }
+          }
+        }
+        for(std::size_t i = 1; i < 3; ++i)
+          x[i] ^= x[i - 1];
+        std::uint32_t t = 0;
+        for(std::uint32_t q = 1u << 9; q > 1; q >>= 1)
+          if(x[2] & q)
+            t ^= q - 1;
+        for(std::size_t i = 0; i < 3; ++i)
+          x[i] ^= t;
+      }
+
+      //sorts the vertices along a space filling curve through the bounding box of the mesh
+      template <typename Scalar>
+      std::vector<vertex_handle> space_filling_curve_order(const mesh<Scalar>& m, bool hilbert)
+      {
+        std::size_t n = m.num_vertices();
+        if(n == 0)
+          return {};
+        auto bounds = m.bounds();
+        vector<Scalar, 3> scale;
+        for(std::size_t j = 0; j < 3; ++j)
+        {
+          Scalar extent = bounds.upper_bound[j] - bounds.lower_bound[j];
+          scale[j] = extent > 0 ? Scalar(1023) / extent : 0;
+        }
+
+        std::vector<std::uint32_t> codes(n);
+        std::vector<vertex_handle> order(n);
+        utils::parallel_for_blocks(std::size_t(0), n, 1 << 14, [&](std::size_t first, std::size_t last)
+          {
+            for(std::size_t i = first; i < last; ++i)
+            {
+              vertex_handle v(static_cast<mesh_index>(i));
+              std::uint32_t x[3];
+              for(std::size_t j = 0; j < 3; ++j)
+              {
+                Scalar t = (m.position(v)[j] - bounds.lower_bound[j]) * scale[j];
+                x[j] = static_cast<std::uint32_t>(std::clamp<Scalar>(t, 0, 1023));
+              }
+              if(hilbert)
+                hilbert_transpose(x);
+              codes[i] = expand_bits(x[0]) << 2 | expand_bits(x[1]) << 1 | expand_bits(x[2]);
+              order[i] = v;
+            }
+          });
+        utils::radix_sort(codes, order);
+        return order;
+      }
+
+      //stable counting sort of the elements by their keys in [0, num_keys)
+      template <typename Handle>
+      std::vector<Handle> order_by_key(const std::vector<std::size_t>& keys, std::size_t num_keys)
+      {
+        std::vector<std::size_t> offsets(num_keys + 1, 0);
+        for(auto key : keys)
+          ++offsets[key + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<Handle> order(keys.size());
+        for(std::size_t i = 0; i < keys.size(); ++i)
+          order[offsets[keys[i]]++] = Handle(static_cast<mesh_index>(i));
+        return order;
+      }
+    }
+
+    //orders the vertices by a breadth first traversal which visits the neighbors in order of increasing valence
+    //and reverses the result, each connected component is started at one of its vertices of lowest valence
+    template <typename Scalar>
+    std::vector<vertex_handle> reverse_cuthill_mckee_order(const mesh<Scalar>& m)
+    {
+      std::size_t n = m.num_vertices();
+      std::vector<std::size_t> valence(n);
+      utils::parallel_for(m.vertices(), [&](vertex_handle v){ valence[v.index()] = m.valence(v); });
+      auto by_valence = [&](vertex_handle a, vertex_handle b){ return valence[a.index()] < valence[b.index()]; };
+
+      std::vector<vertex_handle> starts(m.vertices().begin(), m.vertices().end());
+      std::stable_sort(starts.begin(), starts.end(), by_valence);
+
+      std::vector<bool> visited(n, false);
+      std::vector<vertex_handle> order;
+      order.reserve(n);
+      for(auto start : starts)
+      {
+        if(visited[start.index()])
+          continue;
+        visited[start.index()] = true;
+        order.push_back(start);
+        for(std::size_t head = order.size() - 1; head < order.size(); ++head)
+        {
+          std::size_t first_neighbor = order.size();
+          for(auto v : m.vertices(order[head]))
+          {
+            if(visited[v.index()])
+              continue;
+            visited[v.index()] = true;
+            order.push_back(v);
+          }
+          std::stable_sort(order.begin() + first_neighbor, order.end(), by_valence);
+        }
+      }
+      std::reverse(order.begin(), order.end());
+      return order;
+    }
+
+    //returns the vertices in given order, the new index of vertex order[i] is i
+    template <typename Scalar>
+    std::vector<vertex_handle> vertex_order(const mesh<Scalar>& m, vertex_ordering ordering)
+    {
+      switch(ordering)
+      {
+        case vertex_ordering::morton:
+          return detail::space_filling_curve_order(m, false);
+        case vertex_ordering::hilbert:
+          return detail::space_filling_curve_order(m, true);
+        default:
+          return reverse_cuthill_mckee_order(m);
+      }
+    }
+
+    //renumbers the vertices in given order, the faces and edges are renumbered by their lowest new vertex index
+    //so that elements close on the surface are close in memory and circulators access memory mostly locally.
+    //all connectivity and properties are updated, removed elements should be erased by garbage_collection() first
+    template <typename Scalar>
+    void reorder(mesh<Scalar>& m, vertex_ordering ordering = vertex_ordering::hilbert)
+    {
+      OWL_PROFILE_FUNCTION();
+      auto vertices = vertex_order(m, ordering);
+      std::vector<std::size_t> new_index(vertices.size());
+      utils::parallel_for(std::size_t(0), vertices.size(), [&](std::size_t i){ new_index[vertices[i].index()] = i; });
+
+      std::vector<std::size_t> face_keys(m.num_faces());
+      utils::parallel_for(m.faces(), [&](face_handle f)
+        {
+          std::size_t key = vertices.size();
+          for(auto v : m.vertices(f))
+            key = std::min(key, new_index[v.index()]);
+          face_keys[f.index()] = key;
+        });
+
+      std::vector<std::size_t> edge_keys(m.num_edges());
+      utils::parallel_for(m.edges(), [&](edge_handle e)
+        {
+          auto he = m.halfedge(e);
+          edge_keys[e.index()] = std::min(new_index[m.target(he).index()], new_index[m.origin(he).index()]);
+        });
+
+      m.permute(vertices, detail::order_by_key<edge_handle>(edge_keys, vertices.size()),
+        detail::order_by_key<face_handle>(face_keys, vertices.size() + 1));
+    }
+  }
+}
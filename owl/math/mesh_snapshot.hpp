@@ -0,0 +1,415 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "owl/color/color.hpp"
+#include "owl/io/buffered_writer.hpp"
+#include "owl/math/mesh.hpp"
+#include "owl/utils/mapped_file.hpp"
+#include "owl/utils/parallel.hpp"
+#include "owl/utils/profiler.hpp"
+
+namespace owl
+{
+  namespace math
+  {
+    namespace detail
+    {
+      //an owlm file starts with this header followed by the table of its arrays,
+      //the arrays follow the table, each starting at a multiple of snapshot_alignment
+      struct snapshot_header
+      {
+        char magic[8];
+        std::uint32_t byte_order;
+        std::uint32_t version;
+        std::uint32_t scalar_size;
+        std::uint32_t index_size;
+        std::uint64_t num_vertices;
+        std::uint64_t num_edges;
+        std::uint64_t num_faces;
+        std::uint64_t store_prev;
+        std::uint64_t num_arrays;
+      };
+
+      //one table entry, followed by the name and the type name of the array padded to a multiple of 8 bytes
+      struct snapshot_array
+      {
+        std::uint32_t element;
+        std::uint32_t value_size;
+        std::uint64_t slot;
+        std::uint64_t offset;
+        std::uint32_t name_length;
+        std::uint32_t type_length;
+      };
+
+      static_assert(sizeof(snapshot_header) == 64 && sizeof(snapshot_array) == 32, "snapshot records must not be padded");
+
+      template <typename... Ts>
+      struct snapshot_types {};
+
+      //element types of properties which are restored even if the mesh does not have them before reading,
+      //each type is stored under the fixed name at its position in snapshot_type_names
+      template <typename Scalar>
+      using snapshot_property_types = snapshot_types<std::int8_t, std::uint8_t, std::int16_t, std::uint16_t,
+        std::int32_t, std::uint32_t, std::int64_t, std::uint64_t, std::size_t, float, double,
+        vector<float, 2>, vector<float, 3>, vector<float, 4>, vector<double, 2>, vector<double, 3>, vector<double, 4>,
+        color::rgba8u, vertex_handle, halfedge_handle, edge_handle, face_handle, status_flags>;
+
+      constexpr const char* snapshot_type_names[] = {"int8", "uint8", "int16", "uint16", "int32", "uint32", "int64",
+        "uint64", "size", "float32", "float64", "vector2f", "vector3f", "vector4f", "vector2d", "vector3d", "vector4d",
+        "rgba8u", "vertex_handle", "halfedge_handle", "edge_handle", "face_handle", "status_flags"};
+
+      //returns the name of the first type for which is_type returns true, other types are only named by their size
+      template <typename... Ts, typename IsType>
+      std::string snapshot_type_name(snapshot_types<Ts...>, std::size_t value_size, IsType&& is_type)
+      {
+        static_assert(sizeof...(Ts) == std::size(snapshot_type_names), "each snapshot type needs a name");
+        std::size_t i = 0, found = sizeof...(Ts);
+        ((found == sizeof...(Ts) && is_type(static_cast<Ts*>(nullptr)) ? (void)(found = i) : (void)0, ++i), ...);
+        return found < sizeof...(Ts) ? snapshot_type_names[found] : "raw" + std::to_string(value_size);
+      }
+
+      //the stored type name of the elements of p
+      template <typename Scalar>
+      std::string snapshot_type_name(const utils::indexed_property_base& p)
+      {
+        return snapshot_type_name(snapshot_property_types<Scalar>(), p.value_size(), [&p](auto* type)
+          {
+            return dynamic_cast<const utils::indexed_property<std::remove_pointer_t<decltype(type)>>*>(&p) != nullptr;
+          });
+      }
+
+      //the stored type name of T
+      template <typename Scalar, typename T>
+      std::string snapshot_type_name()
+      {
+        return snapshot_type_name(snapshot_property_types<Scalar>(), sizeof(T), [](auto* type)
+          {
+            return std::is_same<T, std::remove_pointer_t<decltype(type)>>::value;
+          });
+      }
+
+      template <typename... Ts>
+      std::unique_ptr<utils::indexed_property_base> make_snapshot_property(const std::string& type,
+        const std::string& name, snapshot_types<Ts...>)
+      {
+        std::unique_ptr<utils::indexed_property_base> p;
+        std::size_t i = 0;
+        ((!p && type == snapshot_type_names[i] ? (void)(p = std::make_unique<utils::indexed_property<Ts>>(name, 0))
+          : (void)0, ++i), ...);
+        return p;
+      }
+
+      //writes and reads the connectivity, status and property arrays of a mesh as raw bytes
+      template <typename Scalar>
+      struct mesh_snapshot
+      {
+        enum element : std::uint32_t { vertex, halfedge, edge, face, num_element_kinds };
+
+        static constexpr char magic[8] = {'o', 'w', 'l', 'm', 'e', 's', 'h', '\0'};
+        static constexpr std::uint32_t byte_order = 0x01020304;
+        static constexpr std::uint32_t version = 1;
+        static constexpr std::uint64_t no_slot = std::numeric_limits<std::uint64_t>::max();
+        static constexpr std::size_t alignment = 64;
+
+        //an array of the mesh, data points to count values of value_size bytes
+        struct array
+        {
+          element kind;
+          std::string name;
+          std::string type;
+          std::size_t value_size;
+          std::uint64_t slot;
+          void* data;
+          std::size_t count;
+        };
+
+        template <typename T>
+        static array connectivity_array(element kind, const char* name, std::vector<T>& values)
+        {
+          return {kind, name, snapshot_type_name<Scalar, T>(), sizeof(T), no_slot, values.data(), values.size()};
+        }
+
+        //the connectivity and status arrays, prev is only included if the mesh stores it
+        static std::vector<array> connectivity_arrays(mesh<Scalar>& m)
+        {
+          std::vector<array> arrays = {connectivity_array(halfedge, "halfedge_next", m.halfedge_next_),
+            connectivity_array(halfedge, "halfedge_target", m.halfedge_target_),
+            connectivity_array(halfedge, "halfedge_face", m.halfedge_face_),
+            connectivity_array(vertex, "vertex_incoming", m.vertex_incoming_),
+            connectivity_array(face, "face_halfedge", m.face_halfedge_),
+            connectivity_array(vertex, "vertex_status", m.vertex_status_),
+            connectivity_array(halfedge, "halfedge_status", m.halfedge_status_),
+            connectivity_array(edge, "edge_status", m.edge_status_),
+            connectivity_array(face, "face_status", m.face_status_)};
+          if(m.store_prev_)
+            arrays.push_back(connectivity_array(halfedge, "halfedge_prev", m.halfedge_prev_));
+          return arrays;
+        }
+
+        template <typename Container>
+        static void add_property_arrays(element kind, Container& properties, std::size_t count,
+          std::vector<array>& arrays)
+        {
+          for(std::size_t slot = 0; slot < properties.num_properties(); ++slot)
+          {
+            auto p = properties.get_property_base(slot);
+            if(p != nullptr && p->value_size() > 0)
+              arrays.push_back({kind, p->name, snapshot_type_name<Scalar>(*p), p->value_size(), slot, p->data(), count});
+          }
+        }
+
+        static std::size_t padded(std::size_t n, std::size_t multiple)
+        {
+          return (n + multiple - 1) / multiple * multiple;
+        }
+
+        static bool write(const mesh<Scalar>& m, const std::string& p)
+        {
+          //the arrays are only read, the pointers are non const to share the array type with reading
+          auto& src = const_cast<mesh<Scalar>&>(m);
+          auto arrays = connectivity_arrays(src);
+          add_property_arrays(vertex, src.vertex_properties_, m.num_vertices(), arrays);
+          add_property_arrays(halfedge, src.halfedge_properties_, m.num_halfedges(), arrays);
+          add_property_arrays(edge, src.edge_properties_, m.num_edges(), arrays);
+          add_property_arrays(face, src.face_properties_, m.num_faces(), arrays);
+
+          std::size_t table_end = sizeof(snapshot_header);
+          for(auto& a : arrays)
+            table_end += sizeof(snapshot_array) + padded(a.name.size() + a.type.size(), 8);
+          std::size_t offset = table_end;
+          std::vector<std::size_t> offsets;
+          for(auto& a : arrays)
+          {
+            offset = padded(offset, alignment);
+            offsets.push_back(offset);
+            offset += a.value_size * a.count;
+          }
+
+          io::buffered_writer out(p);
+          if(!out.is_open())
+            return false;
+          snapshot_header header;
+          std::memcpy(header.magic, magic, sizeof(magic));
+          header.byte_order = byte_order;
+          header.version = version;
+          header.scalar_size = sizeof(Scalar);
+          header.index_size = sizeof(mesh_index);
+          header.num_vertices = m.num_vertices();
+          header.num_edges = m.num_edges();
+          header.num_faces = m.num_faces();
+          header.store_prev = m.store_prev_;
+          header.num_arrays = arrays.size();
+          out.write_value(header);
+
+          const char zeros[alignment] = {};
+          for(std::size_t i = 0; i < arrays.size(); ++i)
+          {
+            auto& a = arrays[i];
+            snapshot_array entry = {a.kind, static_cast<std::uint32_t>(a.value_size), a.slot, offsets[i],
+              static_cast<std::uint32_t>(a.name.size()), static_cast<std::uint32_t>(a.type.size())};
+            out.write_value(entry);
+            out.write(a.name);
+            out.write(a.type);
+            out.write(zeros, padded(a.name.size() + a.type.size(), 8) - a.name.size() - a.type.size());
+          }
+          std::size_t position = table_end;
+          for(std::size_t i = 0; i < arrays.size(); ++i)
+          {
+            out.write(zeros, offsets[i] - position);
+            std::size_t bytes = arrays[i].value_size * arrays[i].count;
+            if(bytes > 0)
+              out.write(arrays[i].data, bytes);
+            position = offsets[i] + bytes;
+          }
+          return out.close();
+        }
+
+        //finds the destination of a stored property, a property of the mesh in the same slot with the same name
+        //and type or a new property of a known type. properties of other types are only restored into a property
+        //with the same slot, name and element size. returns nullptr if the property can not be restored
+        template <typename Container>
+        static void* property_destination(Container& properties, const snapshot_array& entry,
+          const std::string& name, const std::string& type)
+        {
+          if(entry.slot < properties.num_properties())
+          {
+            auto p = properties.get_property_base(entry.slot);
+            if(p != nullptr && p->name == name && type == snapshot_type_name<Scalar>(*p)
+              && p->value_size() == entry.value_size)
+              return p->data();
+          }
+          auto p = make_snapshot_property(type, name, snapshot_property_types<Scalar>());
+          if(!p || p->value_size() != entry.value_size)
+            return nullptr;
+          return properties.get_property_base(properties.add_property(std::move(p)))->data();
+        }
+
+        static bool read(mesh<Scalar>& m, const std::string& p)
+        {
+          utils::mapped_file file(p);
+          if(!file.is_open() || file.size() < sizeof(snapshot_header))
+            return false;
+          snapshot_header header;
+          std::memcpy(&header, file.data(), sizeof(header));
+          if(std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.byte_order != byte_order
+            || header.version != version || header.scalar_size != sizeof(Scalar) || header.index_size != sizeof(mesh_index))
+            return false;
+
+          //each element stores at least one handle, larger counts can not be backed by the file and are
+          //rejected before anything is allocated
+          const std::uint64_t max_count = file.size() / sizeof(mesh_index);
+          if(header.num_vertices > max_count || header.num_edges > max_count / 2 || header.num_faces > max_count
+            || header.num_arrays > file.size() / sizeof(snapshot_array))
+            return false;
+
+          //the result starts with the empty properties of m in their slots, so stored properties are restored
+          //into them and the property handles of m stay valid
+          mesh<Scalar> result;
+          const std::vector<std::size_t> no_elements;
+          result.vertex_properties_ = m.vertex_properties_.gathered(no_elements);
+          result.halfedge_properties_ = m.halfedge_properties_.gathered(no_elements);
+          result.edge_properties_ = m.edge_properties_.gathered(no_elements);
+          result.face_properties_ = m.face_properties_.gathered(no_elements);
+          result.mesh_properties_ = m.mesh_properties_;
+          result.vertex_position_handle_ = m.vertex_position_handle_;
+          result.face_normal_handle_ = m.face_normal_handle_;
+          result.face_color_handle_ = m.face_color_handle_;
+          result.halfedge_normal_handle_ = m.halfedge_normal_handle_;
+          result.halfedge_texcoord_handle_ = m.halfedge_texcoord_handle_;
+          const std::size_t counts[num_element_kinds] = {header.num_vertices, 2 * header.num_edges, header.num_edges,
+            header.num_faces};
+          result.store_prev_ = header.store_prev != 0;
+          result.halfedge_next_.resize(counts[halfedge]);
+          if(result.store_prev_)
+            result.halfedge_prev_.resize(counts[halfedge]);
+          result.halfedge_target_.resize(counts[halfedge]);
+          result.halfedge_face_.resize(counts[halfedge]);
+          result.vertex_incoming_.resize(counts[vertex]);
+          result.face_halfedge_.resize(counts[face]);
+          result.vertex_status_.resize(counts[vertex]);
+          result.halfedge_status_.resize(counts[halfedge]);
+          result.edge_status_.resize(counts[edge]);
+          result.face_status_.resize(counts[face]);
+          result.vertex_properties_.resize(counts[vertex]);
+          result.halfedge_properties_.resize(counts[halfedge]);
+          result.edge_properties_.resize(counts[edge]);
+          result.face_properties_.resize(counts[face]);
+          auto connectivity = connectivity_arrays(result);
+          std::vector<bool> found(connectivity.size(), false);
+
+          //collects the copies first so that they can run in parallel
+          struct copy
+          {
+            void* destination;
+            const std::uint8_t* source;
+            std::size_t bytes;
+          };
+          std::vector<copy> copies;
+          const std::uint8_t* cursor = file.data() + sizeof(snapshot_header);
+          for(std::uint64_t i = 0; i < header.num_arrays; ++i)
+          {
+            snapshot_array entry;
+            if(static_cast<std::size_t>(file.end() - cursor) < sizeof(entry))
+              return false;
+            std::memcpy(&entry, cursor, sizeof(entry));
+            cursor += sizeof(entry);
+            std::size_t text_size = padded(std::size_t(entry.name_length) + entry.type_length, 8);
+            if(entry.element >= num_element_kinds || static_cast<std::size_t>(file.end() - cursor) < text_size)
+              return false;
+            std::string name(reinterpret_cast<const char*>(cursor), entry.name_length);
+            std::string type(reinterpret_cast<const char*>(cursor) + entry.name_length, entry.type_length);
+            cursor += text_size;
+
+            if(entry.offset % alignment != 0 || entry.offset > file.size() || (entry.value_size > 0
+              && (file.size() - entry.offset) / entry.value_size < counts[entry.element]))
+              return false;
+            std::size_t bytes = counts[entry.element] * entry.value_size;
+
+            void* destination = nullptr;
+            if(entry.slot == no_slot)
+            {
+              for(std::size_t k = 0; k < connectivity.size(); ++k)
+              {
+                auto& a = connectivity[k];
+                if(a.name != name)
+                  continue;
+                if(a.kind != entry.element || a.type != type || a.value_size != entry.value_size)
+                  return false;
+                destination = a.data;
+                found[k] = true;
+              }
+            }
+            else if(entry.element == vertex)
+              destination = property_destination(result.vertex_properties_, entry, name, type);
+            else if(entry.element == halfedge)
+              destination = property_destination(result.halfedge_properties_, entry, name, type);
+            else if(entry.element == edge)
+              destination = property_destination(result.edge_properties_, entry, name, type);
+            else
+              destination = property_destination(result.face_properties_, entry, name, type);
+            if(destination != nullptr && bytes > 0)
+              copies.push_back({destination, file.data() + entry.offset, bytes});
+          }
+          if(std::find(found.begin(), found.end(), false) != found.end())
+            return false;
+
+          //large arrays are split into blocks so that all threads take part
+          constexpr std::size_t block_size = 1 << 20;
+          std::vector<copy> blocks;
+          for(auto& c : copies)
+            for(std::size_t first = 0; first < c.bytes; first += block_size)
+              blocks.push_back({static_cast<std::uint8_t*>(c.destination) + first, c.source + first,
+                std::min(block_size, c.bytes - first)});
+          utils::parallel_for(std::size_t(0), blocks.size(), [&](std::size_t i)
+            {
+              std::memcpy(blocks[i].destination, blocks[i].source, blocks[i].bytes);
+            });
+          m = std::move(result);
+          return true;
+        }
+      };
+    }
+
+    //writes the mesh as native owlm snapshot, the connectivity, status and property arrays are stored as raw
+    //bytes behind a table naming each array and its element type. properties whose elements can not be copied
+    //as raw bytes and mesh properties are not stored. the file can only be read by builds with the same
+    //scalar type, mesh index type and byte order
+    template <typename Scalar>
+    bool write_owlm(const mesh<Scalar>& m, const std::string& p)
+    {
+      OWL_PROFILE_SCOPE("write_owlm");
+      return detail::mesh_snapshot<Scalar>::write(m, p);
+    }
+
+    //reads an owlm snapshot through a memory mapping copying each array with one memcpy, the connectivity is
+    //used as stored without any reconstruction. the properties of the mesh keep their slots and handles, a stored
+    //property is restored into the property in the same slot with the same name, type and element size and the
+    //properties which are not stored are reset to default values. other stored properties are added if their
+    //element type is a number, a vector, a color or a handle and skipped otherwise, they can be looked up by name
+    //with mesh::get_property. returns false and leaves the mesh unchanged if the file is not a compatible snapshot
+    template <typename Scalar>
+    bool read_owlm(mesh<Scalar>& m, const std::string& p)
+    {
+      OWL_PROFILE_SCOPE("read_owlm");
+      return detail::mesh_snapshot<Scalar>::read(m, p);
+    }
+  }
+}
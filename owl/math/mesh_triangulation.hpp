@@ -10,7 +10,8 @@
 #pragma once
 
 #include "owl/math/mesh.hpp"
-//#include "owl/utils/progress.hpp"
+#include "owl/utils/profiler.hpp"
+#include "owl/utils/progress.hpp"
 
 namespace owl
 {
@@ -237,6 +238,8 @@ namespace owl
     template <typename Scalar>
     class tesselator
     {
+      //number of faces triangulated between two progress updates
+      static constexpr std::size_t progress_step_size = 1 << 14;
   
       mesh<Scalar>& mesh_;
       bool update_normals_;
@@ -259,25 +262,33 @@ namespace owl
         tess.triangulate_convex();
       }
   
-      void triangulate_monoton()
+      //returns false if the triangulation was cancelled, the mesh is then only partially triangulated.
+      //a job cancelled before the call leaves the mesh unchanged
+      bool triangulate_monoton()
       {
-//        utils::progress progress(2*mesh_.num_faces() + mesh_.num_halfedges());
-  //      progress.make_current(mesh_.num_faces());
+        utils::progress progress(2 * mesh_.num_faces() + mesh_.num_halfedges());
+        if(progress.is_cancelled())
+          return false;
+        progress.make_current(mesh_.num_faces());
         {
-    //      utils::progress progress_tri(mesh_.num_faces());
+          utils::progress progress_tri(mesh_.num_faces());
           for(auto f : mesh_.faces())
           {
             triangulate_monoton(f);
-      //      progress.step();
+            if((f.index() + 1) % progress_step_size == 0 && !progress_tri.step(progress_step_size))
+              return false;
           }
         }
-       // progress.resign_current();
-       // progress.make_current(mesh_.num_faces() + mesh_.num_halfedges());
+        progress.resign_current();
+        if(progress.is_cancelled())
+          return false;
+        progress.make_current(mesh_.num_faces() + mesh_.num_halfedges());
       
         if(update_normals_)
           mesh_.update_normals();
       
-       // progress.resign_current();
+        progress.resign_current();
+        return true;
       }
     
       void triangulate_convex()
@@ -290,10 +301,11 @@ namespace owl
     };
   
   template <typename Scalar>
-  void triangulate_monoton(mesh<Scalar>& m)
+  bool triangulate_monoton(mesh<Scalar>& m)
   {
+    OWL_PROFILE_SCOPE("triangulate_monoton");
     auto tess = tesselator<Scalar>(m);
-    tess.triangulate_monoton();
+    return tess.triangulate_monoton();
   }
   
   template <typename Scalar>
@@ -0,0 +1,319 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "owl/math/matrix.hpp"
+#include "owl/math/utils.hpp"
+#include "owl/utils/hash_utils.hpp"
+#include "owl/utils/parallel.hpp"
+#include "owl/utils/profiler.hpp"
+#include "owl/utils/union_find.hpp"
+
+namespace owl
+{
+  namespace math
+  {
+    namespace detail
+    {
+      //flat open addressing table from cell hashes to the lists of points inside, the lists are threaded through
+      //one next index per point. cells are inserted concurrently by claiming an empty slot with compare exchange
+      //and pushing the point in front of the slot's list. cells with equal hashes share a list, so callers have
+      //to compare the points themselves
+      class concurrent_cell_table
+      {
+      public:
+        static constexpr std::size_t end = std::numeric_limits<std::size_t>::max();
+
+        explicit concurrent_cell_table(std::size_t num_points)
+          : capacity_(std::max<std::size_t>(next_pow_of_2(num_points + num_points / 2), 16))
+          , shift_(64 - count_bits(capacity_ - 1))
+          , slots_(std::make_unique<slot[]>(capacity_))
+          , next_(num_points, end)
+        {
+          utils::parallel_for(std::size_t(0), capacity_, [this](std::size_t i)
+            {
+              slots_[i].key.store(empty_key, std::memory_order_relaxed);
+              slots_[i].head.store(end, std::memory_order_relaxed);
+            });
+        }
+
+        void insert(std::uint64_t key, std::size_t point)
+        {
+          //the lists are only read after all insertions are joined, relaxed ordering suffices
+          next_[point] = claim(valid_key(key)).head.exchange(point, std::memory_order_relaxed);
+        }
+
+        //returns the first point of the list with given key or end
+        std::size_t find(std::uint64_t key) const
+        {
+          key = valid_key(key);
+          for(std::size_t i = index(key);; i = (i + 1) & (capacity_ - 1))
+          {
+            std::uint64_t k = slots_[i].key.load(std::memory_order_relaxed);
+            if(k == key)
+              return slots_[i].head.load(std::memory_order_relaxed);
+            if(k == empty_key)
+              return end;
+          }
+        }
+
+        std::size_t next(std::size_t point) const
+        {
+          return next_[point];
+        }
+
+      private:
+        static constexpr std::uint64_t empty_key = std::numeric_limits<std::uint64_t>::max();
+
+        struct slot
+        {
+          std::atomic<std::uint64_t> key;
+          std::atomic<std::size_t> head;
+        };
+
+        static std::size_t count_bits(std::size_t x)
+        {
+          std::size_t n = 0;
+          for(; x != 0; x >>= 1)
+            ++n;
+          return n;
+        }
+
+        static std::uint64_t valid_key(std::uint64_t key)
+        {
+          return key == empty_key ? key - 1 : key;
+        }
+
+        //fibonacci hashing spreads the weakly mixed combined hashes over the table
+        std::size_t index(std::uint64_t key) const
+        {
+          return static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ull) >> shift_);
+        }
+
+        slot& claim(std::uint64_t key)
+        {
+          for(std::size_t i = index(key);; i = (i + 1) & (capacity_ - 1))
+          {
+            std::uint64_t k = slots_[i].key.load(std::memory_order_relaxed);
+            if(k == empty_key && slots_[i].key.compare_exchange_strong(k, key, std::memory_order_relaxed))
+              return slots_[i];
+            if(k == key)
+              return slots_[i];
+          }
+        }
+
+        std::size_t capacity_;
+        std::size_t shift_;
+        std::unique_ptr<slot[]> slots_;
+        std::vector<std::size_t> next_;
+      };
+
+      inline std::int64_t weld_cell_coordinate(double x)
+      {
+        constexpr double bound = 1e18;
+        if(x > -bound && x < bound)
+          return static_cast<std::int64_t>(std::floor(x));
+        return static_cast<std::int64_t>(x > 0 ? bound : -bound);
+      }
+
+      inline std::uint64_t weld_cell_key(const std::array<std::int64_t, 3>& cell)
+      {
+        std::size_t seed = 0;
+        for(auto c : cell)
+          utils::hash_combine(seed, c);
+        return seed;
+      }
+
+      template <typename Scalar>
+      std::uint64_t weld_exact_key(const vector<Scalar, 3>& p)
+      {
+        //std::hash maps -0 and 0 to the same value
+        std::size_t seed = 0;
+        for(std::size_t i = 0; i < 3; ++i)
+          utils::hash_combine(seed, p[i]);
+        return seed;
+      }
+    }
+
+    //merges all positions closer than epsilon, chains of close positions are merged transitively.
+    //remap receives for each position the index of its welded vertex, the welded vertices are numbered in the
+    //order of their first position which also becomes their position. an epsilon of zero only merges equal
+    //positions. the positions are hashed into a flat grid of cell size 2 epsilon in parallel, each position is
+    //only compared against the positions in the eight cells touching its half of its cell, so the running time
+    //is linear as long as the number of positions per cell is bounded
+    template <typename Scalar>
+    std::vector<vector<Scalar, 3>> weld_vertices(const std::vector<vector<Scalar, 3>>& positions, Scalar epsilon,
+      std::vector<std::size_t>& remap)
+    {
+      OWL_PROFILE_FUNCTION();
+      using vector3 = vector<Scalar, 3>;
+      std::size_t n = positions.size();
+      utils::concurrent_union_find sets(n);
+      {
+        double inv_cell_size = epsilon > 0 ? 1 / (2 * double(epsilon)) : 0;
+        Scalar sqr_epsilon = epsilon * epsilon;
+        //cell of p and the direction towards the nearer neighbor cell along each axis
+        auto locate = [&](const vector3& p, std::array<std::int64_t, 3>& cell, std::array<std::int64_t, 3>& side)
+          {
+            for(std::size_t i = 0; i < 3; ++i)
+            {
+              double x = p[i] * inv_cell_size;
+              cell[i] = detail::weld_cell_coordinate(x);
+              side[i] = x - std::floor(x) < 0.5 ? -1 : 1;
+            }
+          };
+
+        detail::concurrent_cell_table cells(n);
+        utils::parallel_for(std::size_t(0), n, [&](std::size_t i)
+          {
+            if(epsilon > 0)
+            {
+              std::array<std::int64_t, 3> cell, side;
+              locate(positions[i], cell, side);
+              cells.insert(detail::weld_cell_key(cell), i);
+            }
+            else
+            {
+              cells.insert(detail::weld_exact_key(positions[i]), i);
+            }
+          });
+
+        //each pair is united by its larger index, the scan stops at the first equal position of smaller index
+        //since every position close to it is also close to that one and is thus united through it
+        utils::parallel_for(std::size_t(0), n, [&](std::size_t i)
+          {
+            const auto& p = positions[i];
+            if(epsilon > 0)
+            {
+              std::array<std::int64_t, 3> cell, side;
+              locate(p, cell, side);
+              for(std::size_t corner = 0; corner < 8; ++corner)
+              {
+                auto neighbor = cell;
+                for(std::size_t k = 0; k < 3; ++k)
+                  if(corner & (std::size_t(1) << k))
+                    neighbor[k] += side[k];
+                for(std::size_t j = cells.find(detail::weld_cell_key(neighbor)); j != cells.end; j = cells.next(j))
+                {
+                  if(j >= i || sqr_length(positions[j] - p) > sqr_epsilon)
+                    continue;
+                  sets.unite(i, j);
+                  if(positions[j] == p)
+                    return;
+                }
+              }
+            }
+            else
+            {
+              for(std::size_t j = cells.find(detail::weld_exact_key(p)); j != cells.end; j = cells.next(j))
+              {
+                if(j < i && positions[j] == p)
+                {
+                  sets.unite(i, j);
+                  return;
+                }
+              }
+            }
+          });
+      }
+
+      //the roots are the smallest positions of their sets, they are numbered by a prefix sum over blocks
+      constexpr std::size_t block_size = 1 << 16;
+      std::size_t num_blocks = (n + block_size - 1) / block_size;
+      std::vector<std::size_t> block_offsets(num_blocks + 1, 0);
+      utils::parallel_for(std::size_t(0), num_blocks, [&](std::size_t b)
+        {
+          std::size_t count = 0;
+          for(std::size_t i = b * block_size; i < std::min(n, (b + 1) * block_size); ++i)
+            count += sets.find(i) == i;
+          block_offsets[b + 1] = count;
+        });
+      std::partial_sum(block_offsets.begin(), block_offsets.end(), block_offsets.begin());
+
+      remap.resize(n);
+      std::vector<vector3> welded(block_offsets.back());
+      utils::parallel_for(std::size_t(0), num_blocks, [&](std::size_t b)
+        {
+          std::size_t id = block_offsets[b];
+          for(std::size_t i = b * block_size; i < std::min(n, (b + 1) * block_size); ++i)
+          {
+            if(sets.find(i) != i)
+              continue;
+            welded[id] = positions[i];
+            remap[i] = id++;
+          }
+        });
+      utils::parallel_for(std::size_t(0), n, [&](std::size_t i)
+        {
+          std::size_t root = sets.find(i);
+          if(root != i)
+            remap[i] = remap[root];
+        });
+      return welded;
+    }
+
+    //welds the vertices of a polygon soup in place, e.g. of triangles with separate corners as stored in stl files.
+    //positions are replaced by the welded vertices and face_indices are remapped, corners merged with their
+    //successor are dropped. faces with less than three corners left or with a repeated vertex are removed.
+    //face_offsets holds num_faces + 1 offsets as for mesh::build, which can build the result afterwards
+    template <typename Scalar>
+    void weld_soup(std::vector<vector<Scalar, 3>>& positions, std::vector<std::size_t>& face_offsets,
+      std::vector<std::size_t>& face_indices, Scalar epsilon)
+    {
+      OWL_PROFILE_FUNCTION();
+      std::vector<std::size_t> remap;
+      positions = weld_vertices(positions, epsilon, remap);
+
+      std::size_t num_faces = 0;
+      std::size_t num_indices = 0;
+      std::size_t face_begin = face_offsets.empty() ? 0 : face_offsets[0];
+      for(std::size_t f = 0; f + 1 < face_offsets.size(); ++f)
+      {
+        //faces and indices are compacted in place, the offsets are overwritten behind the read position
+        std::size_t face_end = face_offsets[f + 1];
+        std::size_t first = num_indices;
+        for(std::size_t i = face_begin; i < face_end; ++i)
+        {
+          std::size_t v = remap[face_indices[i]];
+          if(num_indices == first || face_indices[num_indices - 1] != v)
+            face_indices[num_indices++] = v;
+        }
+        while(num_indices - first > 1 && face_indices[num_indices - 1] == face_indices[first])
+          --num_indices;
+        face_begin = face_end;
+
+        auto begin = face_indices.begin() + first;
+        auto end = face_indices.begin() + num_indices;
+        bool repeated = false;
+        for(auto it = begin; it != end && !repeated; ++it)
+          repeated = std::find(it + 1, end, *it) != end;
+        if(num_indices - first < 3 || repeated)
+        {
+          num_indices = first;
+          continue;
+        }
+        face_offsets[++num_faces] = num_indices;
+      }
+      face_offsets.resize(num_faces + 1);
+      face_offsets[0] = 0;
+      face_indices.resize(num_indices);
+    }
+  }
+}
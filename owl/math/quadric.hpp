@@ -0,0 +1,96 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <array>
+#include <cmath>
+
+#include "owl/math/matrix.hpp"
+
+namespace owl
+{
+  namespace math
+  {
+    //symmetric 4x4 matrix q with q(p) = (p,1)^T q (p,1) measuring the weighted sum of squared distances of p
+    //to a set of planes (garland and heckbert 1997), only the 10 coefficients of the upper triangle are stored
+    template <typename Scalar>
+    class quadric
+    {
+    public:
+      using scalar = Scalar;
+      using vector3 = vector<Scalar, 3>;
+
+      quadric()
+        : c_{}
+      {
+      }
+
+      //weighted squared distance to the plane dot(normal, x) + d = 0 with a unit normal
+      static quadric plane(const vector3& normal, Scalar d, Scalar weight = 1)
+      {
+        quadric q;
+        Scalar a = normal[0], b = normal[1], c = normal[2];
+        q.c_ = {{a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d}};
+        for(auto& coeff : q.c_)
+          coeff *= weight;
+        return q;
+      }
+
+      quadric& operator+=(const quadric& other)
+      {
+        for(std::size_t i = 0; i < c_.size(); ++i)
+          c_[i] += other.c_[i];
+        return *this;
+      }
+
+      quadric operator+(const quadric& other) const
+      {
+        quadric q = *this;
+        q += other;
+        return q;
+      }
+
+      Scalar error(const vector3& p) const
+      {
+        Scalar x = p[0], y = p[1], z = p[2];
+        return x * (c_[0] * x + 2 * (c_[1] * y + c_[2] * z + c_[3]))
+          + y * (c_[4] * y + 2 * (c_[5] * z + c_[6]))
+          + z * (c_[7] * z + 2 * c_[8])
+          + c_[9];
+      }
+
+      //computes the point of least error, returns false if it is not unique because all planes are nearly parallel
+      //to a common line, e.g. in flat or cylindrical regions
+      bool minimizer(vector3& p) const
+      {
+        //cofactors of the upper left 3x3 block
+        Scalar c00 = c_[4] * c_[7] - c_[5] * c_[5];
+        Scalar c01 = c_[2] * c_[5] - c_[1] * c_[7];
+        Scalar c02 = c_[1] * c_[5] - c_[2] * c_[4];
+        Scalar c11 = c_[0] * c_[7] - c_[2] * c_[2];
+        Scalar c12 = c_[1] * c_[2] - c_[0] * c_[5];
+        Scalar c22 = c_[0] * c_[4] - c_[1] * c_[1];
+        Scalar det = c_[0] * c00 + c_[1] * c01 + c_[2] * c02;
+        Scalar trace = c_[0] + c_[4] + c_[7];
+        if(!(std::abs(det) > Scalar(1e-6) * trace * trace * trace))
+          return false;
+        Scalar inv_det = 1 / det;
+        p[0] = -(c00 * c_[3] + c01 * c_[6] + c02 * c_[8]) * inv_det;
+        p[1] = -(c01 * c_[3] + c11 * c_[6] + c12 * c_[8]) * inv_det;
+        p[2] = -(c02 * c_[3] + c12 * c_[6] + c22 * c_[8]) * inv_det;
+        return true;
+      }
+
+    private:
+      //a2 ab ac ad b2 bc bd c2 cd d2
+      std::array<Scalar, 10> c_;
+    };
+  }
+}
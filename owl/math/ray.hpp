@@ -8,7 +8,9 @@
 //
 
 #pragma once
+#include <algorithm>
 #include "owl/math/matrix.hpp"
+#include "owl/math/interval.hpp"
 
 namespace owl
 {
@@ -59,6 +61,48 @@ namespace owl
       vector direction_;
     };
     
+    //clips [t_min, t_max] against the slabs of box b, returns false if the ray misses b
+    template<typename Scalar, std::size_t Dimension, bool LowerBoundOpen, bool UpperBoundOpen>
+    bool intersect(const ray<Scalar, Dimension>& r, const interval<Scalar, Dimension, LowerBoundOpen, UpperBoundOpen>& b,
+      Scalar& t_min, Scalar& t_max)
+    {
+      for(std::size_t i = 0; i < Dimension; ++i)
+      {
+        Scalar t0 = (b.lower_bound[i] - r.origin[i]) * r.inv_direction()[i];
+        Scalar t1 = (b.upper_bound[i] - r.origin[i]) * r.inv_direction()[i];
+        if(r.inv_direction()[i] < 0)
+          std::swap(t0, t1);
+        t_min = t0 > t_min ? t0 : t_min;
+        t_max = t1 < t_max ? t1 : t_max;
+      }
+      return t_min <= t_max;
+    }
+
+    //moeller trumbore ray triangle intersection, on a hit within (t_min, t_max) returns true and sets t
+    //and the barycentric coordinates u and v of the hit point with respect to p1 and p2
+    template<typename Scalar>
+    bool intersect(const ray<Scalar, 3>& r, const vector<Scalar, 3>& p0, const vector<Scalar, 3>& p1,
+      const vector<Scalar, 3>& p2, Scalar t_min, Scalar t_max, Scalar& t, Scalar& u, Scalar& v)
+    {
+      auto e1 = p1 - p0;
+      auto e2 = p2 - p0;
+      auto p = cross(r.direction(), e2);
+      Scalar det = dot(e1, p);
+      if(det == 0)
+        return false;
+      Scalar inv_det = Scalar(1) / det;
+      auto s = r.origin - p0;
+      u = dot(s, p) * inv_det;
+      if(u < 0 || u > 1)
+        return false;
+      auto q = cross(s, e1);
+      v = dot(r.direction(), q) * inv_det;
+      if(v < 0 || u + v > 1)
+        return false;
+      t = dot(e2, q) * inv_det;
+      return t > t_min && t < t_max;
+    }
+
     using ray3f = ray<float, 3>;
     using ray3d = ray<double, 3>;
     using ray2f = ray<float, 2>;
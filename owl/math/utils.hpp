@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <type_traits>
 
 namespace owl
@@ -29,6 +30,7 @@ namespace owl
       x |= x >> 4;
       x |= x >> 8;
       x |= x >> 16;
+      x |= x >> 32;
       ++x;
       return x;
     }
@@ -38,6 +40,17 @@ namespace owl
       return x > 0 && !(x & (x - 1));
     }
   
+    //inserts two zero bits in front of each of the 10 lowest bits,
+    //interleaving three expanded coordinates gives their 30 bit morton code
+    inline std::uint32_t expand_bits(std::uint32_t v)
+    {
+      v = (v * 0x00010001u) & 0xff0000ffu;
+      v = (v * 0x00000101u) & 0x0f00f00fu;
+      v = (v * 0x00000011u) & 0xc30c30c3u;
+      v = (v * 0x00000005u) & 0x49249249u;
+      return v;
+    }
+  
   }
 }
 
@@ -10,8 +10,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <memory>
+#include <type_traits>
 
 #include "owl/export.hpp"
 #include "owl/utils/handle.hpp"
@@ -93,6 +95,10 @@ namespace owl
         return *this;
       }
     
+      property_container(property_container&&) = default;
+    
+      property_container& operator=(property_container&&) = default;
+    
       template <typename T>
       void add_property(property_handle<T>& p, const std::string& name = "")
       {
@@ -189,8 +195,22 @@ namespace owl
     
       virtual void move(std::size_t to, std::size_t from) = 0;
     
+      //replaces the elements by the elements at given indices, in that order
+      virtual void gather(const std::vector<std::size_t>& indices) = 0;
+    
+      //returns a new property holding copies of the elements at given indices, in that order
+      virtual std::unique_ptr<indexed_property_base> gathered(const std::vector<std::size_t>& indices) const = 0;
+    
       virtual std::unique_ptr<indexed_property_base> clone() const = 0;
     
+      //byte size of one element if the elements can be copied as raw bytes, 0 otherwise
+      virtual std::size_t value_size() const = 0;
+    
+      //the raw bytes of the elements if value_size() is not 0
+      virtual const void* data() const = 0;
+    
+      virtual void* data() = 0;
+    
       std::string name;
     
       virtual ~indexed_property_base() {}
@@ -224,16 +244,65 @@ namespace owl
         values[to] = std::move(values[from]);
       }
     
+      void gather(const std::vector<std::size_t>& indices) override
+      {
+        //ascending indices satisfy indices[i] >= i, so the values can be moved forward in place
+        if(std::is_sorted(indices.begin(), indices.end()))
+        {
+          for(std::size_t i = 0; i < indices.size(); ++i)
+            if(indices[i] != i)
+              values[i] = std::move(values[indices[i]]);
+          values.resize(indices.size());
+          return;
+        }
+        std::vector<T> gathered;
+        gathered.reserve(indices.size());
+        for(auto i : indices)
+          gathered.push_back(std::move(values[i]));
+        values.swap(gathered);
+      }
+    
+      std::unique_ptr<indexed_property_base> gathered(const std::vector<std::size_t>& indices) const override
+      {
+        auto result = std::make_unique<indexed_property>(name, 0);
+        result->values.reserve(indices.size());
+        for(auto i : indices)
+          result->values.push_back(values[i]);
+        return result;
+      }
+    
       std::unique_ptr<indexed_property_base> clone() const override
       {
         return std::make_unique<indexed_property>(*this);
       }
 
+      std::size_t value_size() const override
+      {
+        return is_raw ? sizeof(T) : 0;
+      }
+
+      const void* data() const override
+      {
+        if constexpr(is_raw)
+          return values.data();
+        return nullptr;
+      }
+
+      void* data() override
+      {
+        if constexpr(is_raw)
+          return values.data();
+        return nullptr;
+      }
+
       std::vector<T> values;
+
+    private:
+      static constexpr bool is_raw = std::is_trivially_copyable<T>::value && !std::is_same<T, bool>::value;
     };
   
 
-    template <typename Tag>
+    template <typename Tag, typename Index = std::size_t>
     class indexed_property_container
     {
     public:
@@ -269,11 +338,11 @@ namespace owl
       {
         auto it = owl::utils::find_if(properties_, [&name](auto& p)
           {
-            return p && p->name == name && dynamic_cast<indexed_property<T>>(p.get());
+            return p && p->name == name && dynamic_cast<indexed_property<T>*>(p.get());
           });
         if(it == properties_.end())
-          return indexed_property_handle<T,Tag>::invalid();
-        return { std::distance(properties_.begin(), it) };
+          return indexed_property_handle<T,Tag>();
+        return indexed_property_handle<T,Tag>(std::distance(properties_.begin(), it));
       }
     
       template <typename T>
@@ -305,6 +374,35 @@ namespace owl
         properties_.clear();
       }
     
+      //adds a property created without knowing its type, e.g. when reading stored properties,
+      //it is resized to the number of elements and its index is returned
+      std::size_t add_property(std::unique_ptr<indexed_property_base> p)
+      {
+        p->resize(num_elems_);
+        auto it = owl::utils::find(properties_, nullptr);
+        if(it == properties_.end())
+          it = properties_.insert(it, nullptr);
+        *it = std::move(p);
+        return static_cast<std::size_t>(std::distance(properties_.begin(), it));
+      }
+    
+      //number of property slots, slots of removed properties are empty
+      std::size_t num_properties() const
+      {
+        return properties_.size();
+      }
+    
+      //returns the property in slot i or nullptr if the slot is empty
+      const indexed_property_base* get_property_base(std::size_t i) const
+      {
+        return properties_[i].get();
+      }
+    
+      indexed_property_base* get_property_base(std::size_t i)
+      {
+        return properties_[i].get();
+      }
+    
       template <typename Func>
       void for_each_property(Func f)
       {
@@ -318,6 +416,26 @@ namespace owl
         for_each_property([&](auto& p){ p.move(to, from); });
       }
     
+      //replaces the elements by the elements at given indices, in that order,
+      //elements which are not listed are removed
+      void gather(const std::vector<std::size_t>& indices)
+      {
+        for_each_property([&](auto& p){ p.gather(indices); });
+        num_elems_ = indices.size();
+      }
+    
+      //returns a container with the same properties holding copies of the elements at given indices,
+      //the handles of this container are valid for the result
+      indexed_property_container gathered(const std::vector<std::size_t>& indices) const
+      {
+        indexed_property_container result;
+        result.num_elems_ = indices.size();
+        result.properties_.reserve(properties_.size());
+        for(auto& p : properties_)
+          result.properties_.push_back(p ? p->gathered(indices) : nullptr);
+        return result;
+      }
+    
       void reserve(std::size_t n)
       {
         for_each_property([&](auto& p){ p.reserve(n); });
@@ -334,9 +452,9 @@ namespace owl
         resize(0);
       }
     
-      handle<Tag> add_elem()
+      handle<Tag, Index> add_elem()
       {
-        auto h = owl::utils::handle<Tag> {num_elems_};
+        auto h = owl::utils::handle<Tag, Index>(static_cast<Index>(num_elems_));
         resize(num_elems_ + 1);
         return h;
       }
@@ -344,10 +462,10 @@ namespace owl
       //elem interface
       auto add_elems(std::size_t n)
       {
-        owl::utils::handle<Tag> first{num_elems_};
+        owl::utils::handle<Tag, Index> first(static_cast<Index>(num_elems_));
         resize(num_elems_ + n);
-        return make_iterator_range(count_iterator<handle<Tag>>(first),
-          count_iterator<handle<Tag>>(owl::utils::handle<Tag>(num_elems_)));
+        return make_iterator_range(count_iterator<handle<Tag, Index>>(first),
+          count_iterator<handle<Tag, Index>>(owl::utils::handle<Tag, Index>(static_cast<Index>(num_elems_))));
       }
     
       indexed_property_container() = default;
@@ -357,6 +475,10 @@ namespace owl
         *this = other;
       }
     
+      indexed_property_container(indexed_property_container&&) = default;
+    
+      indexed_property_container& operator=(indexed_property_container&&) = default;
+    
       indexed_property_container& operator=(const indexed_property_container& other)
       {
         if(this == &other)
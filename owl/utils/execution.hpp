@@ -0,0 +1,49 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <type_traits>
+
+namespace owl
+{
+  namespace utils
+  {
+    //execution policies selecting the sequential or parallel overloads of the range algorithms,
+    //modeled after std::execution which is not available on all supported toolchains
+    namespace execution
+    {
+      struct sequenced_policy
+      {
+      };
+
+      struct parallel_policy
+      {
+      };
+
+      constexpr sequenced_policy seq{};
+      constexpr parallel_policy par{};
+
+      template <typename T>
+      struct is_execution_policy : std::false_type
+      {
+      };
+
+      template <>
+      struct is_execution_policy<sequenced_policy> : std::true_type
+      {
+      };
+
+      template <>
+      struct is_execution_policy<parallel_policy> : std::true_type
+      {
+      };
+    }
+  }
+}
@@ -38,7 +38,7 @@ namespace owl
       handle& operator=(const handle&) = default;
       handle& operator=(handle&&) = default;
       
-      inline const std::size_t& index() const
+      inline const index_type& index() const
       {
         return index_;
       }
@@ -0,0 +1,202 @@
+#include "owl/utils/mapped_file.hpp"
+
+#include <utility>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+namespace owl
+{
+  namespace utils
+  {
+    mapped_file::mapped_file()
+      : data_(nullptr)
+      , size_(0)
+      , is_open_(false)
+#ifdef WIN32
+      , file_handle_(INVALID_HANDLE_VALUE)
+      , mapping_handle_(nullptr)
+#else
+      , file_descriptor_(-1)
+#endif
+    {
+    }
+
+    mapped_file::mapped_file(const std::string& path)
+      : mapped_file()
+    {
+      open(path);
+    }
+
+    mapped_file::mapped_file(mapped_file&& other)
+      : mapped_file()
+    {
+      swap(other);
+    }
+
+    mapped_file& mapped_file::operator=(mapped_file&& other)
+    {
+      if(this != &other)
+      {
+        close();
+        swap(other);
+      }
+      return *this;
+    }
+
+    mapped_file::~mapped_file()
+    {
+      close();
+    }
+
+    void mapped_file::swap(mapped_file& other)
+    {
+      std::swap(data_, other.data_);
+      std::swap(size_, other.size_);
+      std::swap(is_open_, other.is_open_);
+#ifdef WIN32
+      std::swap(file_handle_, other.file_handle_);
+      std::swap(mapping_handle_, other.mapping_handle_);
+#else
+      std::swap(file_descriptor_, other.file_descriptor_);
+#endif
+    }
+
+#ifdef WIN32
+    bool mapped_file::open(const std::string& path)
+    {
+      close();
+      file_handle_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+      if(file_handle_ == INVALID_HANDLE_VALUE)
+        return false;
+
+      LARGE_INTEGER file_size;
+      if(!GetFileSizeEx(file_handle_, &file_size))
+      {
+        close();
+        return false;
+      }
+      size_ = static_cast<size_type>(file_size.QuadPart);
+      is_open_ = true;
+      if(size_ == 0)
+        return true;
+
+      mapping_handle_ = CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if(mapping_handle_ == nullptr)
+      {
+        close();
+        return false;
+      }
+      data_ = static_cast<const_pointer>(MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+      if(data_ == nullptr)
+      {
+        close();
+        return false;
+      }
+      return true;
+    }
+
+    void mapped_file::close()
+    {
+      if(data_ != nullptr)
+        UnmapViewOfFile(data_);
+      if(mapping_handle_ != nullptr)
+        CloseHandle(mapping_handle_);
+      if(file_handle_ != INVALID_HANDLE_VALUE)
+        CloseHandle(file_handle_);
+      data_ = nullptr;
+      size_ = 0;
+      is_open_ = false;
+      mapping_handle_ = nullptr;
+      file_handle_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    bool mapped_file::open(const std::string& path)
+    {
+      close();
+      file_descriptor_ = ::open(path.c_str(), O_RDONLY);
+      if(file_descriptor_ < 0)
+        return false;
+
+      struct stat file_stat;
+      if(fstat(file_descriptor_, &file_stat) != 0)
+      {
+        close();
+        return false;
+      }
+      size_ = static_cast<size_type>(file_stat.st_size);
+      is_open_ = true;
+      if(size_ == 0)
+        return true;
+
+      void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_descriptor_, 0);
+      if(addr == MAP_FAILED)
+      {
+        close();
+        return false;
+      }
+      madvise(addr, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const_pointer>(addr);
+      return true;
+    }
+
+    void mapped_file::close()
+    {
+      if(data_ != nullptr)
+        munmap(const_cast<std::uint8_t*>(data_), size_);
+      if(file_descriptor_ >= 0)
+        ::close(file_descriptor_);
+      data_ = nullptr;
+      size_ = 0;
+      is_open_ = false;
+      file_descriptor_ = -1;
+    }
+#endif
+
+    bool mapped_file::is_open() const
+    {
+      return is_open_;
+    }
+
+    mapped_file::const_pointer mapped_file::data() const
+    {
+      return data_;
+    }
+
+    mapped_file::size_type mapped_file::size() const
+    {
+      return size_;
+    }
+
+    bool mapped_file::empty() const
+    {
+      return size_ == 0;
+    }
+
+    mapped_file::const_iterator mapped_file::begin() const
+    {
+      return data_;
+    }
+
+    mapped_file::const_iterator mapped_file::end() const
+    {
+      return data_ + size_;
+    }
+  }
+}
@@ -0,0 +1,87 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "owl/export.hpp"
+#include "owl/utils/non_copyable.hpp"
+
+namespace owl
+{
+  namespace utils
+  {
+    /**
+     * A read only memory mapping of a whole file.
+     * The mapped bytes stay valid until close() is called or the mapped_file is destroyed.
+     */
+    class OWL_API mapped_file : non_copyable
+    {
+    public:
+      using value_type = std::uint8_t;
+      using size_type = std::size_t;
+      using const_pointer = const std::uint8_t*;
+      using const_iterator = const std::uint8_t*;
+
+      mapped_file();
+
+      /**
+       * Create a mapped_file and calls open(path)
+       */
+      explicit mapped_file(const std::string& path);
+
+      mapped_file(mapped_file&& other);
+
+      mapped_file& operator=(mapped_file&& other);
+
+      ~mapped_file();
+
+      /**
+       * Map the file at given path into memory, a previously mapped file is closed.
+       * @return true if the file could be mapped
+       */
+      bool open(const std::string& path);
+
+      /**
+       * Unmap the file.
+       */
+      void close();
+
+      /**
+       * @return true if a file is mapped
+       */
+      bool is_open() const;
+
+      const_pointer data() const;
+
+      size_type size() const;
+
+      bool empty() const;
+
+      const_iterator begin() const;
+
+      const_iterator end() const;
+
+    private:
+      void swap(mapped_file& other);
+
+      const_pointer data_;
+      size_type size_;
+      bool is_open_;
+#ifdef WIN32
+      void* file_handle_;
+      void* mapping_handle_;
+#else
+      int file_descriptor_;
+#endif
+    };
+  }
+}
@@ -0,0 +1,177 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace owl
+{
+  namespace utils
+  {
+    //binary heap of the indices [0, n) ordered by their priorities, the smallest priority is on top.
+    //in contrast to std::priority_queue the priority of a queued index can be changed and any index
+    //can be removed in O(log n), the position of each index in the heap is tracked for that
+    template <typename Priority, typename Compare = std::less<Priority>>
+    class mutable_priority_queue
+    {
+    public:
+      struct entry
+      {
+        Priority priority;
+        std::size_t index;
+      };
+
+      explicit mutable_priority_queue(std::size_t n = 0, Compare compare = Compare())
+        : positions_(n, npos)
+        , compare_(std::move(compare))
+      {
+      }
+
+      //replaces the content by entries with distinct indices in [0, n) in O(n)
+      void assign(std::size_t n, std::vector<entry> entries)
+      {
+        heap_ = std::move(entries);
+        positions_.assign(n, npos);
+        for(std::size_t i = 0; i < heap_.size(); ++i)
+          positions_[heap_[i].index] = i;
+        for(std::size_t i = heap_.size() / 2; i-- > 0;)
+          sift_down(i);
+      }
+
+      bool empty() const
+      {
+        return heap_.empty();
+      }
+
+      std::size_t size() const
+      {
+        return heap_.size();
+      }
+
+      bool contains(std::size_t index) const
+      {
+        return positions_[index] != npos;
+      }
+
+      const Priority& priority(std::size_t index) const
+      {
+        assert(contains(index));
+        return heap_[positions_[index]].priority;
+      }
+
+      std::size_t top() const
+      {
+        return heap_.front().index;
+      }
+
+      const Priority& top_priority() const
+      {
+        return heap_.front().priority;
+      }
+
+      //inserts index or changes its priority if it is already queued
+      void push(std::size_t index, Priority priority)
+      {
+        std::size_t i = positions_[index];
+        if(i == npos)
+        {
+          i = heap_.size();
+          heap_.push_back(entry{std::move(priority), index});
+          positions_[index] = i;
+          sift_up(i);
+          return;
+        }
+        bool decreased = compare_(priority, heap_[i].priority);
+        heap_[i].priority = std::move(priority);
+        if(decreased)
+          sift_up(i);
+        else
+          sift_down(i);
+      }
+
+      void pop()
+      {
+        remove(top());
+      }
+
+      //removes index if it is queued
+      void remove(std::size_t index)
+      {
+        std::size_t i = positions_[index];
+        if(i == npos)
+          return;
+        positions_[index] = npos;
+        std::size_t last = heap_.size() - 1;
+        if(i != last)
+        {
+          heap_[i] = std::move(heap_[last]);
+          positions_[heap_[i].index] = i;
+        }
+        heap_.pop_back();
+        if(i < heap_.size())
+        {
+          sift_up(i);
+          sift_down(i);
+        }
+      }
+
+    private:
+      static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+      void move_to(std::size_t i, entry e)
+      {
+        positions_[e.index] = i;
+        heap_[i] = std::move(e);
+      }
+
+      void sift_up(std::size_t i)
+      {
+        entry e = std::move(heap_[i]);
+        while(i > 0)
+        {
+          std::size_t parent = (i - 1) / 2;
+          if(!compare_(e.priority, heap_[parent].priority))
+            break;
+          move_to(i, std::move(heap_[parent]));
+          i = parent;
+        }
+        move_to(i, std::move(e));
+      }
+
+      void sift_down(std::size_t i)
+      {
+        entry e = std::move(heap_[i]);
+        std::size_t n = heap_.size();
+        while(true)
+        {
+          std::size_t child = 2 * i + 1;
+          if(child >= n)
+            break;
+          if(child + 1 < n && compare_(heap_[child + 1].priority, heap_[child].priority))
+            ++child;
+          if(!compare_(heap_[child].priority, e.priority))
+            break;
+          move_to(i, std::move(heap_[child]));
+          i = child;
+        }
+        move_to(i, std::move(e));
+      }
+
+      std::vector<entry> heap_;
+      std::vector<std::size_t> positions_;
+      Compare compare_;
+    };
+  }
+}
@@ -0,0 +1,167 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "owl/utils/iterator_range.hpp"
+#include "owl/utils/task_scheduler.hpp"
+
+namespace owl
+{
+  namespace utils
+  {
+    //number of threads used by the parallel algorithms
+    inline std::size_t num_threads()
+    {
+      return task_scheduler::instance().num_threads();
+    }
+
+    namespace detail
+    {
+      //grain size giving each thread about 8 chunks so that stealing can balance uneven work
+      inline std::size_t default_grain_size(std::size_t n)
+      {
+        return std::max<std::size_t>(1, n / (8 * num_threads()));
+      }
+
+      //splits [first, last) in halves until the pieces are shorter than 2 * grain_size, the upper halves
+      //are queued as tasks which idle workers can steal
+      template <typename Fn>
+      void split_range(task_group& group, std::size_t first, std::size_t last, std::size_t grain_size, const Fn& fn)
+      {
+        while(last - first >= 2 * grain_size)
+        {
+          std::size_t mid = first + (last - first) / 2;
+          group.run([&group, mid, last, grain_size, &fn]{ split_range(group, mid, last, grain_size, fn); });
+          last = mid;
+        }
+        fn(first, last);
+      }
+
+      //calls fn(block_first, block_last) for chunks of [0, n) with at least grain_size elements in parallel
+      template <typename Fn>
+      void parallel_chunks(std::size_t n, std::size_t grain_size, const Fn& fn)
+      {
+        if(n == 0)
+          return;
+        grain_size = std::max<std::size_t>(grain_size, 1);
+        if(n < 2 * grain_size || num_threads() == 1)
+        {
+          fn(std::size_t(0), n);
+          return;
+        }
+        task_group group;
+        split_range(group, 0, n, grain_size, fn);
+        group.wait();
+      }
+    }
+
+    //calls fn(i) for each i in [first, last) in parallel
+    template <typename Index, typename Fn>
+    void parallel_for(Index first, Index last, Fn&& fn)
+    {
+      if(!(first < last))
+        return;
+      std::size_t n = static_cast<std::size_t>(last - first);
+      detail::parallel_chunks(n, detail::default_grain_size(n), [&](std::size_t block_first, std::size_t block_last)
+        {
+          for(Index i = first + static_cast<Index>(block_first); i < first + static_cast<Index>(block_last); ++i)
+            fn(i);
+        });
+    }
+
+    //calls fn(x) for each element x of a random access range in parallel,
+    //e.g. parallel_for(m.faces(), [&](face_handle f){ ... })
+    template <typename Range, typename Fn>
+    void parallel_for(Range&& range, Fn&& fn)
+    {
+      auto first = std::begin(range);
+      std::size_t n = static_cast<std::size_t>(std::distance(first, std::end(range)));
+      using difference_type = typename std::iterator_traits<decltype(first)>::difference_type;
+      detail::parallel_chunks(n, detail::default_grain_size(n), [&](std::size_t block_first, std::size_t block_last)
+        {
+          auto it = first + static_cast<difference_type>(block_first);
+          for(std::size_t i = block_first; i < block_last; ++i, ++it)
+            fn(*it);
+        });
+    }
+
+    //calls fn(block_first, block_last) for contiguous blocks of [first, last) in parallel,
+    //each block has at least min_block_size elements so that small ranges run on the calling thread
+    template <typename Index, typename Fn>
+    void parallel_for_blocks(Index first, Index last, std::size_t min_block_size, Fn&& fn)
+    {
+      if(!(first < last))
+        return;
+      std::size_t n = static_cast<std::size_t>(last - first);
+      detail::parallel_chunks(n, std::max(min_block_size, detail::default_grain_size(n)),
+        [&](std::size_t block_first, std::size_t block_last)
+        {
+          fn(first + static_cast<Index>(block_first), first + static_cast<Index>(block_last));
+        });
+    }
+
+    //calls fn(sub_range) for contiguous sub ranges of a random access range in parallel,
+    //each sub range has at least min_block_size elements
+    template <typename Range, typename Fn>
+    void parallel_for_blocks(Range&& range, std::size_t min_block_size, Fn&& fn)
+    {
+      auto first = std::begin(range);
+      std::size_t n = static_cast<std::size_t>(std::distance(first, std::end(range)));
+      using difference_type = typename std::iterator_traits<decltype(first)>::difference_type;
+      detail::parallel_chunks(n, std::max(min_block_size, detail::default_grain_size(n)),
+        [&](std::size_t block_first, std::size_t block_last)
+        {
+          fn(make_iterator_range(first + static_cast<difference_type>(block_first),
+            first + static_cast<difference_type>(block_last)));
+        });
+    }
+
+    //returns reduce(...reduce(reduce(init, fn(first)), fn(first + 1))..., fn(last - 1)) computed in parallel,
+    //reduce has to be associative, the partial results are combined in order so the result does not depend
+    //on the scheduling
+    template <typename Index, typename T, typename Fn, typename Reduce>
+    T parallel_reduce(Index first, Index last, T init, Fn&& fn, Reduce&& reduce)
+    {
+      if(!(first < last))
+        return init;
+      std::size_t n = static_cast<std::size_t>(last - first);
+      std::size_t grain_size = detail::default_grain_size(n);
+      std::size_t n_blocks = (n + grain_size - 1) / grain_size;
+      std::vector<T> partials(n_blocks, init);
+      parallel_for(std::size_t(0), n_blocks, [&](std::size_t b)
+        {
+          Index block_first = first + static_cast<Index>(b * grain_size);
+          Index block_last = first + static_cast<Index>(std::min(n, (b + 1) * grain_size));
+          T partial = fn(block_first);
+          for(Index i = block_first + 1; i < block_last; ++i)
+            partial = reduce(std::move(partial), fn(i));
+          partials[b] = std::move(partial);
+        });
+      for(auto& partial : partials)
+        init = reduce(std::move(init), std::move(partial));
+      return init;
+    }
+
+    //parallel_reduce over the elements of a random access range,
+    //e.g. parallel_reduce(m.faces(), 0.0f, [&](face_handle f){ return m.area(f); }, std::plus<>())
+    template <typename Range, typename T, typename Fn, typename Reduce>
+    T parallel_reduce(Range&& range, T init, Fn&& fn, Reduce&& reduce)
+    {
+      auto first = std::begin(range);
+      using difference_type = typename std::iterator_traits<decltype(first)>::difference_type;
+      return parallel_reduce(difference_type(0), std::distance(first, std::end(range)), std::move(init),
+        [&](difference_type i){ return fn(first[i]); }, std::forward<Reduce>(reduce));
+    }
+  }
+}
@@ -0,0 +1,191 @@
+#include "owl/utils/profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+
+namespace owl
+{
+  namespace utils
+  {
+    struct profiler::thread_buffer
+    {
+      explicit thread_buffer(std::uint32_t thread)
+        : events(buffer_capacity)
+        , num_written(0)
+        , thread(thread)
+      {
+      }
+
+      std::vector<event> events;
+      std::atomic<std::uint64_t> num_written;
+      std::uint32_t thread;
+    };
+
+    namespace
+    {
+      const auto program_start = std::chrono::steady_clock::now();
+
+      //nesting depth of the open zones of this thread
+      thread_local std::uint32_t zone_depth = 0;
+
+      void write_json_string(std::ostream& out, const char* text)
+      {
+        out << '"';
+        for(; *text != '\0'; ++text)
+        {
+          if(*text == '"' || *text == '\\')
+            out << '\\';
+          out << *text;
+        }
+        out << '"';
+      }
+
+      double percentile(const std::vector<std::int64_t>& sorted, double p)
+      {
+        std::size_t i = static_cast<std::size_t>(p * (sorted.size() - 1) + 0.5);
+        return sorted[i] * 1e-9;
+      }
+    }
+
+    profiler& profiler::instance()
+    {
+      static profiler p;
+      return p;
+    }
+
+    std::int64_t profiler::now()
+    {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - program_start).count();
+    }
+
+    profiler::thread_buffer& profiler::local_buffer()
+    {
+      //the buffer is shared with the profiler so that zones of finished threads are kept
+      thread_local std::shared_ptr<thread_buffer> buffer;
+      if(!buffer)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer = std::make_shared<thread_buffer>(static_cast<std::uint32_t>(buffers_.size() + 1));
+        buffers_.push_back(buffer);
+      }
+      return *buffer;
+    }
+
+    void profiler::record(const char* name, std::int64_t start, std::int64_t end, std::uint32_t depth)
+    {
+      auto& buffer = local_buffer();
+      std::uint64_t n = buffer.num_written.load(std::memory_order_relaxed);
+      buffer.events[n % buffer_capacity] = event{name, buffer.thread, depth, start, end - start};
+      buffer.num_written.store(n + 1, std::memory_order_release);
+    }
+
+    std::vector<profiler::event> profiler::events() const
+    {
+      std::vector<event> result;
+      std::lock_guard<std::mutex> lock(mutex_);
+      for(const auto& buffer : buffers_)
+      {
+        std::uint64_t n = buffer->num_written.load(std::memory_order_acquire);
+        std::uint64_t first = n > buffer_capacity ? n - buffer_capacity : 0;
+        std::size_t offset = result.size();
+        for(std::uint64_t i = first; i < n; ++i)
+          result.push_back(buffer->events[i % buffer_capacity]);
+        std::stable_sort(result.begin() + offset, result.end(),
+          [](const event& a, const event& b){ return a.start < b.start; });
+      }
+      return result;
+    }
+
+    std::vector<profiler::zone_statistics> profiler::statistics() const
+    {
+      std::map<std::string, std::vector<std::int64_t>> durations;
+      for(const auto& e : events())
+        durations[e.name].push_back(e.duration);
+
+      std::vector<zone_statistics> result;
+      for(auto& [name, times] : durations)
+      {
+        std::sort(times.begin(), times.end());
+        zone_statistics s;
+        s.name = name;
+        s.count = times.size();
+        s.total = 0;
+        for(auto t : times)
+          s.total += t * 1e-9;
+        s.min = times.front() * 1e-9;
+        s.max = times.back() * 1e-9;
+        s.mean = s.total / s.count;
+        s.median = percentile(times, 0.5);
+        s.p90 = percentile(times, 0.9);
+        s.p99 = percentile(times, 0.99);
+        result.push_back(s);
+      }
+      std::sort(result.begin(), result.end(),
+        [](const zone_statistics& a, const zone_statistics& b){ return a.total > b.total; });
+      return result;
+    }
+
+    std::size_t profiler::num_dropped_events() const
+    {
+      std::size_t n = 0;
+      std::lock_guard<std::mutex> lock(mutex_);
+      for(const auto& buffer : buffers_)
+      {
+        std::uint64_t written = buffer->num_written.load(std::memory_order_acquire);
+        if(written > buffer_capacity)
+          n += static_cast<std::size_t>(written - buffer_capacity);
+      }
+      return n;
+    }
+
+    void profiler::clear()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for(auto& buffer : buffers_)
+        buffer->num_written.store(0, std::memory_order_release);
+    }
+
+    void profiler::write_chrome_trace(std::ostream& out) const
+    {
+      out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+      out << std::fixed << std::setprecision(3);
+      bool first = true;
+      for(const auto& e : events())
+      {
+        out << (first ? "\n" : ",\n") << "  {\"name\": ";
+        write_json_string(out, e.name);
+        out << ", \"cat\": \"owl\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << e.thread
+          << ", \"ts\": " << e.start * 1e-3 << ", \"dur\": " << e.duration * 1e-3
+          << ", \"args\": {\"depth\": " << e.depth << "}}";
+        first = false;
+      }
+      out << "\n]}\n";
+    }
+
+    bool profiler::write_chrome_trace(const std::string& path) const
+    {
+      std::ofstream out(path);
+      if(!out)
+        return false;
+      write_chrome_trace(out);
+      return static_cast<bool>(out);
+    }
+
+    profile_zone::profile_zone(const char* name)
+      : name_(name)
+      , start_(profiler::now())
+      , depth_(zone_depth++)
+    {
+    }
+
+    profile_zone::~profile_zone()
+    {
+      --zone_depth;
+      profiler::instance().record(name_, start_, profiler::now(), depth_);
+    }
+  }
+}
@@ -0,0 +1,169 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "owl/export.hpp"
+#include "owl/utils/non_copyable.hpp"
+
+#define OWL_PROFILE_CONCAT_IMPL(a, b) a##b
+#define OWL_PROFILE_CONCAT(a, b) OWL_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef OWL_ENABLE_PROFILER
+/**
+ * Record the time from this line to the end of the enclosing scope as zone with given name,
+ * name has to be a string literal or outlive the profiler. Expands to nothing if OWL_ENABLE_PROFILER is not defined.
+ */
+#define OWL_PROFILE_SCOPE(name) ::owl::utils::profile_zone OWL_PROFILE_CONCAT(owl_profile_zone_, __LINE__)(name)
+#else
+#define OWL_PROFILE_SCOPE(name)
+#endif
+
+#if defined(OWL_ENABLE_PROFILER) && defined(OWL_ENABLE_FINE_PROFILER)
+/**
+ * Like OWL_PROFILE_SCOPE for zones entered very often, e.g. once per face, which would fill the ring buffers
+ * and slow down the surrounding code. Expands to nothing unless OWL_ENABLE_FINE_PROFILER is defined as well.
+ */
+#define OWL_PROFILE_FINE_SCOPE(name) OWL_PROFILE_SCOPE(name)
+#else
+#define OWL_PROFILE_FINE_SCOPE(name)
+#endif
+
+/**
+ * Record the enclosing function as zone.
+ */
+#define OWL_PROFILE_FUNCTION() OWL_PROFILE_SCOPE(__func__)
+
+namespace owl
+{
+  namespace utils
+  {
+    /**
+     * Collects the zones recorded by profile_zone.
+     * Each thread records into its own ring buffer without taking a lock, when a buffer is full the oldest
+     * zones of that thread are overwritten. The collected zones are read by events(), statistics() and
+     * write_chrome_trace(), which should be called while no zones are recorded.
+     */
+    class OWL_API profiler : non_copyable
+    {
+    public:
+      /**
+       * Number of zones kept per thread.
+       */
+      static constexpr std::size_t buffer_capacity = 1 << 16;
+
+      /**
+       * A finished zone, times are given in nano seconds since the start of the program.
+       */
+      struct event
+      {
+        const char* name;
+        std::uint32_t thread;
+        std::uint32_t depth;
+        std::int64_t start;
+        std::int64_t duration;
+      };
+
+      /**
+       * Aggregated durations of all zones with the same name in seconds.
+       */
+      struct zone_statistics
+      {
+        std::string name;
+        std::size_t count;
+        double total;
+        double min;
+        double max;
+        double mean;
+        double median;
+        double p90;
+        double p99;
+      };
+
+      /**
+       * @return the profiler collecting the zones of all threads
+       */
+      static profiler& instance();
+
+      /**
+       * @return nano seconds since the start of the program
+       */
+      static std::int64_t now();
+
+      /**
+       * Record a finished zone of the calling thread.
+       */
+      void record(const char* name, std::int64_t start, std::int64_t end, std::uint32_t depth);
+
+      /**
+       * @return the recorded zones of all threads ordered by thread and start time
+       */
+      std::vector<event> events() const;
+
+      /**
+       * @return the statistics of all zones sorted by descending total time
+       */
+      std::vector<zone_statistics> statistics() const;
+
+      /**
+       * @return number of zones overwritten because a ring buffer was full
+       */
+      std::size_t num_dropped_events() const;
+
+      /**
+       * Discard all recorded zones.
+       */
+      void clear();
+
+      /**
+       * Write the recorded zones in the chrome trace event format which can be loaded by chrome://tracing
+       * or https://ui.perfetto.dev.
+       */
+      void write_chrome_trace(std::ostream& out) const;
+
+      /**
+       * @return true if the chrome trace could be written to file at given path
+       */
+      bool write_chrome_trace(const std::string& path) const;
+
+    private:
+      struct thread_buffer;
+
+      profiler() = default;
+
+      thread_buffer& local_buffer();
+
+      mutable std::mutex mutex_;
+      std::vector<std::shared_ptr<thread_buffer>> buffers_;
+    };
+
+    /**
+     * Records the lifetime of the object as zone, use it through the OWL_PROFILE_SCOPE macro.
+     */
+    class OWL_API profile_zone : non_copyable
+    {
+    public:
+      explicit profile_zone(const char* name);
+
+      ~profile_zone();
+
+    private:
+      const char* name_;
+      std::int64_t start_;
+      std::uint32_t depth_;
+    };
+  }
+}
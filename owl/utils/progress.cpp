@@ -0,0 +1,109 @@
+#include "owl/utils/progress.hpp"
+
+#include <algorithm>
+
+namespace owl
+{
+  namespace utils
+  {
+    namespace
+    {
+      thread_local progress* current_progress = nullptr;
+    }
+
+    progress::progress(std::uint64_t total_steps)
+      : total_steps_(total_steps)
+      , completed_steps_(0)
+      , cancelled_(false)
+      , parent_(current_progress)
+      , steps_in_parent_(0)
+      , previous_current_(nullptr)
+      , pending_steps_(0)
+    {
+      //only the first child created while the parent is current accounts for the pending steps
+      if(parent_ != nullptr)
+      {
+        steps_in_parent_ = parent_->pending_steps_;
+        parent_->pending_steps_ = 0;
+      }
+    }
+
+    progress::~progress()
+    {
+      if(current_progress == this)
+        resign_current();
+      if(parent_ != nullptr)
+        parent_->advance(steps_in_parent_ - steps_in_parent(completed_steps_));
+    }
+
+    bool progress::step(std::uint64_t n)
+    {
+      advance(n);
+      return !is_cancelled();
+    }
+
+    std::uint64_t progress::total_steps() const
+    {
+      return total_steps_;
+    }
+
+    std::uint64_t progress::completed_steps() const
+    {
+      return std::min(completed_steps_.load(std::memory_order_relaxed), total_steps_);
+    }
+
+    double progress::fraction() const
+    {
+      return total_steps_ == 0 ? 0.0 : static_cast<double>(completed_steps()) / total_steps_;
+    }
+
+    void progress::cancel()
+    {
+      cancelled_ = true;
+    }
+
+    bool progress::is_cancelled() const
+    {
+      return cancelled_.load(std::memory_order_relaxed) || (parent_ != nullptr && parent_->is_cancelled());
+    }
+
+    void progress::make_current(std::uint64_t pending_steps)
+    {
+      previous_current_ = current_progress;
+      current_progress = this;
+      pending_steps_ = pending_steps;
+    }
+
+    void progress::resign_current()
+    {
+      current_progress = previous_current_;
+      previous_current_ = nullptr;
+      advance(pending_steps_);
+      pending_steps_ = 0;
+    }
+
+    progress* progress::current()
+    {
+      return current_progress;
+    }
+
+    void progress::advance(std::uint64_t n)
+    {
+      if(n == 0)
+        return;
+      std::uint64_t old = completed_steps_.fetch_add(n, std::memory_order_relaxed);
+      //the differences of concurrent calls sum up to the steps of the final count
+      if(parent_ != nullptr)
+        parent_->advance(steps_in_parent(old + n) - steps_in_parent(old));
+    }
+
+    std::uint64_t progress::steps_in_parent(std::uint64_t completed) const
+    {
+      if(total_steps_ == 0)
+        return 0;
+      if(completed >= total_steps_)
+        return steps_in_parent_;
+      return static_cast<std::uint64_t>(static_cast<double>(steps_in_parent_) * completed / total_steps_);
+    }
+  }
+}
@@ -0,0 +1,113 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "owl/export.hpp"
+#include "owl/utils/non_copyable.hpp"
+
+namespace owl
+{
+  namespace utils
+  {
+    /**
+     * Tracks the completed steps of an operation and lets other threads poll it or cancel the operation.
+     *
+     * Progress objects form a tree: a progress created on a thread while another progress is made current
+     * on that thread by make_current(pending_steps) becomes its child, the completion of the child counts
+     * as pending_steps of the parent. A caller can therefore observe and cancel library functions which
+     * create their own progress objects internally:
+     *
+     *   utils::progress job(1);
+     *   job.make_current(1);
+     *   bool ok = math::read(mesh, path); // job.fraction() and job.cancel() may be called from another thread
+     *   job.resign_current();
+     *
+     * Steps are counted with atomic operations so that workers of a parallel loop may report steps
+     * concurrently, they should report a batch of steps at once instead of single steps.
+     */
+    class OWL_API progress : non_copyable
+    {
+    public:
+      /**
+       * Create a progress of given number of steps, the progress becomes a child of the current progress
+       * of the calling thread.
+       */
+      explicit progress(std::uint64_t total_steps = 0);
+
+      /**
+       * Completes the pending steps of the parent.
+       */
+      ~progress();
+
+      /**
+       * Mark n steps as completed, may be called concurrently.
+       * @return false if the operation was cancelled and should be aborted
+       */
+      bool step(std::uint64_t n = 1);
+
+      /**
+       * @return number of steps of the operation
+       */
+      std::uint64_t total_steps() const;
+
+      /**
+       * @return number of completed steps including the completed part of the children
+       */
+      std::uint64_t completed_steps() const;
+
+      /**
+       * @return completed fraction of the operation in [0, 1]
+       */
+      double fraction() const;
+
+      /**
+       * Request the operation and all its children to abort, may be called from any thread.
+       */
+      void cancel();
+
+      /**
+       * @return true if this progress or one of its ancestors was cancelled
+       */
+      bool is_cancelled() const;
+
+      /**
+       * Make this the current progress of the calling thread, the next progress created on this thread
+       * becomes a child which accounts for pending_steps.
+       */
+      void make_current(std::uint64_t pending_steps);
+
+      /**
+       * Restore the previous current progress, the pending steps are completed even if no child was created.
+       */
+      void resign_current();
+
+      /**
+       * @return the current progress of the calling thread or nullptr
+       */
+      static progress* current();
+
+    private:
+      void advance(std::uint64_t n);
+
+      std::uint64_t steps_in_parent(std::uint64_t completed) const;
+
+      std::uint64_t total_steps_;
+      std::atomic<std::uint64_t> completed_steps_;
+      std::atomic<bool> cancelled_;
+      progress* parent_;
+      std::uint64_t steps_in_parent_;
+      progress* previous_current_;
+      std::uint64_t pending_steps_;
+    };
+  }
+}
@@ -0,0 +1,77 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "owl/utils/parallel.hpp"
+
+namespace owl
+{
+  namespace utils
+  {
+    //sorts keys and values by the keys with a stable least significant digit radix sort,
+    //each pass counts and scatters one byte of the keys in parallel blocks
+    template <typename Value>
+    void radix_sort(std::vector<std::uint32_t>& keys, std::vector<Value>& values)
+    {
+      constexpr std::size_t min_block_size = 1 << 16;
+      std::size_t n = keys.size();
+      std::size_t n_blocks = std::max<std::size_t>(1, std::min(num_threads(), n / min_block_size));
+      auto block_first = [&](std::size_t b) { return n * b / n_blocks; };
+
+      std::vector<std::uint32_t> keys_tmp(n);
+      std::vector<Value> values_tmp(n);
+      std::vector<std::array<std::size_t, 256>> offsets(n_blocks);
+      for(std::uint32_t shift = 0; shift < 32; shift += 8)
+      {
+        parallel_for(std::size_t(0), n_blocks, [&](std::size_t b)
+          {
+            offsets[b].fill(0);
+            for(std::size_t i = block_first(b); i < block_first(b + 1); ++i)
+              ++offsets[b][(keys[i] >> shift) & 0xff];
+          });
+
+        //skip passes in which all keys share the same digit
+        std::size_t offset = 0;
+        bool single_digit = false;
+        for(std::size_t digit = 0; digit < 256; ++digit)
+        {
+          std::size_t count = 0;
+          for(std::size_t b = 0; b < n_blocks; ++b)
+          {
+            std::size_t block_count = offsets[b][digit];
+            offsets[b][digit] = offset + count;
+            count += block_count;
+          }
+          single_digit |= count == n;
+          offset += count;
+        }
+        if(single_digit)
+          continue;
+
+        parallel_for(std::size_t(0), n_blocks, [&](std::size_t b)
+          {
+            auto& block_offsets = offsets[b];
+            for(std::size_t i = block_first(b); i < block_first(b + 1); ++i)
+            {
+              std::size_t j = block_offsets[(keys[i] >> shift) & 0xff]++;
+              keys_tmp[j] = keys[i];
+              values_tmp[j] = std::move(values[i]);
+            }
+          });
+        keys.swap(keys_tmp);
+        values.swap(values_tmp);
+      }
+    }
+  }
+}
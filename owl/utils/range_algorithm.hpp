@@ -11,7 +11,11 @@
 #include <iterator>
 #include <type_traits>
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include "owl/utils/execution.hpp"
 #include "owl/utils/iterator_range.hpp"
+#include "owl/utils/parallel.hpp"
 
 namespace owl
 {
@@ -86,5 +90,153 @@ namespace owl
     {
       return std::count_if(std::begin(rng), std::end(rng),std::forward<Pred>(cond));
     }
+
+    template<typename Range, typename Fn>
+    inline Fn for_each(Range&& rng, Fn fn)
+    {
+      return std::for_each(std::begin(rng), std::end(rng), std::move(fn));
+    }
+
+    //the sequenced_policy overloads call the sequential algorithms,
+    //the parallel_policy overloads split random access ranges into chunks processed on the task_scheduler
+    //and fall back to the sequential algorithms for all other ranges
+
+    template<typename Range>
+    struct is_random_access_range : std::is_base_of<std::random_access_iterator_tag,
+      typename std::iterator_traits<decltype(std::begin(std::declval<Range&>()))>::iterator_category>
+    {
+    };
+
+    template<typename Range, typename Fn>
+    inline void for_each(execution::sequenced_policy, Range&& rng, Fn&& fn)
+    {
+      std::for_each(std::begin(rng), std::end(rng), std::forward<Fn>(fn));
+    }
+
+    template<typename Range, typename Fn>
+    inline void for_each(execution::parallel_policy, Range&& rng, Fn&& fn)
+    {
+      if constexpr(is_random_access_range<Range>::value)
+        parallel_for(rng, fn);
+      else
+        std::for_each(std::begin(rng), std::end(rng), std::forward<Fn>(fn));
+    }
+
+    template<typename InputRange, typename OutIter, typename UnaryOperation>
+    inline auto transform(execution::sequenced_policy, const InputRange& rng, OutIter&& it, UnaryOperation&& op)
+    {
+      return std::transform(std::begin(rng), std::end(rng), std::forward<OutIter>(it), std::forward<UnaryOperation>(op));
+    }
+
+    template<typename InputRange, typename OutIter, typename UnaryOperation>
+    inline auto transform(execution::parallel_policy, const InputRange& rng, OutIter&& it, UnaryOperation&& op)
+    {
+      using out_category = typename std::iterator_traits<std::decay_t<OutIter>>::iterator_category;
+      if constexpr(is_random_access_range<const InputRange>::value
+        && std::is_base_of<std::random_access_iterator_tag, out_category>::value)
+      {
+        auto first = std::begin(rng);
+        auto n = std::distance(first, std::end(rng));
+        std::decay_t<OutIter> out = it;
+        parallel_for_blocks(rng, 1, [&](auto block)
+          {
+            std::transform(block.begin(), block.end(), out + (block.begin() - first), op);
+          });
+        return out + n;
+      }
+      else
+        return std::transform(std::begin(rng), std::end(rng), std::forward<OutIter>(it), std::forward<UnaryOperation>(op));
+    }
+
+    template<typename Range, class T>
+    inline void fill(execution::sequenced_policy, Range&& rng, const T& value)
+    {
+      std::fill(std::begin(rng), std::end(rng), value);
+    }
+
+    template<typename Range, class T>
+    inline void fill(execution::parallel_policy, Range&& rng, const T& value)
+    {
+      if constexpr(is_random_access_range<Range>::value)
+        parallel_for_blocks(rng, 1, [&value](auto block){ std::fill(block.begin(), block.end(), value); });
+      else
+        std::fill(std::begin(rng), std::end(rng), value);
+    }
+
+    template<typename Range, typename Pred>
+    inline auto find_if(execution::sequenced_policy, Range&& rng, Pred&& cond)
+    {
+      return std::find_if(std::begin(rng), std::end(rng), std::forward<Pred>(cond));
+    }
+
+    //returns the first element satisfying cond like the sequential find_if,
+    //chunks behind an already found element are skipped
+    template<typename Range, typename Pred>
+    inline auto find_if(execution::parallel_policy, Range&& rng, Pred&& cond)
+    {
+      if constexpr(is_random_access_range<Range>::value)
+      {
+        auto first = std::begin(rng);
+        auto n = static_cast<std::size_t>(std::distance(first, std::end(rng)));
+        std::atomic<std::size_t> found(n);
+        parallel_for_blocks(rng, 1, [&](auto block)
+          {
+            auto block_first = static_cast<std::size_t>(block.begin() - first);
+            if(block_first >= found)
+              return;
+            auto it = std::find_if(block.begin(), block.end(), cond);
+            if(it == block.end())
+              return;
+            std::size_t index = static_cast<std::size_t>(it - first);
+            std::size_t current = found;
+            while(index < current && !found.compare_exchange_weak(current, index))
+            {
+            }
+          });
+        return first + static_cast<decltype(std::distance(first, first))>(found.load());
+      }
+      else
+        return std::find_if(std::begin(rng), std::end(rng), std::forward<Pred>(cond));
+    }
+
+    template<typename Policy, typename Range, typename Pred,
+      typename = std::enable_if_t<execution::is_execution_policy<Policy>::value>>
+    inline bool all_of(Policy policy, const Range& rng, Pred&& cond)
+    {
+      return find_if(policy, rng, [&cond](auto&& x){ return !cond(x); }) == std::end(rng);
+    }
+
+    template<typename Policy, typename Range, typename Pred,
+      typename = std::enable_if_t<execution::is_execution_policy<Policy>::value>>
+    inline bool none_of(Policy policy, const Range& rng, Pred&& cond)
+    {
+      return find_if(policy, rng, std::forward<Pred>(cond)) == std::end(rng);
+    }
+
+    template<typename Policy, typename Range, typename Pred,
+      typename = std::enable_if_t<execution::is_execution_policy<Policy>::value>>
+    inline bool any_of(Policy policy, const Range& rng, Pred&& cond)
+    {
+      return find_if(policy, rng, std::forward<Pred>(cond)) != std::end(rng);
+    }
+
+    template<typename Range, typename Pred>
+    inline auto count_if(execution::sequenced_policy, const Range& rng, Pred&& cond)
+    {
+      return std::count_if(std::begin(rng), std::end(rng), std::forward<Pred>(cond));
+    }
+
+    template<typename Range, typename Pred>
+    inline auto count_if(execution::parallel_policy, const Range& rng, Pred&& cond)
+    {
+      if constexpr(is_random_access_range<const Range>::value)
+      {
+        using difference_type = typename std::iterator_traits<decltype(std::begin(rng))>::difference_type;
+        return parallel_reduce(rng, difference_type(0),
+          [&cond](auto&& x){ return cond(x) ? difference_type(1) : difference_type(0); }, std::plus<>());
+      }
+      else
+        return std::count_if(std::begin(rng), std::end(rng), std::forward<Pred>(cond));
+    }
   }
 }
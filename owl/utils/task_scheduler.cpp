@@ -0,0 +1,134 @@
+#include "owl/utils/task_scheduler.hpp"
+
+#include <algorithm>
+
+namespace owl
+{
+  namespace utils
+  {
+    namespace
+    {
+      //the scheduler and deque of the worker running on this thread
+      thread_local const task_scheduler* current_scheduler = nullptr;
+      thread_local std::size_t current_queue = 0;
+    }
+
+    task_scheduler::task_scheduler(std::size_t num_workers)
+      : num_queued_(0)
+      , stop_(false)
+    {
+      //the last deque is shared by all threads outside the pool
+      for(std::size_t i = 0; i <= num_workers; ++i)
+        queues_.push_back(std::make_unique<task_queue>());
+      workers_.reserve(num_workers);
+      for(std::size_t i = 0; i < num_workers; ++i)
+        workers_.emplace_back([this, i]{ work(i); });
+    }
+
+    task_scheduler::~task_scheduler()
+    {
+      {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stop_ = true;
+      }
+      wake_up_.notify_all();
+      for(auto& worker : workers_)
+        worker.join();
+    }
+
+    std::size_t task_scheduler::num_threads() const
+    {
+      return workers_.size() + 1;
+    }
+
+    void task_scheduler::submit(task t)
+    {
+      std::size_t queue = current_scheduler == this ? current_queue : workers_.size();
+      {
+        std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+        queues_[queue]->tasks.push_back(std::move(t));
+        ++num_queued_;
+      }
+      //taking the lock orders the increment before a worker checks num_queued_ and goes to sleep
+      {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+      }
+      wake_up_.notify_one();
+    }
+
+    bool task_scheduler::run_pending_task()
+    {
+      task t;
+      if(!find_task(current_scheduler == this ? current_queue : workers_.size(), t))
+        return false;
+      t();
+      return true;
+    }
+
+    task_scheduler& task_scheduler::instance()
+    {
+      static task_scheduler scheduler(std::max<std::size_t>(std::thread::hardware_concurrency(), 1) - 1);
+      return scheduler;
+    }
+
+    bool task_scheduler::pop(std::size_t queue, task& t)
+    {
+      auto& q = *queues_[queue];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      if(q.tasks.empty())
+        return false;
+      t = std::move(q.tasks.back());
+      q.tasks.pop_back();
+      --num_queued_;
+      return true;
+    }
+
+    bool task_scheduler::steal(std::size_t queue, task& t)
+    {
+      auto& q = *queues_[queue];
+      std::lock_guard<std::mutex> lock(q.mutex);
+      if(q.tasks.empty())
+        return false;
+      t = std::move(q.tasks.front());
+      q.tasks.pop_front();
+      --num_queued_;
+      return true;
+    }
+
+    bool task_scheduler::find_task(std::size_t queue, task& t)
+    {
+      if(num_queued_ == 0)
+        return false;
+      //the newest task of the own deque is still hot in cache, the oldest task of another deque
+      //is usually the largest piece of work left over there, the shared deque is processed in order
+      if(queue < workers_.size() ? pop(queue, t) : steal(queue, t))
+        return true;
+      for(std::size_t i = 1; i < queues_.size(); ++i)
+      {
+        if(steal((queue + i) % queues_.size(), t))
+          return true;
+      }
+      return false;
+    }
+
+    void task_scheduler::work(std::size_t queue)
+    {
+      current_scheduler = this;
+      current_queue = queue;
+      task t;
+      while(true)
+      {
+        if(find_task(queue, t))
+        {
+          t();
+          t = nullptr;
+          continue;
+        }
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        wake_up_.wait(lock, [this]{ return stop_ || num_queued_ > 0; });
+        if(stop_ && num_queued_ == 0)
+          return;
+      }
+    }
+  }
+}
@@ -0,0 +1,136 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "owl/export.hpp"
+#include "owl/utils/non_copyable.hpp"
+
+namespace owl
+{
+  namespace utils
+  {
+    /**
+     * A pool of worker threads with one task deque per worker.
+     * A worker pushes and pops tasks at the back of its own deque and steals from the front of the other deques
+     * when its own deque runs empty. Tasks submitted from threads outside the pool go to a shared deque.
+     */
+    class OWL_API task_scheduler : non_copyable
+    {
+    public:
+      using task = std::function<void()>;
+
+      /**
+       * Create a task_scheduler with given number of worker threads.
+       */
+      explicit task_scheduler(std::size_t num_workers);
+
+      /**
+       * Finish all queued tasks and join the worker threads.
+       */
+      ~task_scheduler();
+
+      /**
+       * @return number of threads executing tasks, the worker threads plus the thread waiting for the tasks
+       */
+      std::size_t num_threads() const;
+
+      /**
+       * Queue a task, the task is executed by one of the workers or by a thread calling run_pending_task().
+       */
+      void submit(task t);
+
+      /**
+       * Execute one queued task on the calling thread.
+       * @return false if no task was queued
+       */
+      bool run_pending_task();
+
+      /**
+       * @return the scheduler used by the parallel algorithms with one thread per hardware thread
+       */
+      static task_scheduler& instance();
+
+    private:
+      struct task_queue
+      {
+        std::mutex mutex;
+        std::deque<task> tasks;
+      };
+
+      bool pop(std::size_t queue, task& t);
+
+      bool steal(std::size_t queue, task& t);
+
+      bool find_task(std::size_t queue, task& t);
+
+      void work(std::size_t queue);
+
+      std::vector<std::unique_ptr<task_queue>> queues_;
+      std::vector<std::thread> workers_;
+      std::atomic<std::size_t> num_queued_;
+      std::mutex sleep_mutex_;
+      std::condition_variable wake_up_;
+      bool stop_;
+    };
+
+    /**
+     * A set of tasks submitted to a task_scheduler which can be waited for.
+     * The waiting thread executes queued tasks until all tasks of the group are finished,
+     * so tasks may run and wait for groups themselves.
+     */
+    class task_group : non_copyable
+    {
+    public:
+      explicit task_group(task_scheduler& scheduler = task_scheduler::instance())
+        : scheduler_(scheduler)
+        , pending_(0)
+      {
+      }
+
+      ~task_group()
+      {
+        wait();
+      }
+
+      template <typename Fn>
+      void run(Fn&& fn)
+      {
+        ++pending_;
+        scheduler_.submit([this, fn = std::forward<Fn>(fn)]() mutable
+          {
+            fn();
+            --pending_;
+          });
+      }
+
+      void wait()
+      {
+        while(pending_ > 0)
+        {
+          if(!scheduler_.run_pending_task())
+            std::this_thread::yield();
+        }
+      }
+
+    private:
+      task_scheduler& scheduler_;
+      std::atomic<std::size_t> pending_;
+    };
+  }
+}
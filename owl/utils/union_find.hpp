@@ -0,0 +1,83 @@
+//
+//           .___.
+//           {o,o}
+//          ./)_)
+//      owl --"-"---
+//
+//  Copyright © 2018 Sören König. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace owl
+{
+  namespace utils
+  {
+    //disjoint sets of the elements [0, n) which can be united and searched concurrently without locks.
+    //a root is always linked below a root of smaller index, so the root of each set is its smallest element
+    //and the result does not depend on the order of the unions. find compresses the paths by halving
+    class concurrent_union_find
+    {
+    public:
+      explicit concurrent_union_find(std::size_t n = 0)
+        : parents_(std::make_unique<std::atomic<std::size_t>[]>(n))
+        , size_(n)
+      {
+        for(std::size_t i = 0; i < n; ++i)
+          parents_[i].store(i, std::memory_order_relaxed);
+      }
+
+      std::size_t size() const
+      {
+        return size_;
+      }
+
+      //returns the smallest element of the set containing x
+      std::size_t find(std::size_t x)
+      {
+        //parents only decrease and no other data is published through them, relaxed ordering suffices
+        std::size_t parent = parents_[x].load(std::memory_order_relaxed);
+        while(parent != x)
+        {
+          std::size_t grandparent = parents_[parent].load(std::memory_order_relaxed);
+          if(grandparent != parent)
+            parents_[x].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+          x = grandparent;
+          parent = parents_[x].load(std::memory_order_relaxed);
+        }
+        return x;
+      }
+
+      //merges the sets containing a and b, returns false if they are already the same set
+      bool unite(std::size_t a, std::size_t b)
+      {
+        while(true)
+        {
+          a = find(a);
+          b = find(b);
+          if(a == b)
+            return false;
+          if(a < b)
+            std::swap(a, b);
+          std::size_t expected = a;
+          if(parents_[a].compare_exchange_weak(expected, b, std::memory_order_relaxed))
+            return true;
+        }
+      }
+
+      bool same(std::size_t a, std::size_t b)
+      {
+        return find(a) == find(b);
+      }
+
+    private:
+      std::unique_ptr<std::atomic<std::size_t>[]> parents_;
+      std::size_t size_;
+    };
+  }
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <random>
+#include "owl/math/bvh.hpp"
+#include "owl/math/mesh_primitives.hpp"
+#include "owl/math/approx.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  namespace
+  {
+    //closest hit by testing all faces
+    owl::math::ray_hit<float> brute_force(const owl::math::mesh<float>& m, const owl::math::ray3f& r)
+    {
+      using namespace owl::math;
+      ray_hit<float> h;
+      for(auto f : m.faces())
+      {
+        auto he0 = m.inner(f);
+        auto he = m.next(he0);
+        for(auto he_next = m.next(he); he_next != he0; he = he_next, he_next = m.next(he_next))
+        {
+          float t, u, v;
+          if(intersect(r, m.position(m.target(he0)), m.position(m.target(he)), m.position(m.target(he_next)),
+            0.0f, h.t, t, u, v))
+          {
+            h.face = f;
+            h.t = t;
+          }
+        }
+      }
+      return h;
+    }
+  }
+
+  TEST_CASE( "bvh", "[math]" )
+  {
+    using namespace owl::math;
+    auto sphere = create_geodesic_sphere<float>(1, 3);
+    bvh<float> tree(sphere);
+    CHECK(tree.num_triangles() == sphere.num_faces());
+    CHECK(approx(tree.bounds().lower_bound).margin(0.0001) == vector3f(-1, -1, -1));
+    CHECK(approx(tree.bounds().upper_bound).margin(0.0001) == vector3f(1, 1, 1));
+    for(const auto& nd : tree.nodes())
+      if(nd.is_leaf())
+        CHECK(nd.count <= 8);
+
+    ray3f inside(vector3f(0, 0, 0), vector3f(0, 0, 1));
+    auto h = tree.intersect(inside);
+    REQUIRE(h.is_valid());
+    CHECK(h.t == approx(1.0f).margin(0.01));
+    CHECK(tree.intersect_any(inside));
+    CHECK_FALSE(tree.intersect(inside, 0, 0.5f).is_valid());
+    CHECK_FALSE(tree.intersect_any(inside, 0, 0.5f));
+    CHECK_FALSE(tree.intersect(ray3f(vector3f(0, 2, 0), vector3f(1, 0, 0))).is_valid());
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-2, 2);
+    std::vector<ray3f> rays;
+    for(std::size_t i = 0; i < 1000; ++i)
+      rays.emplace_back(vector3f(dist(rng), dist(rng), dist(rng)), vector3f(dist(rng), dist(rng), dist(rng)));
+
+    auto hits = tree.intersect(rays);
+    auto any_hits = tree.intersect_any(rays);
+    for(std::size_t i = 0; i < rays.size(); ++i)
+    {
+      auto expected = brute_force(sphere, rays[i]);
+      CHECK(hits[i].is_valid() == expected.is_valid());
+      CHECK(bool(any_hits[i]) == expected.is_valid());
+      if(expected.is_valid())
+      {
+        CHECK(hits[i].t == approx(expected.t));
+        auto p = rays[i](hits[i].t);
+        CHECK(p.length() == approx(1.0f).margin(0.01));
+      }
+    }
+
+    bvh<float> fine(sphere, 1);
+    CHECK(fine.nodes().size() == 2 * sphere.num_faces() - 1);
+    for(std::size_t i = 0; i < rays.size(); ++i)
+      CHECK(fine.intersect(rays[i]).t == approx(hits[i].t));
+  }
+
+  TEST_CASE( "bvh builders", "[math]" )
+  {
+    using namespace owl::math;
+    auto sphere = create_geodesic_sphere<float>(1, 3);
+    auto torus = create_torus<float>(0.5f, 2, 24, 48);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-3, 3);
+    std::vector<ray3f> rays;
+    for(std::size_t i = 0; i < 500; ++i)
+      rays.emplace_back(vector3f(dist(rng), dist(rng), dist(rng)), vector3f(dist(rng), dist(rng), dist(rng)));
+
+    for(auto* m : {&sphere, &torus})
+    {
+      bvh<float> lbvh(*m, 8, bvh_builder::lbvh);
+      bvh<float> refined(*m, 8, bvh_builder::lbvh_sah);
+      CHECK(lbvh.num_triangles() == refined.num_triangles());
+      CHECK(refined.sah_cost() < lbvh.sah_cost());
+      CHECK(approx(lbvh.bounds().lower_bound) == bvh<float>(*m).bounds().lower_bound);
+      for(const auto& r : rays)
+      {
+        auto expected = brute_force(*m, r);
+        for(auto* tree : {&lbvh, &refined})
+        {
+          auto h = tree->intersect(r);
+          CHECK(h.is_valid() == expected.is_valid());
+          if(expected.is_valid())
+            CHECK(h.t == approx(expected.t));
+        }
+      }
+    }
+
+    bvh<float> single(create_geodesic_sphere<float>(1, 0), 8, bvh_builder::lbvh_sah);
+    CHECK(single.num_triangles() == 20);
+    CHECK(single.intersect(ray3f(vector3f(0, 0, 0), vector3f(1, 0, 0))).is_valid());
+  }
+
+  TEST_CASE( "bvh ray packets", "[math]" )
+  {
+    using namespace owl::math;
+    auto sphere = create_geodesic_sphere<float>(1, 3);
+
+    //camera rays through a 64 x 64 image plane, all builders and single rays agree on the number of hits
+    std::size_t res = 64;
+    std::vector<ray3f> rays;
+    rays.reserve(res * res);
+    for(std::size_t y = 0; y < res; ++y)
+      for(std::size_t x = 0; x < res; ++x)
+        rays.emplace_back(vector3f(0, 0, -3), vector3f((x + 0.5f) / res - 0.5f, (y + 0.5f) / res - 0.5f, 1));
+
+    std::size_t expected_hits = 0;
+    for(auto builder : {bvh_builder::sah, bvh_builder::lbvh, bvh_builder::lbvh_sah})
+    {
+      bvh<float> tree(sphere, 8, builder);
+      std::size_t num_hits = 0;
+      for(const auto& r : rays)
+        num_hits += tree.intersect(r).is_valid();
+      auto hits = tree.intersect(rays);
+      CHECK(std::count_if(hits.begin(), hits.end(), [](const auto& h) { return h.is_valid(); }) == num_hits);
+      if(expected_hits == 0)
+        expected_hits = num_hits;
+      CHECK(num_hits == expected_hits);
+    }
+    CHECK(expected_hits > 0);
+    CHECK(expected_hits < rays.size());
+  }
+}
@@ -6,6 +6,9 @@
 #include "owl/math/approx.hpp"
 #include "owl/utils/stop_watch.hpp"
 #include "catch/catch.hpp"
+#include <fstream>
+#include <map>
+#include <cstdio>
 
 
 namespace test
@@ -60,6 +63,749 @@ namespace test
     CHECK(m.check() == 0);
   }
 
+  TEST_CASE( "read binary ply", "[math]" )
+  {
+    using namespace owl::math;
+    const std::string path = "binary_tetrahedron.ply";
+    {
+      std::ofstream out(path, std::ios::binary);
+      out << "ply\nformat binary_little_endian 1.0\n"
+          << "element vertex 4\nproperty float x\nproperty float y\nproperty float z\nproperty uchar red\n"
+          << "element face 4\nproperty list uchar int vertex_indices\nend_header\n";
+      const float positions[4][3] = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+      for(auto& p : positions)
+      {
+        out.write(reinterpret_cast<const char*>(p), sizeof(p));
+        out.put(char(255));
+      }
+      const std::int32_t faces[4][3] = {{0, 2, 1}, {0, 1, 3}, {1, 2, 3}, {0, 3, 2}};
+      for(auto& f : faces)
+      {
+        out.put(char(3));
+        out.write(reinterpret_cast<const char*>(f), sizeof(f));
+      }
+    }
+
+    mesh<float> m;
+    CHECK(read_ply(m, path));
+    CHECK(m.num_vertices() == 4);
+    CHECK(m.num_faces() == 4);
+    CHECK(is_closed(m));
+    CHECK(m.position(vertex_handle(3)) == vector<float,3>(0, 0, 1));
+    CHECK(m.check() == 0);
+    std::remove(path.c_str());
+  }
+
+  TEST_CASE( "read ascii off", "[math]" )
+  {
+    using namespace owl::math;
+    const std::string path = "ascii_cube.off";
+    REQUIRE(owl::io::create_off_cube(path));
+
+    mesh<float> m;
+    CHECK(read_off(m, path));
+    CHECK(m.num_vertices() == 8);
+    CHECK(m.num_faces() == 6);
+    CHECK(m.is_quad_mesh());
+    CHECK(is_closed(m));
+    CHECK(m.position(vertex_handle(7)) == vector<float,3>(0.5f, -0.5f, -0.5f));
+    CHECK(m.check() == 0);
+    std::remove(path.c_str());
+  }
+
+  TEST_CASE( "read ascii ply", "[math]" )
+  {
+    using namespace owl::math;
+    const std::string path = "ascii_tetrahedron.ply";
+    {
+      std::ofstream out(path, std::ios::binary);
+      out << "ply\r\nformat ascii 1.0\r\n"
+          << "element vertex 4\r\nproperty uchar red\r\nproperty float x\r\nproperty float y\r\nproperty float z\r\n"
+          << "element face 4\r\nproperty list uchar int vertex_indices\r\nend_header\r\n"
+          << "255 0 0 0\r\n255 1 0 0\r\n\r\n255 0 1 0\r\n255 0 0 +1e0\r\n"
+          << "3 0 2 1\r\n3 0 1 3\r\n3 1 2 3\r\n3 0 3 2";
+    }
+
+    mesh<float> m;
+    CHECK(read_ply(m, path));
+    CHECK(m.num_vertices() == 4);
+    CHECK(m.num_faces() == 4);
+    CHECK(is_closed(m));
+    CHECK(m.position(vertex_handle(3)) == vector<float,3>(0, 0, 1));
+    CHECK(m.check() == 0);
+    std::remove(path.c_str());
+  }
+
+  TEST_CASE( "read binary stl", "[math]" )
+  {
+    using namespace owl::math;
+    const std::string path = "binary_tetrahedron.stl";
+    const float positions[4][3] = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    const int faces[4][3] = {{0, 2, 1}, {0, 1, 3}, {1, 2, 3}, {0, 3, 2}};
+    const float normals[4][3] = {{0, 0, -1}, {0, -1, 0}, {0, 0, 0}, {-1, 0, 0}};
+    {
+      //the header starts like an ascii file
+      std::ofstream out(path, std::ios::binary);
+      std::string header = "solid tetrahedron";
+      header.resize(80, ' ');
+      out << header;
+      const std::uint32_t n = 4;
+      out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+      for(std::size_t f = 0; f < 4; ++f)
+      {
+        out.write(reinterpret_cast<const char*>(normals[f]), sizeof(normals[f]));
+        for(auto v : faces[f])
+          out.write(reinterpret_cast<const char*>(positions[v]), sizeof(positions[v]));
+        out.put(0).put(0);
+      }
+    }
+
+    mesh<float> m;
+    CHECK(read_stl(m, path));
+    CHECK(m.num_vertices() == 4);
+    CHECK(m.num_faces() == 4);
+    CHECK(is_closed(m));
+    CHECK(m.check() == 0);
+    CHECK(m.normal(face_handle(0)) == vector<float,3>(0, 0, -1));
+    CHECK(m.normal(face_handle(2)).length() == Approx(1));
+    CHECK(m.normal(face_handle(2))[0] > 0);
+
+    //trailing bytes behind the records are ignored if the header does not start like an ascii file
+    {
+      std::ofstream out(path, std::ios::binary | std::ios::app);
+      out << "trailing";
+    }
+    CHECK_FALSE(read_stl(m, path));
+    {
+      std::fstream out(path, std::ios::binary | std::ios::in | std::ios::out);
+      out << "binary";
+    }
+    CHECK(read_stl(m, path));
+    CHECK(m.num_faces() == 4);
+    CHECK(m.check() == 0);
+    std::remove(path.c_str());
+  }
+
+  TEST_CASE( "read ascii stl", "[math]" )
+  {
+    using namespace owl::math;
+    const std::string path = "ascii_tetrahedron.stl";
+    {
+      std::ofstream out(path, std::ios::binary);
+      out << "solid tetrahedron\r\n"
+          << "facet normal 0 0 -1\r\n outer loop\r\n  vertex 0 0 0\r\n  vertex 0 1 0\r\n  vertex 1 0 0\r\n"
+          << " endloop\r\nendfacet\r\n"
+          << "facet normal 0 -1 0\nouter loop\nvertex 0 0 0\nvertex 1 0 0\nvertex 0 0 1\nendloop\nendfacet\n"
+          << "\tfacet normal 0 0 0\n\touter loop\n\t\tvertex 1 0 0\n\t\tvertex 0 1 0\n\t\tvertex 0 0 +1e0\n"
+          << "\tendloop\n\tendfacet\n"
+          << "endsolid tetrahedron\nsolid\n"
+          << "facet normal -1 0 0 outer loop vertex 0 0 0 vertex 0 0 1\nvertex\n0 1 0 endloop endfacet\n"
+          << "endsolid tetrahedron\n";
+    }
+
+    mesh<float> m;
+    CHECK(read(m, path));
+    CHECK(m.num_vertices() == 4);
+    CHECK(m.num_faces() == 4);
+    CHECK(is_closed(m));
+    CHECK(m.check() == 0);
+    CHECK(m.position(vertex_handle(1)) == vector<float,3>(0, 1, 0));
+    CHECK(m.normal(face_handle(3)) == vector<float,3>(-1, 0, 0));
+    std::remove(path.c_str());
+  }
+
+  TEST_CASE( "read obj", "[math]" )
+  {
+    using namespace owl::math;
+    const std::string path = "textured_tetrahedron.obj";
+    {
+      std::ofstream out(path, std::ios::binary);
+      out << "# tetrahedron\nmtllib tetrahedron.mtl\no tetrahedron\n"
+          << "v 0 0 0\nv 1 0 0\r\nv 0 1 0 1.0\n\tv  0 0 +1e0\n"
+          << "vt 0 0\nvt 1 0\nvt 0.5\nvn 0 0 -1\nvn 0.5 0.5 0.5\n"
+          << "usemtl red\ns off\n"
+          << "f 1/1/1 3/2/1 2/3/1\nf 1 2 4\n"
+          << "g top\nf 2//2 3//2 4//2\nf -4/-3 -1/-2 -2/-1\n";
+    }
+
+    mesh<float> m;
+    CHECK(read(m, path));
+    CHECK(m.num_vertices() == 4);
+    CHECK(m.num_faces() == 4);
+    CHECK(is_closed(m));
+    CHECK(m.check() == 0);
+    CHECK(m.position(vertex_handle(3)) == vector<float,3>(0, 0, 1));
+
+    auto texcoords_of = [&](face_handle f)
+    {
+      std::map<std::size_t, vector<float,2>> texcoords;
+      for(auto he : m.inner_halfedges(f))
+        texcoords[m.target(he).index()] = m.texcoord(he);
+      return texcoords;
+    };
+    auto t0 = texcoords_of(face_handle(0));
+    CHECK(t0[0] == vector<float,2>(0, 0));
+    CHECK(t0[2] == vector<float,2>(1, 0));
+    CHECK(t0[1] == vector<float,2>(0.5f, 0));
+    auto t3 = texcoords_of(face_handle(3));
+    CHECK(t3[0] == vector<float,2>(0, 0));
+    CHECK(t3[3] == vector<float,2>(1, 0));
+    CHECK(t3[2] == vector<float,2>(0.5f, 0));
+    for(auto he : m.inner_halfedges(face_handle(0)))
+      CHECK(m.normal(he) == vector<float,3>(0, 0, -1));
+    for(auto he : m.inner_halfedges(face_handle(2)))
+      CHECK(m.normal(he) == vector<float,3>(0.5f, 0.5f, 0.5f));
+
+    //indices out of range
+    {
+      std::ofstream out(path, std::ios::binary);
+      out << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n";
+    }
+    CHECK_FALSE(read(m, path));
+    std::remove(path.c_str());
+  }
+
+  TEST_CASE( "write mesh", "[math]" )
+  {
+    using namespace owl::math;
+    auto sphere = create_geodesic_sphere<float>(1, 2);
+    for(auto f : sphere.faces())
+      sphere.color(f) = owl::color::rgba8u(static_cast<std::uint8_t>(f.index() % 256), 2, 3, 4);
+    for(auto he : sphere.halfedges())
+    {
+      auto i = static_cast<float>(he.index());
+      sphere.texcoord(he) = vector2f(i, 0.5f * i);
+      sphere.normal(he) = vector3f(i, 1, -i);
+    }
+
+    mesh_write_options ascii;
+    ascii.binary = false;
+    mesh_write_options attributes;
+    attributes.halfedge_texcoords = true;
+    attributes.halfedge_normals = true;
+    attributes.face_colors = true;
+    mesh_write_options ascii_attributes = attributes;
+    ascii_attributes.binary = false;
+
+    for(auto [path, options] : {std::make_pair("write.ply", mesh_write_options{}), std::make_pair("write_ascii.ply", ascii),
+      std::make_pair("write_attributes.ply", attributes), std::make_pair("write_attributes_ascii.ply", ascii_attributes),
+      std::make_pair("write.off", ascii)})
+    {
+      CHECK(write(sphere, path, options));
+      mesh<float> m;
+      CHECK(read(m, path));
+      CHECK(m.num_vertices() == sphere.num_vertices());
+      CHECK(m.num_faces() == sphere.num_faces());
+      CHECK(m.check() == 0);
+      for(auto v : m.vertices())
+        CHECK(m.position(v) == sphere.position(v));
+      if(!options.halfedge_texcoords)
+      {
+        std::remove(path);
+        continue;
+      }
+
+      //the mesh reader ignores the face lists, they are checked with listeners on the ply reader
+      std::vector<float> texcoords, normals;
+      std::vector<owl::color::rgba8u> colors;
+      owl::color::rgba8u col;
+      owl::io::ply_reader ply(path);
+      REQUIRE(ply.is_open());
+      ply.listen_2_element_property<float>("face", "texcoord",
+        [&](const std::vector<float>& t){ texcoords.insert(texcoords.end(), t.begin(), t.end()); });
+      ply.listen_2_element_property<float>("face", "normal",
+        [&](const std::vector<float>& n){ normals.insert(normals.end(), n.begin(), n.end()); });
+      ply.listen_2_element_property<std::uint8_t>("face", "red", [&](const std::uint8_t& r){ col.r() = r; });
+      ply.listen_2_element_property<std::uint8_t>("face", "green", [&](const std::uint8_t& g){ col.g() = g; });
+      ply.listen_2_element_property<std::uint8_t>("face", "blue", [&](const std::uint8_t& b){ col.b() = b; });
+      ply.listen_2_element_property<std::uint8_t>("face", "alpha", [&](const std::uint8_t& a){ col.a() = a; });
+      ply.listen_2_element_item_end("face", [&](std::size_t){ colors.push_back(col); });
+      CHECK(ply.read());
+      ply.close();
+
+      std::vector<float> expected_texcoords, expected_normals;
+      for(auto f : sphere.faces())
+      {
+        for(auto he : sphere.inner_halfedges(f))
+        {
+          auto t = sphere.texcoord(he);
+          auto n = sphere.normal(he);
+          expected_texcoords.insert(expected_texcoords.end(), {t.x(), t.y()});
+          expected_normals.insert(expected_normals.end(), {n.x(), n.y(), n.z()});
+        }
+      }
+      CHECK(texcoords == expected_texcoords);
+      CHECK(normals == expected_normals);
+      REQUIRE(colors.size() == sphere.num_faces());
+      for(auto f : sphere.faces())
+        CHECK(colors[f.index()] == sphere.color(f));
+      std::remove(path);
+    }
+
+    //removed elements are skipped and the remaining vertices renumbered
+    mesh<float> pair;
+    auto verts = pair.add_vertices(6);
+    for(auto v : verts)
+      pair.position(v) = vector3f(static_cast<float>(v.index()), static_cast<float>(v.index() % 2), 0);
+    auto removed = pair.add_face(verts[0], verts[1], verts[2]);
+    pair.add_face(verts[3], verts[4], verts[5]);
+    pair.status(removed).remove();
+    for(auto he : pair.inner_halfedges(removed))
+      pair.status(pair.edge(he)).remove();
+    for(auto v : {verts[0], verts[1], verts[2]})
+      pair.status(v).remove();
+    for(auto [path, options] : {std::make_pair("write_removed.ply", mesh_write_options{}),
+      std::make_pair("write_removed_ascii.ply", ascii), std::make_pair("write_removed.off", ascii)})
+    {
+      CHECK(write(pair, path, options));
+      mesh<float> m;
+      CHECK(read(m, path));
+      CHECK(m.num_vertices() == 3);
+      CHECK(m.num_faces() == 1);
+      CHECK(m.check() == 0);
+      for(auto v : m.vertices())
+        CHECK(m.position(v) == pair.position(verts[v.index() + 3]));
+      std::remove(path);
+    }
+
+    //attributes the mesh does not have can not be written
+    halfedge_property_handle<vector2f> texcoords;
+    REQUIRE(sphere.get_property(texcoords, "halfedge_texcoord"));
+    sphere.remove_property(texcoords);
+    CHECK_FALSE(write(sphere, "write_missing.ply", attributes));
+    attributes.halfedge_texcoords = false;
+    CHECK(write(sphere, "write_missing.ply", attributes));
+    std::remove("write_missing.ply");
+  }
+
+  TEST_CASE( "write stl", "[math]" )
+  {
+    using namespace owl::math;
+    auto box = create_box<float>();
+    box.update_normals();
+    mesh_write_options ascii;
+    ascii.binary = false;
+
+    for(auto [path, options] : {std::make_pair("write.stl", mesh_write_options{}), std::make_pair("write_ascii.stl", ascii)})
+    {
+      CHECK(write(box, path, options));
+      mesh<float> m;
+      CHECK(read(m, path));
+      CHECK(m.num_vertices() == box.num_vertices());
+      CHECK(m.num_faces() == 2 * box.num_faces());
+      CHECK(is_closed(m));
+      CHECK(m.check() == 0);
+      for(auto f : m.faces())
+        CHECK(m.normal(f) == m.compute_face_normal(f));
+      std::remove(path);
+    }
+  }
+
+  TEST_CASE( "cancel mesh operations", "[math]" )
+  {
+    using namespace owl::math;
+    auto sphere = create_geodesic_sphere<float>(1, 4);
+    mesh_write_options ascii;
+    ascii.binary = false;
+
+    for(auto [path, options] : {std::make_pair("cancel.ply", mesh_write_options{}), std::make_pair("cancel_ascii.ply", ascii),
+      std::make_pair("cancel.off", ascii), std::make_pair("cancel.stl", mesh_write_options{})})
+    {
+      CHECK(write(sphere, path, options));
+      owl::utils::progress job(1);
+      job.make_current(1);
+      mesh<float> m;
+      CHECK(read(m, path));
+      job.resign_current();
+      CHECK(job.fraction() == 1);
+      CHECK(m.num_faces() == sphere.num_faces());
+
+      owl::utils::progress cancelled_job(1);
+      cancelled_job.cancel();
+      cancelled_job.make_current(1);
+      CHECK_FALSE(read(m, path));
+      cancelled_job.resign_current();
+      CHECK(m.num_vertices() == 0);
+      std::remove(path);
+    }
+
+    auto m = create_box<float>();
+    {
+      owl::utils::progress job(1);
+      job.cancel();
+      job.make_current(1);
+      CHECK_FALSE(triangulate_monoton(m));
+      job.resign_current();
+      CHECK(m.num_faces() == 6);
+      CHECK_FALSE(m.is_triangle_mesh());
+    }
+    {
+      owl::utils::progress job(1);
+      job.make_current(1);
+      CHECK(triangulate_monoton(m));
+      job.resign_current();
+      CHECK(job.fraction() == 1);
+    }
+    CHECK(m.is_triangle_mesh());
+
+    std::size_t n = m.num_faces();
+    {
+      owl::utils::progress job(1);
+      job.cancel();
+      job.make_current(1);
+      CHECK_FALSE(m.subdivide_triangle_split());
+      job.resign_current();
+    }
+    CHECK(m.check() == 0);
+    auto copy = create_box<float>();
+    triangulate_monoton(copy);
+    CHECK(copy.subdivide_triangle_split());
+    CHECK(copy.num_faces() == 4 * n);
+  }
+
+  TEST_CASE( "build", "[math]" )
+  {
+    using namespace owl::math;
+    auto sphere = create_geodesic_sphere<float>(2, 2);
+
+    std::vector<vector<float,3>> positions;
+    for(auto v : sphere.vertices())
+      positions.push_back(sphere.position(v));
+    std::vector<std::size_t> face_offsets(1, 0);
+    std::vector<std::size_t> face_indices;
+    for(auto f : sphere.faces())
+    {
+      for(auto v : sphere.vertices(f))
+        face_indices.push_back(v.index());
+      face_offsets.push_back(face_indices.size());
+    }
+
+    mesh<float> m;
+    CHECK(m.build(positions, face_offsets, face_indices));
+    CHECK(m.num_vertices() == sphere.num_vertices());
+    CHECK(m.num_edges() == sphere.num_edges());
+    CHECK(m.num_faces() == sphere.num_faces());
+    CHECK(is_closed(m));
+    CHECK(m.check() == 0);
+    for(auto f : m.faces())
+    {
+      auto expected = sphere.vertices(f);
+      auto actual = m.vertices(f);
+      CHECK(std::equal(actual.begin(), actual.end(), expected.begin(), expected.end()));
+    }
+
+    //open strip of two quads
+    std::vector<vector<float,3>> strip(6);
+    CHECK(m.build(strip, std::vector<std::size_t>{0, 4, 8}, std::vector<std::size_t>{0, 1, 4, 3, 1, 2, 5, 4}));
+    CHECK(m.num_edges() == 7);
+    CHECK(m.is_boundary(vertex_handle(1)));
+    CHECK(m.check() == 0);
+
+    //three faces sharing one edge
+    CHECK_FALSE(m.build(strip, std::vector<std::size_t>{0, 3, 6, 9}, std::vector<std::size_t>{0, 1, 2, 1, 0, 3, 0, 1, 4}));
+    CHECK(m.num_faces() == 0);
+    CHECK(m.num_vertices() == 6);
+  }
+
+  TEST_CASE( "status flags", "[math]" )
+  {
+    using namespace owl::math;
+    CHECK(sizeof(status_flags) == 1);
+
+    auto box = create_box<float>();
+    auto e = edge_handle(3);
+    box.select(e);
+    CHECK(box.is_selected(e));
+    CHECK_FALSE(box.is_selected(edge_handle(2)));
+    box.invert_selection(e);
+    CHECK_FALSE(box.is_selected(e));
+    box.status(e).remove();
+    CHECK(box.status(e).is_removed());
+    CHECK_FALSE(box.status(e).is_selected());
+  }
+
+  TEST_CASE( "garbage collection", "[math]" )
+  {
+    using namespace owl::math;
+    mesh<float> m;
+    m.store_prev(true);
+    auto verts = m.add_vertices(7);
+    for(auto v : verts)
+      m.position(v) = vector3f(static_cast<float>(v.index()), 0, 0);
+    auto f0 = m.add_face(verts[0], verts[1], verts[2]);
+    auto f1 = m.add_face(verts[3], verts[4], verts[5]);
+    m.color(f1) = mesh<float>::color_t(255, 0, 0, 255);
+    for(auto he : m.inner_halfedges(f1))
+      m.texcoord(he) = vector2f(static_cast<float>(he.index()), 1);
+    auto old_halfedges = std::vector<halfedge_handle>(m.inner_halfedges(f1).begin(), m.inner_halfedges(f1).end());
+
+    m.status(f0).remove();
+    for(auto he : m.inner_halfedges(f0))
+      m.status(m.edge(he)).remove();
+    for(auto v : {verts[0], verts[1], verts[2]})
+      m.status(v).remove();
+    m.remove_isolated_vertices();
+
+    mesh<float>::handle_remap remap;
+    m.garbage_collection(remap);
+    CHECK(m.num_vertices() == 3);
+    CHECK(m.num_edges() == 3);
+    CHECK(m.num_halfedges() == 6);
+    CHECK(m.num_faces() == 1);
+    CHECK(m.check() == 0);
+    CHECK_FALSE(remap.vertices[0].is_valid());
+    CHECK_FALSE(remap.vertices[6].is_valid());
+    CHECK(remap.vertices[4] == vertex_handle(1));
+    CHECK_FALSE(remap.faces[0].is_valid());
+    CHECK(remap.faces[1] == face_handle(0));
+    CHECK(m.position(vertex_handle(1)) == vector3f(4, 0, 0));
+    CHECK(m.color(face_handle(0)) == mesh<float>::color_t(255, 0, 0, 255));
+    for(auto he : old_halfedges)
+    {
+      CHECK(remap.halfedges[he.index()].is_valid());
+      CHECK(m.texcoord(remap.halfedges[he.index()]) == vector2f(static_cast<float>(he.index()), 1));
+    }
+
+    auto sphere = create_geodesic_sphere<float>(1, 2);
+    auto collected = sphere;
+    collected.garbage_collection();
+    CHECK(collected.num_halfedges() == sphere.num_halfedges());
+    CHECK(collected.check() == 0);
+
+    //removing a face opens a hole, its vertices start at a boundary halfedge afterwards
+    std::vector<vertex_handle> hole(sphere.vertices(face_handle(7)).begin(), sphere.vertices(face_handle(7)).end());
+    sphere.status(face_handle(7)).remove();
+    sphere.garbage_collection(remap);
+    CHECK(sphere.num_faces() == collected.num_faces() - 1);
+    CHECK(sphere.check() == 0);
+    for(auto v : hole)
+      CHECK(sphere.is_boundary(remap.vertices[v.index()]));
+    CHECK_FALSE(is_closed(sphere));
+  }
+
+  TEST_CASE( "shells", "[math]" )
+  {
+    using namespace owl::math;
+    //a box, a tetrahedron and a second box in one mesh with an isolated vertex in between
+    mesh<float> m;
+    for(auto part : {create_box<float>(), create_tetradedron<float>(), create_box<float>()})
+    {
+      auto offset = m.num_vertices();
+      for(auto v : part.vertices())
+        m.add_vertex(part.position(v) + vector3f(static_cast<float>(offset), 0, 0));
+      for(auto f : part.faces())
+      {
+        std::vector<vertex_handle> vertices;
+        for(auto v : part.vertices(f))
+          vertices.emplace_back(v.index() + offset);
+        auto g = m.add_face(vertices);
+        m.color(g) = mesh<float>::color_t(static_cast<std::uint8_t>(offset), 0, 0, 255);
+      }
+      if(offset == 0)
+        m.add_vertex(vector3f(-1, -1, -1));
+    }
+    CHECK(num_shells(m) == 3);
+
+    face_property_handle<std::size_t> shell_ids;
+    CHECK(label_shells(m, shell_ids) == 3);
+    for(auto f : m.faces())
+      CHECK(m.property(shell_ids, f) == (f.index() < 6 ? 0 : f.index() < 10 ? 1 : 2));
+    m.remove_property(shell_ids);
+
+    auto shells = split_shells(m);
+    REQUIRE(shells.size() == 3);
+    std::size_t expected_faces[] = {6, 4, 6};
+    std::size_t offsets[] = {0, 9, 13};
+    for(std::size_t i = 0; i < 3; ++i)
+    {
+      auto& shell = shells[i];
+      CHECK(shell.check() == 0);
+      CHECK(shell.num_faces() == expected_faces[i]);
+      CHECK(is_closed(shell));
+      CHECK(num_shells(shell) == 1);
+      for(auto f : shell.faces())
+        CHECK(shell.color(f) == mesh<float>::color_t(static_cast<std::uint8_t>(offsets[i]), 0, 0, 255));
+      CHECK(shell.bounds().lower_bound.x() == Approx(m.bounds().lower_bound.x() + 1 + offsets[i]));
+    }
+
+    //two triangles touching at a vertex are two shells, each part gets its own copy of the shared vertex
+    mesh<float> bowtie;
+    auto v = bowtie.add_vertices(std::vector<vector3f>{vector3f(0, 0, 0), vector3f(1, 0, 0), vector3f(1, 1, 0),
+      vector3f(-1, 0, 0), vector3f(-1, -1, 0)});
+    bowtie.add_face(v[0], v[1], v[2]);
+    bowtie.add_face(v[0], v[3], v[4]);
+    REQUIRE(bowtie.check() == 0);
+    CHECK(num_shells(bowtie) == 2);
+    auto touching = split_shells(bowtie);
+    REQUIRE(touching.size() == 2);
+    for(auto& part : touching)
+    {
+      CHECK(part.check() == 0);
+      CHECK(part.num_vertices() == 3);
+      CHECK(part.num_faces() == 1);
+      CHECK(part.position(vertex_handle(2)) == vector3f(0, 0, 0));
+    }
+
+    //a single shell is copied as a whole
+    auto sphere = create_geodesic_sphere<float>(1, 3);
+    auto copies = split_shells(sphere);
+    REQUIRE(copies.size() == 1);
+    CHECK(copies[0].check() == 0);
+    CHECK(copies[0].num_vertices() == sphere.num_vertices());
+    for(auto v : sphere.vertices())
+      CHECK(copies[0].position(v) == sphere.position(v));
+  }
+
+  TEST_CASE( "catmull clark subdivision", "[math]" )
+  {
+    using namespace owl::math;
+    auto box = create_box<float>();
+    box.store_prev(true);
+    auto m = box;
+    CHECK(m.subdivide_catmull_clark());
+    CHECK(m.num_vertices() == 26);
+    CHECK(m.num_edges() == 48);
+    CHECK(m.num_faces() == 24);
+    CHECK(m.is_quad_mesh());
+    CHECK(m.check() == 0);
+    //corners move to (f + 2 r) / 3 towards the center of the box
+    CHECK(approx(m.position(vertex_handle(0))) == vector3f(2.0f / 9, 2.0f / 9, 2.0f / 9));
+
+    auto twice = m;
+    CHECK(twice.subdivide_catmull_clark());
+    auto two_levels = box;
+    CHECK(two_levels.subdivide_catmull_clark(2));
+    CHECK(two_levels.num_faces() == 96);
+    CHECK(two_levels.check() == 0);
+    std::size_t num_different = 0;
+    for(auto v : twice.vertices())
+      if(twice.position(v) != two_levels.position(v))
+        ++num_different;
+    CHECK(num_different == 0);
+
+    mesh<float> quad;
+    auto verts = quad.add_vertices(std::vector<vector3f>{{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}});
+    quad.add_face(verts[0], verts[1], verts[2], verts[3]);
+    CHECK(quad.subdivide_catmull_clark());
+    CHECK(quad.num_vertices() == 9);
+    CHECK(quad.num_faces() == 4);
+    CHECK(quad.check() == 0);
+    CHECK(approx(quad.position(vertex_handle(0))) == vector3f(0.125f, 0.125f, 0));
+    CHECK(approx(quad.position(vertex_handle(8))) == vector3f(0.5f, 0.5f, 0));
+  }
+
+  TEST_CASE( "loop subdivision", "[math]" )
+  {
+    using namespace owl::math;
+    auto sphere = create_geodesic_sphere<float>(1, 2);
+    auto m = sphere;
+    CHECK(m.subdivide_loop(2));
+    CHECK(m.num_faces() == 16 * sphere.num_faces());
+    CHECK(m.num_vertices() == sphere.num_vertices() + sphere.num_edges() + 4 * sphere.num_edges());
+    CHECK(m.is_triangle_mesh());
+    CHECK(m.check() == 0);
+    std::size_t num_outside = 0;
+    for(auto v : m.vertices())
+      if(m.position(v).length() > 1 || m.position(v).length() < 0.9f)
+        ++num_outside;
+    CHECK(num_outside == 0);
+
+    mesh<float> triangle;
+    auto verts = triangle.add_vertices(std::vector<vector3f>{{0, 0, 0}, {1, 0, 0}, {0, 1, 0}});
+    triangle.add_face(verts[0], verts[1], verts[2]);
+    CHECK(triangle.subdivide_loop());
+    CHECK(triangle.num_vertices() == 6);
+    CHECK(triangle.num_faces() == 4);
+    CHECK(triangle.check() == 0);
+    CHECK(approx(triangle.position(vertex_handle(1))) == vector3f(0.75f, 0.125f, 0));
+    CHECK(approx(triangle.position(vertex_handle(3))) == vector3f(0.5f, 0, 0));
+  }
+
+  TEST_CASE( "stored prev", "[math]" )
+  {
+    using namespace owl::math;
+    auto check_prev = [](mesh<float>& m)
+    {
+      CHECK(m.check() == 0);
+      mesh<float> walk = m;
+      walk.store_prev(false);
+      for(auto he : m.halfedges())
+        CHECK(m.prev(he) == walk.prev(he));
+    };
+
+    auto box = create_box<float>();
+    box.store_prev();
+    CHECK(box.has_stored_prev());
+    triangulate_monoton(box);
+    check_prev(box);
+    box.subdivide_triangle_split();
+    check_prev(box);
+    box.flip_edge(edge_handle(5));
+    box.split(halfedge_handle(7), vector<float,3>(0, 1, 0));
+    check_prev(box);
+
+    auto cylinder = create_cylinder<float>(1, 2, 3, 7);
+    cylinder.store_prev();
+    triangulate_monoton(cylinder);
+    check_prev(cylinder);
+
+    //triangulating a large polygon calls prev on halfedges of a long face loop
+    std::size_t n = 4000;
+    mesh<float> polygon;
+    std::vector<vertex_handle> verts;
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      float angle = i * constants::two_pi<float> / n;
+      verts.push_back(polygon.add_vertex(vector<float,3>(std::cos(angle), 0, std::sin(angle) * (1 + 0.3f * (i % 2)))));
+    }
+    polygon.add_face(verts);
+
+    for(bool stored : {false, true})
+    {
+      mesh<float> m = polygon;
+      m.store_prev(stored);
+      CHECK(triangulate_monoton(m));
+      CHECK(m.has_stored_prev() == stored);
+      CHECK(m.num_faces() == n - 2);
+      CHECK(m.check() == 0);
+    }
+  }
+
+  TEST_CASE( "normals", "[math]" )
+  {
+    using namespace owl::math;
+    auto sphere = create_geodesic_sphere<float>(1, 4);
+    sphere.update_normals();
+    for(auto f : sphere.faces())
+      CHECK(approx(sphere.normal(f)).margin(0.0001) == sphere.compute_face_normal(f));
+    for(auto he : sphere.halfedges())
+      CHECK(approx(sphere.normal(he)).margin(0.01) == normalize(sphere.position(sphere.target(he))));
+
+    auto box = create_box<float>();
+    box.update_normals();
+    CHECK(box.normal(face_handle(0)).length() == approx(1));
+    for(auto f : box.faces())
+      CHECK(approx(box.normal(f)).margin(0.0001) == box.compute_face_normal(f));
+
+    //the corners of a triangulated box get the diagonal normal only if weighted by angle
+    triangulate_monoton(box);
+    auto area_normals = box.compute_vertex_normals(normal_weighting::area);
+    auto angle_normals = box.compute_vertex_normals(normal_weighting::angle);
+    std::size_t num_diagonal_area_normals = 0;
+    for(auto v : box.vertices())
+    {
+      auto diagonal = normalize(2 * box.position(v) - vector<float,3>(1, 1, 1));
+      CHECK(approx(angle_normals[v.index()]).margin(0.0001) == diagonal);
+      if(approx(area_normals[v.index()]).margin(0.0001) == diagonal)
+        ++num_diagonal_area_normals;
+    }
+    CHECK(num_diagonal_area_normals < box.num_vertices());
+
+    box.update_normals(degrees<float>(91), normal_weighting::angle);
+    for(auto he : box.halfedges())
+      CHECK(approx(box.normal(he)).margin(0.0001) == angle_normals[box.target(he).index()]);
+  }
+
   TEST_CASE( "add_face4", "[math]" )
   {
     using namespace owl::math;
@@ -0,0 +1,53 @@
+#include <cstdio>
+#include "owl/math/mesh_clustering.hpp"
+#include "owl/math/mesh_primitives.hpp"
+#include "owl/math/approx.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  TEST_CASE( "simplify ply", "[math]" )
+  {
+    using namespace owl::math;
+    auto sphere = create_geodesic_sphere<float>(1, 5);
+    mesh_write_options ascii;
+    ascii.binary = false;
+    for(auto [path, options] : {std::make_pair("simplify.ply", mesh_write_options{}),
+      std::make_pair("simplify_ascii.ply", ascii)})
+    {
+      REQUIRE(write_ply(sphere, path, options));
+
+      //cells smaller than the shortest edge keep every triangle
+      mesh<float> m;
+      CHECK(simplify_ply(m, path, 0.001f));
+      CHECK(m.check() == 0);
+      CHECK(m.num_vertices() == sphere.num_vertices());
+      CHECK(m.num_faces() == sphere.num_faces());
+
+      CHECK(simplify_ply(m, path, 0.25f));
+      CHECK(m.check() == 0);
+      CHECK(m.num_faces() > 20);
+      CHECK(m.num_faces() < sphere.num_faces() / 20);
+      for(auto v : m.vertices())
+        CHECK(m.position(v).length() == Approx(1).epsilon(0.1));
+      std::remove(path);
+    }
+
+    //cells 2^21 apart are distinct clusters
+    mesh<float> far;
+    float offset = float(1 << 21);
+    auto v = far.add_vertices(std::vector<vector<float,3>>{vector<float,3>(0.5f, 0.5f, 0.5f),
+      vector<float,3>(10.5f, 0.5f, 0.5f), vector<float,3>(0.5f, 10.5f, 0.5f), vector<float,3>(offset + 0.5f, 0.5f, 0.5f),
+      vector<float,3>(offset + 10.5f, 0.5f, 0.5f), vector<float,3>(offset + 0.5f, 10.5f, 0.5f)});
+    far.add_face(v[0], v[1], v[2]);
+    far.add_face(v[3], v[4], v[5]);
+    REQUIRE(write_ply(far, "simplify_far.ply"));
+    mesh<float> m;
+    CHECK(simplify_ply(m, "simplify_far.ply", 1.0f));
+    CHECK(m.num_vertices() == 6);
+    CHECK(m.num_faces() == 2);
+    std::remove("simplify_far.ply");
+
+    CHECK(!simplify_ply(m, "missing.ply", 0.1f));
+  }
+}
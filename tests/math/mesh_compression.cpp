@@ -0,0 +1,128 @@
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include "owl/io/range_coder.hpp"
+#include "owl/math/mesh_compression.hpp"
+#include "owl/math/mesh_io.hpp"
+#include "owl/math/mesh_primitives.hpp"
+#include "owl/math/mesh_triangulation.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  TEST_CASE( "range coder", "[io]" )
+  {
+    using namespace owl::io;
+    std::vector<std::uint8_t> bytes;
+    {
+      range_encoder out(bytes);
+      adaptive_model model(5);
+      for(std::size_t i = 0; i < 1000; ++i)
+      {
+        out.encode(i % 7 == 0 ? 4 : i % 2, model);
+        out.encode_bits(i * 2654435761u, 40);
+      }
+      out.finish();
+    }
+    //skewed symbols take less than a byte each together with their 40 bits
+    CHECK(bytes.size() < 1000 * 6);
+
+    range_decoder in(bytes.data(), bytes.data() + bytes.size());
+    adaptive_model model(5);
+    std::size_t num_wrong = 0;
+    for(std::size_t i = 0; i < 1000; ++i)
+    {
+      num_wrong += in.decode(model) != (i % 7 == 0 ? 4 : i % 2);
+      num_wrong += in.decode_bits(40) != ((i * 2654435761u) & ((std::uint64_t(1) << 40) - 1));
+    }
+    CHECK(num_wrong == 0);
+    CHECK_FALSE(in.overrun());
+    in.decode_bits(64);
+    CHECK(in.overrun());
+  }
+
+  TEST_CASE( "mesh compression", "[math]" )
+  {
+    using namespace owl::math;
+    auto round_trip = [](mesh<float> m, std::size_t bits)
+    {
+      std::vector<std::uint8_t> bytes;
+      REQUIRE(compress(m, bytes, bits));
+      mesh<float> result;
+      REQUIRE(decompress(result, bytes.data(), bytes.size()));
+      CHECK(result.check() == m.check());
+      CHECK(result.num_vertices() == m.num_vertices());
+      CHECK(result.num_edges() == m.num_edges());
+      CHECK(result.num_faces() == m.num_faces());
+      CHECK(num_shells(result) == num_shells(m));
+      CHECK(is_closed(result) == is_closed(m));
+
+      //vertices are reordered, each one has to lie within half a grid cell of an original one
+      auto extents = m.bounds().extents();
+      float tolerance = 0.5f * std::max({extents[0], extents[1], extents[2]}) / ((1 << bits) - 1) * 1.001f;
+      std::size_t num_far = 0;
+      for(auto v : result.vertices())
+      {
+        bool near = false;
+        for(auto w : m.vertices())
+        {
+          auto d = result.position(v) - m.position(w);
+          near = near || (std::abs(d[0]) <= tolerance && std::abs(d[1]) <= tolerance && std::abs(d[2]) <= tolerance);
+        }
+        num_far += !near;
+      }
+      CHECK(num_far == 0);
+      return bytes.size();
+    };
+
+    //closed, so the connectivity takes about two bits per triangle
+    auto sphere = create_geodesic_sphere<float>(1, 4);
+    CHECK(round_trip(sphere, 12) < 2 * sphere.num_faces());
+    CHECK(round_trip(sphere, 24) > round_trip(sphere, 8));
+
+    //genus one and open meshes
+    auto torus = create_torus<float>(0.25f, 1, 12, 24);
+    REQUIRE(triangulate_monoton(torus));
+    round_trip(torus, 16);
+    auto cylinder = create_cylinder<float>(1, 2, 3, 7);
+    REQUIRE(triangulate_monoton(cylinder));
+    round_trip(cylinder, 16);
+    round_trip(create_disk<float>(1, 9), 16);
+
+    //two components and an isolated vertex
+    mesh<float> m;
+    auto v = m.add_vertices(std::vector<vector<float,3>>{vector<float,3>(0, 0, 0), vector<float,3>(1, 0, 0),
+      vector<float,3>(0, 1, 0), vector<float,3>(-1, 0, 0), vector<float,3>(0, -1, 0), vector<float,3>(5, 5, 5),
+      vector<float,3>(-1, -1, 0)});
+    m.add_face(v[0], v[1], v[2]);
+    m.add_face(v[3], v[6], v[4]);
+    round_trip(m, 10);
+
+    //two fans meeting at a non-manifold vertex
+    mesh<float> bowtie;
+    v = bowtie.add_vertices(std::vector<vector<float,3>>{vector<float,3>(0, 0, 0), vector<float,3>(1, 0, 0),
+      vector<float,3>(1, 1, 0), vector<float,3>(-1, 0, 0), vector<float,3>(-1, -1, 0)});
+    bowtie.add_face(v[0], v[1], v[2]);
+    bowtie.add_face(v[0], v[3], v[4]);
+    REQUIRE(bowtie.check() == 0);
+    round_trip(bowtie, 10);
+
+    std::vector<std::uint8_t> bytes;
+    CHECK_FALSE(compress(create_box<float>(), bytes, 16));
+    CHECK_FALSE(compress(sphere, bytes, 31));
+
+    //truncated data is rejected and leaves the mesh unchanged
+    REQUIRE(compress(sphere, bytes, 16));
+    mesh<float> result = torus;
+    CHECK_FALSE(decompress(result, bytes.data(), bytes.size() / 2));
+    CHECK(result.num_faces() == torus.num_faces());
+
+    const std::string path = "compressed_sphere.owlc";
+    mesh_write_options options;
+    options.position_bits = 14;
+    REQUIRE(write(sphere, path, options));
+    REQUIRE(read(result, path));
+    CHECK(result.num_faces() == sphere.num_faces());
+    std::remove(path.c_str());
+  }
+}
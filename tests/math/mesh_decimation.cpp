@@ -0,0 +1,79 @@
+#include "owl/math/mesh_decimation.hpp"
+#include "owl/math/mesh_primitives.hpp"
+#include "owl/math/approx.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  TEST_CASE( "quadric", "[math]" )
+  {
+    using namespace owl::math;
+    using vec3 = vector<double, 3>;
+    auto q = quadric<double>::plane(vec3(1, 0, 0), -1)
+      + quadric<double>::plane(vec3(0, 1, 0), -2)
+      + quadric<double>::plane(vec3(0, 0, 1), -3, 2);
+    CHECK(q.error(vec3(1, 2, 3)) == Approx(0));
+    CHECK(q.error(vec3(0, 0, 0)) == Approx(1 + 4 + 2 * 9));
+
+    vec3 p;
+    CHECK(q.minimizer(p));
+    CHECK(p[0] == Approx(1));
+    CHECK(p[1] == Approx(2));
+    CHECK(p[2] == Approx(3));
+
+    //planes sharing a common line have no unique minimizer
+    auto q2 = quadric<double>::plane(vec3(1, 0, 0), -1) + quadric<double>::plane(vec3(0, 1, 0), -2);
+    CHECK(!q2.minimizer(p));
+  }
+
+  TEST_CASE( "collapse edge", "[math]" )
+  {
+    using namespace owl::math;
+    auto tetrahedron = create_tetradedron<float>();
+    for(auto he : tetrahedron.halfedges())
+      CHECK(!tetrahedron.is_collapsable(he));
+
+    auto m = create_icosaeder<float>();
+    auto he = m.halfedge(edge_handle(0));
+    auto v = m.target(he);
+    REQUIRE(m.is_collapsable(he));
+    m.collapse(he);
+    CHECK(m.status(m.edge(he)).is_removed());
+    CHECK(!m.status(v).is_removed());
+    CHECK(m.valence(v) == 6);
+    m.garbage_collection();
+    CHECK(m.check() == 0);
+    CHECK(m.num_vertices() == 11);
+    CHECK(m.num_edges() == 27);
+    CHECK(m.num_faces() == 18);
+
+    //collapsing a rim edge of a disk of three triangles would make the edge to the third rim vertex non manifold
+    auto disk = create_disk<float>(1, 3);
+    for(auto e : disk.edges())
+    {
+      auto he = disk.halfedge(e);
+      CHECK(disk.is_collapsable(he) != disk.is_boundary(e));
+    }
+  }
+
+  TEST_CASE( "decimate", "[math]" )
+  {
+    using namespace owl::math;
+    auto sphere = create_geodesic_sphere<float>(1, 4);
+    REQUIRE(decimate(sphere, 500));
+    CHECK(sphere.check() == 0);
+    CHECK(sphere.num_faces() <= 500);
+    CHECK(sphere.num_faces() >= 490);
+    CHECK(sphere.is_triangle_mesh());
+    for(auto v : sphere.vertices())
+      CHECK(sphere.position(v).length() == Approx(1).epsilon(0.05));
+
+    //the center of a disk is merged into the rim without error, the rim itself is preserved
+    auto disk = create_disk<float>(1, 16);
+    REQUIRE(decimate(disk, 0, 1e-6f));
+    CHECK(disk.check() == 0);
+    CHECK(disk.num_faces() == 14);
+    for(auto v : disk.vertices())
+      CHECK(disk.position(v).length() == Approx(1));
+  }
+}
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <array>
+#include <random>
+#include "owl/math/mesh_reordering.hpp"
+#include "owl/math/mesh_primitives.hpp"
+#include "owl/math/approx.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  namespace
+  {
+    //mean index distance of the two vertices of an edge
+    double mean_index_distance(const owl::math::mesh<float>& m)
+    {
+      double sum = 0;
+      for(auto he : m.halfedges())
+      {
+        std::size_t a = m.origin(he).index();
+        std::size_t b = m.target(he).index();
+        sum += static_cast<double>(a > b ? a - b : b - a);
+      }
+      return sum / m.num_halfedges();
+    }
+
+    float total_edge_length(const owl::math::mesh<float>& m)
+    {
+      float result = 0;
+      for(auto e : m.edges())
+        result += m.length(e);
+      return result;
+    }
+
+    void shuffle(owl::math::mesh<float>& m)
+    {
+      using namespace owl::math;
+      std::mt19937 rng(42);
+      std::vector<vertex_handle> vertices(m.vertices().begin(), m.vertices().end());
+      std::vector<edge_handle> edges(m.edges().begin(), m.edges().end());
+      std::vector<face_handle> faces(m.faces().begin(), m.faces().end());
+      std::shuffle(vertices.begin(), vertices.end(), rng);
+      std::shuffle(edges.begin(), edges.end(), rng);
+      std::shuffle(faces.begin(), faces.end(), rng);
+      m.permute(vertices, edges, faces);
+    }
+  }
+
+  TEST_CASE( "hilbert curve", "[math]" )
+  {
+    //the first 512 cells of the curve fill the 8x8x8 block at the origin, consecutive cells are adjacent
+    std::vector<std::pair<std::uint32_t, std::array<std::uint32_t, 3>>> cells;
+    for(std::uint32_t x = 0; x < 8; ++x)
+      for(std::uint32_t y = 0; y < 8; ++y)
+        for(std::uint32_t z = 0; z < 8; ++z)
+        {
+          std::uint32_t t[3] = {x, y, z};
+          owl::math::detail::hilbert_transpose(t);
+          std::uint32_t code = owl::math::expand_bits(t[0]) << 2 | owl::math::expand_bits(t[1]) << 1
+            | owl::math::expand_bits(t[2]);
+          cells.push_back({code, {x, y, z}});
+        }
+    std::sort(cells.begin(), cells.end());
+    std::size_t num_wrong_codes = 0;
+    std::size_t num_jumps = 0;
+    for(std::size_t i = 0; i < cells.size(); ++i)
+    {
+      if(cells[i].first != i)
+        ++num_wrong_codes;
+      if(i > 0)
+      {
+        std::uint32_t dist = 0;
+        for(std::size_t j = 0; j < 3; ++j)
+          dist += std::max(cells[i].second[j], cells[i - 1].second[j]) - std::min(cells[i].second[j], cells[i - 1].second[j]);
+        if(dist != 1)
+          ++num_jumps;
+      }
+    }
+    CHECK(num_wrong_codes == 0);
+    CHECK(num_jumps == 0);
+  }
+
+  TEST_CASE( "reorder mesh", "[math]" )
+  {
+    using namespace owl::math;
+    auto sphere = create_geodesic_sphere<float>(1, 3);
+    auto shuffled = sphere;
+    shuffle(shuffled);
+    CHECK(shuffled.check() == 0);
+    CHECK(total_edge_length(shuffled) == Approx(total_edge_length(sphere)));
+
+    for(auto ordering : {vertex_ordering::morton, vertex_ordering::hilbert, vertex_ordering::reverse_cuthill_mckee})
+    {
+      auto order = vertex_order(shuffled, ordering);
+      std::vector<bool> listed(shuffled.num_vertices(), false);
+      for(auto v : order)
+        listed[v.index()] = true;
+      CHECK(order.size() == shuffled.num_vertices());
+      CHECK(std::count(listed.begin(), listed.end(), false) == 0);
+
+      auto m = shuffled;
+      reorder(m, ordering);
+      CHECK(m.check() == 0);
+      CHECK(m.num_vertices() == sphere.num_vertices());
+      CHECK(m.num_faces() == sphere.num_faces());
+      CHECK(total_edge_length(m) == Approx(total_edge_length(sphere)));
+      CHECK(mean_index_distance(m) < mean_index_distance(shuffled) / 4);
+    }
+  }
+}
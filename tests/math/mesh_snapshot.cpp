@@ -0,0 +1,136 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "owl/math/mesh_io.hpp"
+#include "owl/math/mesh_primitives.hpp"
+#include "owl/math/mesh_snapshot.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  namespace
+  {
+    //an element type which the snapshot only knows by its size
+    struct sample
+    {
+      float weight;
+      std::int32_t id;
+    };
+  }
+
+  TEST_CASE( "mesh snapshot", "[math]" )
+  {
+    using namespace owl::math;
+    const std::string path = "snapshot_sphere.owlm";
+    auto sphere = create_geodesic_sphere<float>(1, 3);
+    sphere.store_prev();
+    face_property_handle<std::size_t> shell_ids;
+    label_shells(sphere, shell_ids);
+    vertex_property_handle<float> heights;
+    sphere.add_property(heights, "height");
+    //elements which can not be copied as raw bytes are not stored
+    vertex_property_handle<std::string> names;
+    sphere.add_property(names, "name");
+    for(auto v : sphere.vertices())
+      sphere.property(heights, v) = sphere.position(v)[2];
+    for(auto he : sphere.halfedges())
+      sphere.texcoord(he) = vector<float,2>(he.index(), 1);
+    sphere.color(face_handle(3)) = owl::color::rgba8u(1, 2, 3, 4);
+    REQUIRE(write(sphere, path));
+
+    mesh<float> m;
+    REQUIRE(read(m, path));
+    CHECK(m.check() == 0);
+    CHECK(m.has_stored_prev());
+    CHECK(m.num_vertices() == sphere.num_vertices());
+    CHECK(m.num_faces() == sphere.num_faces());
+    std::size_t num_differences = 0;
+    for(auto he : sphere.halfedges())
+      num_differences += m.target(he) != sphere.target(he) || m.next(he) != sphere.next(he)
+        || m.prev(he) != sphere.prev(he) || m.face(he) != sphere.face(he) || m.texcoord(he) != sphere.texcoord(he);
+    for(auto v : sphere.vertices())
+      num_differences += m.position(v) != sphere.position(v);
+    CHECK(num_differences == 0);
+    CHECK(m.color(face_handle(3)) == owl::color::rgba8u(1, 2, 3, 4));
+
+    face_property_handle<std::size_t> read_shell_ids;
+    REQUIRE(m.get_property(read_shell_ids, "face_shell"));
+    vertex_property_handle<float> read_heights;
+    REQUIRE(m.get_property(read_heights, "height"));
+    for(auto v : m.vertices())
+      num_differences += m.property(read_heights, v) != m.position(v)[2];
+    for(auto f : m.faces())
+      num_differences += m.property(read_shell_ids, f) != 0;
+    CHECK(num_differences == 0);
+    vertex_property_handle<std::string> read_names;
+    CHECK_FALSE(m.get_property(read_names, "name"));
+
+    std::string bytes;
+    {
+      std::ifstream in(path, std::ios::binary);
+      bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto write_bytes = [&](const std::string& contents)
+      {
+        std::ofstream out(path, std::ios::binary);
+        out.write(contents.data(), contents.size());
+      };
+
+    //element types are stored under fixed names which do not depend on the compiler
+    CHECK(bytes.find("halfedge_handle") != std::string::npos);
+    CHECK(bytes.find("vector2f") != std::string::npos);
+    CHECK(bytes.find("rgba8u") != std::string::npos);
+
+    //a truncated snapshot is rejected and leaves the mesh unchanged
+    write_bytes(bytes.substr(0, bytes.size() / 2));
+    CHECK_FALSE(read(m, path));
+    CHECK(m.num_faces() == sphere.num_faces());
+
+    //element counts which do not fit into the file are rejected before allocating anything
+    auto huge = bytes;
+    std::uint64_t num_vertices = std::uint64_t(1) << 60;
+    std::memcpy(&huge[24], &num_vertices, sizeof(num_vertices));
+    write_bytes(huge);
+    CHECK_FALSE(read(m, path));
+    CHECK(m.num_faces() == sphere.num_faces());
+    std::remove(path.c_str());
+  }
+
+  TEST_CASE( "mesh snapshot into existing properties", "[math]" )
+  {
+    using namespace owl::math;
+    const std::string path = "snapshot_box.owlm";
+    auto box = create_box<float>();
+    vertex_property_handle<sample> samples;
+    box.add_property(samples, "sample");
+    for(auto v : box.vertices())
+      box.property(samples, v) = sample{0.5f * v.index(), static_cast<std::int32_t>(v.index())};
+    REQUIRE(write(box, path));
+
+    //the property of the unknown type is restored in place, the handles of the mesh stay valid
+    //and properties which are not stored are reset
+    mesh<float> m;
+    vertex_property_handle<sample> read_samples;
+    m.add_property(read_samples, "sample");
+    face_property_handle<float> areas;
+    m.add_property(areas, "area");
+    REQUIRE(read(m, path));
+    REQUIRE(m.num_vertices() == box.num_vertices());
+    std::size_t num_differences = 0;
+    for(auto v : m.vertices())
+      num_differences += m.property(read_samples, v).weight != 0.5f * v.index()
+        || m.property(read_samples, v).id != static_cast<std::int32_t>(v.index())
+        || m.position(v) != box.position(v);
+    for(auto f : m.faces())
+      num_differences += m.property(areas, f) != 0;
+    CHECK(num_differences == 0);
+
+    //without a matching property it can not be restored
+    mesh<float> plain;
+    REQUIRE(read(plain, path));
+    vertex_property_handle<sample> missing;
+    CHECK_FALSE(plain.get_property(missing, "sample"));
+    std::remove(path.c_str());
+  }
+}
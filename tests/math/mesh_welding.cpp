@@ -0,0 +1,67 @@
+#include "owl/math/mesh_welding.hpp"
+#include "owl/math/mesh_primitives.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  TEST_CASE( "weld vertices", "[math]" )
+  {
+    using namespace owl::math;
+    using vec3 = vector<float, 3>;
+    //0.12 is merged with 0 through 0.05, 0.199 and 0.201 lie in different cells
+    std::vector<vec3> positions = {vec3(0, 0, 0), vec3(0.05f, 0, 0), vec3(1, 0, 0), vec3(0.12f, 0, 0),
+      vec3(-0.199f, 1, 1), vec3(-0.201f, 1, 1), vec3(1, 0, 0.2f)};
+    std::vector<std::size_t> remap;
+    auto welded = weld_vertices(positions, 0.1f, remap);
+    CHECK(remap == std::vector<std::size_t>({0, 0, 1, 0, 2, 2, 3}));
+    REQUIRE(welded.size() == 4);
+    CHECK(welded[0] == positions[0]);
+    CHECK(welded[2] == positions[4]);
+
+    //without epsilon only equal positions are merged
+    positions = {vec3(0, 0, 0), vec3(1e-6f, 0, 0), vec3(-0.0f, 0, 0), vec3(1e-6f, 0, 0)};
+    welded = weld_vertices(positions, 0.0f, remap);
+    CHECK(remap == std::vector<std::size_t>({0, 1, 0, 1}));
+    CHECK(welded.size() == 2);
+  }
+
+  TEST_CASE( "weld soup", "[math]" )
+  {
+    using namespace owl::math;
+    using vec3 = vector<float, 3>;
+    auto sphere = create_geodesic_sphere<float>(1, 3);
+
+    //every face gets its own slightly perturbed corners as read from an stl file
+    std::vector<vec3> positions;
+    std::vector<std::size_t> face_offsets(1, 0);
+    std::vector<std::size_t> face_indices;
+    for(auto f : sphere.faces())
+    {
+      for(auto v : sphere.vertices(f))
+      {
+        face_indices.push_back(positions.size());
+        positions.push_back(sphere.position(v) + vec3(1e-6f * (positions.size() % 3), 0, 0));
+      }
+      face_offsets.push_back(face_indices.size());
+    }
+
+    mesh<float> soup;
+    REQUIRE(soup.build(positions, face_offsets, face_indices));
+    CHECK(soup.num_vertices() == positions.size());
+    CHECK(!is_closed(soup));
+
+    //a sliver collapsing to an edge is removed
+    face_indices.insert(face_indices.end(), {0, 1, positions.size()});
+    positions.push_back(positions[1] + vec3(0, 1e-6f, 0));
+    face_offsets.push_back(face_indices.size());
+
+    weld_soup(positions, face_offsets, face_indices, 1e-4f);
+    CHECK(positions.size() == sphere.num_vertices());
+    CHECK(face_offsets.size() == sphere.num_faces() + 1);
+    mesh<float> welded;
+    REQUIRE(welded.build(positions, face_offsets, face_indices));
+    CHECK(welded.check() == 0);
+    CHECK(welded.num_edges() == sphere.num_edges());
+    CHECK(is_closed(welded));
+  }
+}
@@ -11,4 +11,26 @@ namespace test
     ray3f r1(vector3f(0,0,0),vector3f(1,1,1));
     CHECK(r1(2) == vector3f(2,2,2));
   }
+
+  TEST_CASE( "ray intersection", "[math]" )
+  {
+    using namespace owl::math;
+
+    ray3f r(vector3f(0.25f, 0.25f, -1), vector3f(0, 0, 1));
+    float t_min = 0, t_max = 10;
+    CHECK(intersect(r, box<float>(vector3f(0, 0, 0), vector3f(1, 1, 1)), t_min, t_max));
+    CHECK(t_min == approx(1.0f));
+    CHECK(t_max == approx(2.0f));
+    t_min = 0;
+    t_max = 10;
+    CHECK_FALSE(intersect(r, box<float>(vector3f(1, 0, 0), vector3f(2, 1, 1)), t_min, t_max));
+
+    float t, u, v;
+    CHECK(intersect(r, vector3f(0, 0, 1), vector3f(1, 0, 1), vector3f(0, 1, 1), 0.0f, 10.0f, t, u, v));
+    CHECK(t == approx(2.0f));
+    CHECK(u == approx(0.25f));
+    CHECK(v == approx(0.25f));
+    CHECK_FALSE(intersect(r, vector3f(0, 0, 1), vector3f(1, 0, 1), vector3f(0, 1, 1), 0.0f, 1.5f, t, u, v));
+    CHECK_FALSE(intersect(r, vector3f(1, 0, 1), vector3f(1, 1, 1), vector3f(0, 1, 1), 0.0f, 10.0f, t, u, v));
+  }
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "owl/utils/mutable_priority_queue.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  TEST_CASE( "mutable_priority_queue", "[utils]" )
+  {
+    using namespace owl::utils;
+    mutable_priority_queue<float> queue(5);
+    CHECK(queue.empty());
+    queue.push(3, 2.0f);
+    queue.push(1, 1.0f);
+    queue.push(4, 3.0f);
+    CHECK(queue.size() == 3);
+    CHECK(queue.top() == 1);
+    CHECK(queue.contains(4));
+    CHECK_FALSE(queue.contains(0));
+
+    queue.push(4, 0.5f);
+    CHECK(queue.top() == 4);
+    queue.push(4, 5.0f);
+    CHECK(queue.top() == 1);
+    CHECK(queue.priority(4) == 5.0f);
+
+    queue.remove(1);
+    CHECK_FALSE(queue.contains(1));
+    CHECK(queue.top() == 3);
+    queue.pop();
+    CHECK(queue.top() == 4);
+    CHECK(queue.top_priority() == 5.0f);
+    queue.pop();
+    CHECK(queue.empty());
+  }
+
+  TEST_CASE( "mutable_priority_queue random", "[utils]" )
+  {
+    using namespace owl::utils;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> dist(0, 1);
+    const std::size_t n = 1000;
+    std::vector<double> priorities(n);
+    std::vector<mutable_priority_queue<double>::entry> entries;
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      priorities[i] = dist(rng);
+      entries.push_back({priorities[i], i});
+    }
+    mutable_priority_queue<double> queue;
+    queue.assign(n, entries);
+
+    //change and remove random entries, the queue has to pop the remaining ones in order
+    std::vector<bool> removed(n, false);
+    for(std::size_t k = 0; k < 500; ++k)
+    {
+      std::size_t i = rng() % n;
+      if(k % 5 == 0)
+      {
+        queue.remove(i);
+        removed[i] = true;
+      }
+      else if(!removed[i])
+      {
+        priorities[i] = dist(rng);
+        queue.push(i, priorities[i]);
+      }
+    }
+
+    std::vector<double> expected;
+    for(std::size_t i = 0; i < n; ++i)
+      if(!removed[i])
+        expected.push_back(priorities[i]);
+    std::sort(expected.begin(), expected.end());
+    std::vector<double> popped;
+    while(!queue.empty())
+    {
+      popped.push_back(queue.top_priority());
+      queue.pop();
+    }
+    CHECK(popped == expected);
+  }
+}
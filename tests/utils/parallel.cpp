@@ -0,0 +1,100 @@
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "owl/utils/count_iterator.hpp"
+#include "owl/utils/parallel.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  TEST_CASE( "parallel_for", "[utils]" )
+  {
+    using namespace owl::utils;
+
+    std::vector<int> visits(1000, 0);
+    parallel_for(std::size_t(0), visits.size(), [&visits](std::size_t i){ ++visits[i]; });
+    CHECK(std::all_of(visits.begin(), visits.end(), [](int n){ return n == 1; }));
+
+    std::atomic<int> sum(0);
+    parallel_for(-5, 5, [&sum](int i){ sum += i; });
+    CHECK(sum == -5);
+
+    parallel_for(3, 3, [](int){ FAIL(); });
+  }
+
+  TEST_CASE( "parallel_for_blocks", "[utils]" )
+  {
+    using namespace owl::utils;
+
+    //catch assertions are not thread safe, so the blocks only record what is checked afterwards
+    std::vector<int> visits(1000, 0);
+    std::atomic<std::size_t> n_short_blocks(0);
+    parallel_for_blocks(std::size_t(0), visits.size(), 64, [&](std::size_t first, std::size_t last)
+      {
+        if(last - first < 64)
+          ++n_short_blocks;
+        for(std::size_t i = first; i < last; ++i)
+          ++visits[i];
+      });
+    CHECK(n_short_blocks == 0);
+    CHECK(std::all_of(visits.begin(), visits.end(), [](int n){ return n == 1; }));
+
+    int n_blocks = 0;
+    parallel_for_blocks(0, 10, 64, [&n_blocks](int first, int last)
+      {
+        CHECK(first == 0);
+        CHECK(last == 10);
+        ++n_blocks;
+      });
+    CHECK(n_blocks == 1);
+  }
+
+  TEST_CASE( "parallel_for range", "[utils]" )
+  {
+    using namespace owl::utils;
+
+    std::vector<int> visits(1000, 0);
+    parallel_for(make_counting_range(std::size_t(0), visits.size()), [&visits](std::size_t i){ ++visits[i]; });
+    CHECK(std::all_of(visits.begin(), visits.end(), [](int n){ return n == 1; }));
+
+    parallel_for(visits, [](int& n){ n *= 2; });
+    CHECK(std::all_of(visits.begin(), visits.end(), [](int n){ return n == 2; }));
+
+    std::atomic<int> n_visits(0);
+    std::atomic<std::size_t> n_short_blocks(0);
+    parallel_for_blocks(make_counting_range(0, 1000), 64, [&](auto block)
+      {
+        if(block.size() < 64)
+          ++n_short_blocks;
+        for(int i : block)
+          n_visits += i;
+      });
+    CHECK(n_short_blocks == 0);
+    CHECK(n_visits == 999 * 1000 / 2);
+
+    //nested loops are executed by the same workers
+    std::atomic<int> n_inner(0);
+    parallel_for(0, 100, [&n_inner](int)
+      {
+        parallel_for(0, 100, [&n_inner](int){ ++n_inner; });
+      });
+    CHECK(n_inner == 10000);
+  }
+
+  TEST_CASE( "parallel_reduce", "[utils]" )
+  {
+    using namespace owl::utils;
+
+    CHECK(parallel_reduce(0, 100000, std::int64_t(0), [](int i){ return std::int64_t(i); }, std::plus<>()) == 4999950000);
+    CHECK(parallel_reduce(3, 3, 7, [](int){ FAIL(); return 0; }, std::plus<>()) == 7);
+
+    std::vector<float> values(100000);
+    for(std::size_t i = 0; i < values.size(); ++i)
+      values[i] = 1.0f / (1 + i);
+    float sum = parallel_reduce(values, 0.0f, [](float x){ return x; }, std::plus<>());
+    CHECK(sum == parallel_reduce(values, 0.0f, [](float x){ return x; }, std::plus<>()));
+
+    auto max = [](int a, int b){ return std::max(a, b); };
+    CHECK(parallel_reduce(make_counting_range(0, 5000), -1, [](int i){ return (i * 7919) % 5000; }, max) == 4999);
+  }
+}
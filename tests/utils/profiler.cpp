@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include "owl/utils/profiler.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  TEST_CASE( "profiler", "[utils]" )
+  {
+    using namespace owl::utils;
+
+    auto& p = profiler::instance();
+    p.clear();
+    {
+      profile_zone outer("outer");
+      for(int i = 0; i < 10; ++i)
+        profile_zone inner("inner");
+    }
+    std::thread([]{ profile_zone zone("worker"); }).join();
+
+    auto events = p.events();
+    auto count = [&events](const std::string& name)
+      {
+        return std::count_if(events.begin(), events.end(), [&name](const auto& e){ return e.name == name; });
+      };
+    CHECK(count("outer") == 1);
+    CHECK(count("inner") == 10);
+    CHECK(count("worker") == 1);
+
+    auto outer = *std::find_if(events.begin(), events.end(), [](const auto& e){ return e.name == std::string("outer"); });
+    for(const auto& e : events)
+    {
+      if(e.name != std::string("inner"))
+        continue;
+      CHECK(e.depth == outer.depth + 1);
+      CHECK(e.thread == outer.thread);
+      CHECK(e.start >= outer.start);
+      CHECK(e.start + e.duration <= outer.start + outer.duration);
+    }
+
+    auto stats = p.statistics();
+    auto inner = std::find_if(stats.begin(), stats.end(), [](const auto& s){ return s.name == "inner"; });
+    REQUIRE(inner != stats.end());
+    CHECK(inner->count == 10);
+    CHECK(inner->min <= inner->median);
+    CHECK(inner->median <= inner->p90);
+    CHECK(inner->p99 <= inner->max);
+
+    std::stringstream trace;
+    p.write_chrome_trace(trace);
+    CHECK(trace.str().find("\"traceEvents\"") != std::string::npos);
+    CHECK(trace.str().find("\"name\": \"worker\"") != std::string::npos);
+
+    p.clear();
+    CHECK(p.events().empty());
+    CHECK(p.num_dropped_events() == 0);
+  }
+}
@@ -0,0 +1,62 @@
+#include <thread>
+#include <vector>
+#include "owl/utils/progress.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  TEST_CASE( "progress", "[utils]" )
+  {
+    using namespace owl::utils;
+
+    progress p(10);
+    CHECK(p.fraction() == 0);
+    CHECK(p.step(4));
+    CHECK(p.completed_steps() == 4);
+    CHECK(p.fraction() == 0.4);
+    CHECK(progress::current() == nullptr);
+
+    //a child created while the parent is current accounts for the pending steps
+    p.make_current(4);
+    CHECK(progress::current() == &p);
+    {
+      progress child(100);
+      progress grand_child(1);
+      CHECK(child.step(50));
+      CHECK(p.completed_steps() == 6);
+    }
+    CHECK(p.completed_steps() == 8);
+    p.resign_current();
+    CHECK(progress::current() == nullptr);
+
+    //pending steps without child are completed on resign
+    p.make_current(2);
+    p.resign_current();
+    CHECK(p.completed_steps() == 10);
+    CHECK(p.fraction() == 1);
+
+    //concurrent steps
+    progress shared(4000);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t)
+      threads.emplace_back([&shared]
+        {
+          for(int i = 0; i < 1000; ++i)
+            shared.step();
+        });
+    for(auto& t : threads)
+      t.join();
+    CHECK(shared.completed_steps() == 4000);
+
+    //cancellation reaches the children
+    progress job(1);
+    job.make_current(1);
+    progress task(10);
+    CHECK_FALSE(task.is_cancelled());
+    job.cancel();
+    CHECK(job.is_cancelled());
+    CHECK(task.is_cancelled());
+    CHECK_FALSE(task.step());
+    job.resign_current();
+  }
+}
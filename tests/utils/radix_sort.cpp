@@ -0,0 +1,40 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "owl/utils/radix_sort.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  TEST_CASE( "radix_sort", "[utils]" )
+  {
+    using namespace owl::utils;
+
+    std::mt19937 rng(7);
+    std::vector<std::uint32_t> keys(200000);
+    for(auto& key : keys)
+      key = rng() % 1000 + (rng() % 2 == 0 ? 0 : 0xff000000);
+    std::vector<std::size_t> values(keys.size());
+    for(std::size_t i = 0; i < values.size(); ++i)
+      values[i] = i;
+
+    auto expected = keys;
+    std::sort(expected.begin(), expected.end());
+    auto original = keys;
+    radix_sort(keys, values);
+    CHECK(keys == expected);
+    bool stable = true;
+    for(std::size_t i = 0; i < keys.size(); ++i)
+    {
+      stable &= original[values[i]] == keys[i];
+      if(i > 0 && keys[i] == keys[i - 1])
+        stable &= values[i - 1] < values[i];
+    }
+    CHECK(stable);
+
+    std::vector<std::uint32_t> empty_keys;
+    std::vector<int> empty_values;
+    radix_sort(empty_keys, empty_values);
+    CHECK(empty_keys.empty());
+  }
+}
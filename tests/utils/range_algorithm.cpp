@@ -0,0 +1,67 @@
+#include <list>
+#include <numeric>
+#include <vector>
+#include "owl/utils/count_iterator.hpp"
+#include "owl/utils/map_iterator.hpp"
+#include "owl/utils/range_algorithm.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  TEST_CASE( "range_algorithm execution policies", "[utils]" )
+  {
+    using namespace owl::utils;
+
+    std::vector<int> numbers(10000);
+    std::iota(numbers.begin(), numbers.end(), 0);
+    auto is_odd = [](int i){ return i % 2 == 1; };
+    auto sqr = [](int i){ return i * i; };
+
+    for(auto range_name : {"vector", "counting", "mapped"})
+    {
+      SECTION(range_name)
+      {
+        auto counting = make_counting_range(0, 10000);
+        auto mapped = map_range([](int i){ return i; }, counting);
+        auto check = [&](const auto& rng)
+          {
+            CHECK(count_if(execution::par, rng, is_odd) == 5000);
+            CHECK(count_if(execution::seq, rng, is_odd) == 5000);
+            CHECK(*find_if(execution::par, rng, [](int i){ return i > 1234 && i % 100 == 0; }) == 1300);
+            CHECK(find_if(execution::par, rng, [](int i){ return i < 0; }) == std::end(rng));
+            CHECK(all_of(execution::par, rng, [](int i){ return i >= 0; }));
+            CHECK_FALSE(all_of(execution::par, rng, [](int i){ return i < 9999; }));
+            CHECK(any_of(execution::par, rng, [](int i){ return i == 9999; }));
+            CHECK(none_of(execution::par, rng, [](int i){ return i == 10000; }));
+
+            std::vector<int> squares(10000, -1);
+            CHECK(transform(execution::par, rng, squares.begin(), sqr) == squares.end());
+            CHECK(squares[0] == 0);
+            CHECK(squares[77] == 77 * 77);
+            CHECK(squares[9999] == 9999 * 9999);
+          };
+        if(range_name == std::string("vector"))
+          check(numbers);
+        else if(range_name == std::string("counting"))
+          check(counting);
+        else
+          check(mapped);
+      }
+    }
+
+    std::vector<int> values(10000, 0);
+    fill(execution::par, values, 3);
+    CHECK(std::all_of(values.begin(), values.end(), [](int v){ return v == 3; }));
+    for_each(execution::par, values, [](int& v){ v *= 2; });
+    CHECK(std::all_of(values.begin(), values.end(), [](int v){ return v == 6; }));
+
+    //ranges without random access iterators run sequentially
+    std::list<int> list(numbers.begin(), numbers.end());
+    CHECK(count_if(execution::par, list, is_odd) == 5000);
+    CHECK(*find_if(execution::par, list, [](int i){ return i > 1234; }) == 1235);
+    fill(execution::par, list, 1);
+    CHECK(std::accumulate(list.begin(), list.end(), 0) == 10000);
+    transform(execution::par, numbers, std::back_inserter(list), sqr);
+    CHECK(list.back() == 9999 * 9999);
+  }
+}
@@ -0,0 +1,51 @@
+#include <atomic>
+#include <vector>
+#include "owl/utils/task_scheduler.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  TEST_CASE( "task_scheduler", "[utils]" )
+  {
+    using namespace owl::utils;
+
+    //without workers tasks only run when the waiting thread executes them
+    task_scheduler single(0);
+    CHECK(single.num_threads() == 1);
+    int n = 0;
+    single.submit([&n]{ ++n; });
+    single.submit([&n]{ n *= 10; });
+    CHECK(n == 0);
+    CHECK(single.run_pending_task());
+    CHECK(single.run_pending_task());
+    CHECK_FALSE(single.run_pending_task());
+    CHECK(n == 10);
+
+    task_scheduler scheduler(3);
+    CHECK(scheduler.num_threads() == 4);
+    std::vector<int> visits(1000, 0);
+    {
+      task_group group(scheduler);
+      for(std::size_t i = 0; i < 10; ++i)
+      {
+        group.run([&scheduler, &visits, i]
+          {
+            task_group inner(scheduler);
+            for(std::size_t j = 0; j < 100; ++j)
+              inner.run([&visits, i, j]{ ++visits[i * 100 + j]; });
+            inner.wait();
+          });
+      }
+      group.wait();
+    }
+    CHECK(std::all_of(visits.begin(), visits.end(), [](int v){ return v == 1; }));
+
+    std::atomic<int> n_finished(0);
+    {
+      task_scheduler temporary(2);
+      for(int i = 0; i < 100; ++i)
+        temporary.submit([&n_finished]{ ++n_finished; });
+    }
+    CHECK(n_finished == 100);
+  }
+}
@@ -0,0 +1,50 @@
+#include <atomic>
+#include <vector>
+#include "owl/utils/parallel.hpp"
+#include "owl/utils/union_find.hpp"
+#include "catch/catch.hpp"
+
+namespace test
+{
+  TEST_CASE( "union_find", "[utils]" )
+  {
+    using namespace owl::utils;
+    concurrent_union_find sets(6);
+    CHECK(sets.size() == 6);
+    CHECK(sets.find(4) == 4);
+    CHECK(sets.unite(4, 2));
+    CHECK(sets.unite(5, 4));
+    CHECK_FALSE(sets.unite(2, 5));
+    CHECK(sets.unite(1, 3));
+    CHECK(sets.same(5, 2));
+    CHECK_FALSE(sets.same(1, 2));
+    //the root is the smallest element of each set
+    CHECK(sets.find(5) == 2);
+    CHECK(sets.find(3) == 1);
+    CHECK(sets.find(0) == 0);
+  }
+
+  TEST_CASE( "concurrent union_find", "[utils]" )
+  {
+    using namespace owl::utils;
+    //chains of the elements with the same residue modulo 7, united in parallel in arbitrary order
+    std::size_t n = 100000;
+    concurrent_union_find sets(n);
+    std::atomic<std::size_t> num_merged(0);
+    parallel_for(std::size_t(7), n, [&](std::size_t i)
+      {
+        std::size_t j = (i * 7919) % (n - 7) + 7;
+        if(sets.unite(j, j - 7))
+          ++num_merged;
+      });
+    CHECK(num_merged == n - 7);
+
+    std::vector<std::size_t> roots(n);
+    parallel_for(std::size_t(0), n, [&](std::size_t i){ roots[i] = sets.find(i); });
+    std::size_t num_wrong_roots = 0;
+    for(std::size_t i = 0; i < n; ++i)
+      if(roots[i] != i % 7)
+        ++num_wrong_roots;
+    CHECK(num_wrong_roots == 0);
+  }
+}